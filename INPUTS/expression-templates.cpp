@@ -0,0 +1,66 @@
+// Hammer overload resolution with expression templates: the same overloaded
+// operators are applied to the same operand types over and over, with many
+// candidate operators in scope. Compare
+//   clang -cc1 -fsyntax-only -print-stats expression-templates.cpp
+// with and without -fno-overload-resolution-cache.
+
+namespace et {
+
+template <typename E> struct Expr {
+  const E &self() const { return static_cast<const E &>(*this); }
+};
+
+struct Vec : Expr<Vec> {
+  double Data[4];
+  double operator[](int I) const { return Data[I]; }
+  template <typename E> Vec &operator=(const Expr<E> &X) {
+    for (int I = 0; I != 4; ++I)
+      Data[I] = X.self()[I];
+    return *this;
+  }
+};
+
+#define BINARY_NODE(Name, Op)                                                  \
+  template <typename L, typename R> struct Name : Expr<Name<L, R> > {          \
+    const L &Lhs;                                                              \
+    const R &Rhs;                                                              \
+    Name(const L &Lhs, const R &Rhs) : Lhs(Lhs), Rhs(Rhs) {}                   \
+    double operator[](int I) const { return Lhs[I] Op Rhs[I]; }                \
+  };                                                                           \
+  template <typename L, typename R>                                            \
+  Name<L, R> operator Op(const Expr<L> &Lhs, const Expr<R> &Rhs) {             \
+    return Name<L, R>(Lhs.self(), Rhs.self());                                 \
+  }
+BINARY_NODE(Sum, +)
+BINARY_NODE(Difference, -)
+BINARY_NODE(Product, *)
+BINARY_NODE(Quotient, /)
+
+// Unrelated overloads of the same operators, which every resolution has to
+// consider and reject.
+#define DISTRACTORS(N)                                                         \
+  struct Other##N {};                                                          \
+  Other##N operator+(Other##N, Other##N);                                      \
+  Other##N operator-(Other##N, Other##N);                                      \
+  Other##N operator*(Other##N, double);                                        \
+  Other##N operator*(double, Other##N);                                        \
+  Other##N operator/(Other##N, double);                                        \
+  template <typename T> Other##N operator+(Other##N, const T &);               \
+  template <typename T> Other##N operator*(const T &, Other##N);
+DISTRACTORS(0) DISTRACTORS(1) DISTRACTORS(2) DISTRACTORS(3)
+DISTRACTORS(4) DISTRACTORS(5) DISTRACTORS(6) DISTRACTORS(7)
+
+} // end namespace et
+
+using namespace et;
+
+#define STMT1 R = A + B * C - D / E + (A - B) * (C + D);
+#define STMT4 STMT1 STMT1 STMT1 STMT1
+#define STMT16 STMT4 STMT4 STMT4 STMT4
+#define STMT64 STMT16 STMT16 STMT16 STMT16
+#define STMT256 STMT64 STMT64 STMT64 STMT64
+
+void kernel(Vec &R, const Vec &A, const Vec &B, const Vec &C, const Vec &D,
+            const Vec &E) {
+  STMT256 STMT256 STMT256 STMT256
+}
@@ -32,7 +32,7 @@
  * compatible, thus CINDEX_VERSION_MAJOR is expected to remain stable.
  */
 #define CINDEX_VERSION_MAJOR 0
-#define CINDEX_VERSION_MINOR 30
+#define CINDEX_VERSION_MINOR 31
 
 #define CINDEX_VERSION_ENCODE(major, minor) ( \
       ((major) * 10000)                       \
@@ -1391,7 +1391,19 @@ enum CXReparse_Flags {
   /**
    * \brief Used to indicate that no special reparsing options are needed.
    */
-  CXReparse_None = 0x0
+  CXReparse_None = 0x0,
+
+  /**
+   * \brief Used to indicate that the top-level declarations of the main file
+   * that precede the first change should not be parsed again.
+   *
+   * When the translation unit uses a precompiled preamble, the preamble is
+   * extended past the preprocessor directives at the start of the main file
+   * over those declarations, and only the rest of the main file is parsed.
+   * The preamble is only rebuilt when an edit precedes its end, or when
+   * extending it saves a significant part of each reparse.
+   */
+  CXReparse_ReuseUnchangedDecls = 0x01
 };
  
 /**
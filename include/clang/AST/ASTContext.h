@@ -51,6 +51,9 @@ namespace clang {
   class ASTRecordLayout;
   class BlockExpr;
   class CharUnits;
+  class ConstexprCallCache;
+  class ConstexprProfile;
+  class CostReport;
   class DiagnosticsEngine;
   class Expr;
   class ASTMutationListener;
@@ -878,9 +881,49 @@ public:
   /// with this AST context, if any.
   ASTMutationListener *getASTMutationListener() const { return Listener; }
 
+  /// \brief Set the report that template instantiations and constexpr
+  /// function calls are charged to, or null to stop reporting.
+  void setCostReport(CostReport *Report) { Costs = Report; }
+
+  /// \brief Retrieve the cost report associated with this AST context, if
+  /// any.
+  CostReport *getCostReport() const { return Costs; }
+
+  /// \brief Retrieve the memoized results of constexpr function calls.
+  ConstexprCallCache &getConstexprCallCache() const;
+
+  /// \brief Set the profile that constant evaluation steps are charged to,
+  /// or null to stop profiling.
+  void setConstexprProfile(ConstexprProfile *Profile) {
+    ConstexprProf = Profile;
+  }
+
+  /// \brief Retrieve the constexpr evaluation profile associated with this
+  /// AST context, if any.
+  ConstexprProfile *getConstexprProfile() const { return ConstexprProf; }
+
   void PrintStats() const;
   const SmallVectorImpl<Type *>& getTypes() const { return Types; }
 
+  /// \brief Retrieve the number of declarations created in this context,
+  /// including those deserialized from an AST file.
+  unsigned getNumDeclsCreated() const { return NumDeclsCreated; }
+
+  /// \brief Retrieve the number of declarations deserialized from an AST
+  /// file into this context.
+  unsigned getNumDeclsDeserialized() const { return NumDeclsDeserialized; }
+
+  /// \brief Retrieve the number of class, struct and union definitions
+  /// completed in this context so far, not counting instantiations of
+  /// templates.
+  unsigned getNumRecordDefinitionsCompleted() const {
+    return NumRecordDefinitionsCompleted;
+  }
+
+  /// \brief Retrieve the number of times a declaration was added to or
+  /// removed from a namespace or the translation unit in this context.
+  unsigned getNumFileContextChanges() const { return NumFileContextChanges; }
+
   /// \brief Create a new implicit TU-level CXXRecordDecl or RecordDecl
   /// declaration.
   RecordDecl *buildImplicitRecord(StringRef Name,
@@ -2438,7 +2481,32 @@ private:
   // but we include it here so that ASTContext can quickly deallocate them.
   llvm::PointerIntPair<StoredDeclsMap*,1> LastSDM;
 
+  /// \brief The number of declarations allocated in this context, and how
+  /// many of them were deserialized from an AST file.
+  mutable unsigned NumDeclsCreated, NumDeclsDeserialized;
+
+  /// \brief The number of record definitions completed in this context,
+  /// other than template instantiations.
+  mutable unsigned NumRecordDefinitionsCompleted;
+
+  /// \brief The number of changes to the declarations of namespaces and the
+  /// translation unit.
+  mutable unsigned NumFileContextChanges;
+
+  /// \brief The report template instantiations and constexpr calls are
+  /// charged to, if any.
+  CostReport *Costs;
+
+  /// \brief The memoized results of constexpr function calls, created the
+  /// first time constant evaluation calls a function.
+  mutable std::unique_ptr<ConstexprCallCache> ConstexprCalls;
+
+  /// \brief The profile constant evaluation steps are charged to, if any.
+  ConstexprProfile *ConstexprProf;
+
+  friend class Decl;
   friend class DeclContext;
+  friend class RecordDecl;
   friend class DeclarationNameTable;
   void ReleaseDeclContextMaps();
   void ReleaseParentMapEntries();
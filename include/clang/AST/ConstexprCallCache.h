@@ -0,0 +1,85 @@
+//===--- ConstexprCallCache.h - Memoized constexpr calls --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the ConstexprCallCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_AST_CONSTEXPRCALLCACHE_H
+#define LLVM_CLANG_AST_CONSTEXPRCALLCACHE_H
+
+#include "clang/AST/APValue.h"
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+
+namespace clang {
+class FunctionDecl;
+
+/// \brief The results of calls to constexpr functions, keyed by the callee
+/// and the values of the arguments.
+///
+/// Only calls whose arguments and result are plain values, with no pointers
+/// or references into the state of an evaluation, are memoized: such a call
+/// produces the same value every time it is evaluated successfully.
+///
+/// Each result is kept with the evaluation steps and the call depth that
+/// computing it took, so that reusing it is charged against the limits of the
+/// evaluation as evaluating the call again would be.
+class ConstexprCallCache {
+  class Entry : public llvm::FastFoldingSetNode {
+  public:
+    APValue Result;
+    unsigned Steps;
+    unsigned Depth;
+
+    Entry(const llvm::FoldingSetNodeID &ID, const APValue &Result,
+          unsigned Steps, unsigned Depth)
+        : FastFoldingSetNode(ID), Result(Result), Steps(Steps), Depth(Depth) {}
+  };
+
+  llvm::FoldingSet<Entry> Entries;
+  llvm::SpecificBumpPtrAllocator<Entry> Allocator;
+
+  unsigned NumHits, NumMisses;
+
+public:
+  ConstexprCallCache() : NumHits(0), NumMisses(0) {}
+
+  /// \brief Determine whether \p Value can be memoized as an argument or
+  /// result of a call.
+  static bool isMemoizableValue(const APValue &Value);
+
+  /// \brief Compute the key of a call to \p Callee with the arguments
+  /// \p Args into \p ID.
+  ///
+  /// \returns false if the call cannot be memoized.
+  static bool profileCall(const FunctionDecl *Callee, ArrayRef<APValue> Args,
+                          llvm::FoldingSetNodeID &ID);
+
+  /// \brief Retrieve the memoized result of the call \p ID, if computing it
+  /// took at most \p MaxSteps evaluation steps and \p MaxDepth nested calls.
+  ///
+  /// \param Steps Set to the number of steps computing the result took.
+  /// \param Depth Set to the number of nested calls computing the result took.
+  const APValue *lookup(const llvm::FoldingSetNodeID &ID, unsigned MaxSteps,
+                        unsigned MaxDepth, unsigned &Steps, unsigned &Depth);
+
+  /// \brief Record \p Result as the result of the call \p ID, which took
+  /// \p Steps evaluation steps and \p Depth nested calls to compute.
+  void insert(const llvm::FoldingSetNodeID &ID, const APValue &Result,
+              unsigned Steps, unsigned Depth);
+
+  void PrintStats() const;
+};
+
+} // end namespace clang
+
+#endif
@@ -0,0 +1,60 @@
+//===--- ConstexprProfile.h - Constexpr evaluation per function -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the ConstexprProfile class.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_AST_CONSTEXPRPROFILE_H
+#define LLVM_CLANG_AST_CONSTEXPRPROFILE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace clang {
+class FunctionDecl;
+struct PrintingPolicy;
+
+/// \brief Counts the constant evaluation steps spent in each constexpr
+/// function, for -fconstexpr-profile.
+///
+/// A step is a statement evaluated in the body of the function, the unit
+/// that -fconstexpr-steps limits. Steps are charged to the innermost
+/// function being called.
+class ConstexprProfile {
+  struct FunctionCounts {
+    uint64_t Steps;
+    uint64_t Calls;
+    /// \brief The calls answered from the constexpr call cache.
+    uint64_t ReusedCalls;
+
+    FunctionCounts() : Steps(0), Calls(0), ReusedCalls(0) {}
+  };
+
+  llvm::DenseMap<const FunctionDecl *, FunctionCounts> Functions;
+
+public:
+  /// \brief Record an evaluated call to \p Callee that took \p Steps steps,
+  /// not counting the steps of the calls it made.
+  void addCall(const FunctionDecl *Callee, uint64_t Steps);
+
+  /// \brief Record a call to \p Callee whose result was memoized.
+  void addReusedCall(const FunctionDecl *Callee);
+
+  /// \brief Print the functions by decreasing number of steps.
+  void print(raw_ostream &OS, const PrintingPolicy &Policy) const;
+
+  /// \brief Forget all functions, before their declarations are freed.
+  void clear() { Functions.clear(); }
+};
+
+} // end namespace clang
+
+#endif
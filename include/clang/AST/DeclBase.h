@@ -1774,6 +1774,10 @@ private:
   void makeDeclVisibleInContextWithFlags(NamedDecl *D, bool Internal,
                                          bool Rediscoverable);
   void makeDeclVisibleInContextImpl(NamedDecl *D, bool Internal);
+
+  /// \brief Count a change to the declarations of this context, if it is a
+  /// namespace or the translation unit, or is transparent within one.
+  void noteFileContextChange() const;
 };
 
 inline bool Decl::isTemplateParameter() const {
@@ -0,0 +1,118 @@
+//===--- CostReport.h - Compile time per header and template ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the CostReport interface.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_COSTREPORT_H
+#define LLVM_CLANG_BASIC_COSTREPORT_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/TimeValue.h"
+#include <string>
+
+namespace clang {
+
+/// \brief Attributes the compile time of a translation unit to the headers,
+/// template instantiations and constexpr functions it was spent on, for
+/// -fcost-report=<file>.
+///
+/// Each kind of entity is tracked independently: the time of the whole
+/// translation unit is split between the files being lexed, while the time
+/// spent instantiating templates is also split between the templates being
+/// instantiated. For every entity the report has its self time, which
+/// excludes nested entities of the same kind, and its total time, which
+/// includes them.
+///
+/// The report is written as JSON, ranked by total time, so that the reports
+/// of a whole build can be merged by adding up the entries of the same name.
+class CostReport {
+public:
+  enum EntityKind {
+    /// \brief A source file, from \#include until the end of the file.
+    Header,
+    /// \brief The instantiation of a template specialization or member.
+    TemplateInstantiation,
+    /// \brief A call to a constexpr function during constant evaluation.
+    ConstexprCall,
+    NumEntityKinds
+  };
+
+private:
+  struct Entity {
+    double SelfTime;
+    double TotalTime;
+    uint64_t Count;
+    /// \brief How many times the entity is currently entered, for recursion.
+    unsigned Active;
+    /// \brief When the outermost active entry of the entity started.
+    double OutermostStart;
+
+    Entity()
+        : SelfTime(0), TotalTime(0), Count(0), Active(0), OutermostStart(0) {}
+  };
+
+  struct KindData {
+    llvm::StringMap<Entity> Entities;
+    /// \brief The entities currently entered, innermost last.
+    SmallVector<Entity *, 16> Stack;
+    /// \brief When the innermost entity was last entered or resumed.
+    double LastSwitch;
+
+    KindData() : LastSwitch(0) {}
+  };
+
+  KindData Kinds[NumEntityKinds];
+
+  /// \brief The time the report was created; times are relative to it.
+  llvm::sys::TimeValue Start;
+
+  /// \brief The number of seconds since \c Start.
+  double now() const;
+
+public:
+  CostReport();
+
+  /// \brief Returns the name of the list of entities of kind \p Kind in the
+  /// report.
+  static StringRef getKindName(EntityKind Kind);
+
+  /// \brief Start charging the time of entities of kind \p Kind to \p Name,
+  /// until the matching \c exit.
+  void enter(EntityKind Kind, StringRef Name);
+
+  /// \brief Stop charging time to the innermost entity of kind \p Kind.
+  void exit(EntityKind Kind);
+
+  /// \brief Exit all entities that are still entered, such as the main file.
+  void exitAll();
+
+  /// \brief Forget all entities and restart the clock, so that the next
+  /// report only covers what happens from now on.
+  void reset();
+
+  /// \brief Write the report for \p InputFile to \p Path, with at most
+  /// \p Limit entities of each kind, or all of them if \p Limit is 0.
+  ///
+  /// A report from which entities were dropped is marked as truncated, since
+  /// merging it would undercount the dropped entities.
+  ///
+  /// \returns true if an error occurred, with \p ErrorMsg set.
+  bool writeJSON(StringRef Path, StringRef InputFile, unsigned Limit,
+                 std::string &ErrorMsg) const;
+};
+
+} // end namespace clang
+
+#endif
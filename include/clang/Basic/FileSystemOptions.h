@@ -25,6 +25,16 @@ public:
   /// \brief If set, paths are resolved as if the working directory was
   /// set to the value of WorkingDir.
   std::string WorkingDir;
+
+  /// \brief If set, the path of a persistent stat cache to consult for
+  /// failed file lookups.
+  std::string StatCachePath;
+
+  /// \brief Whether to add the failed file lookups of this compilation to
+  /// the cache at StatCachePath.
+  bool RecordStatCache;
+
+  FileSystemOptions() : RecordStatCache(false) {}
 };
 
 } // end namespace clang
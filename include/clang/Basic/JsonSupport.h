@@ -0,0 +1,32 @@
+//===--- JsonSupport.h - Writing JSON output --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Helpers for the JSON reports written by the compiler.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_JSONSUPPORT_H
+#define LLVM_CLANG_BASIC_JSONSUPPORT_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace clang {
+
+/// \brief Write \p Str to \p OS as a quoted JSON string.
+///
+/// Quotes, backslashes and control characters are escaped. Bytes that are
+/// not part of a well-formed UTF-8 sequence are written as U+FFFD, so the
+/// result is valid JSON for any input.
+void printJSONString(raw_ostream &OS, StringRef Str);
+
+} // end namespace clang
+
+#endif
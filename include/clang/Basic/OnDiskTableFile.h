@@ -0,0 +1,59 @@
+//===--- OnDiskTableFile.h - Files holding an on-disk table -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Reading and writing of files that hold a single on-disk hash table
+/// and are shared by concurrent compilations.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_ONDISKTABLEFILE_H
+#define LLVM_CLANG_BASIC_ONDISKTABLEFILE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+#include <string>
+
+namespace clang {
+
+/// \brief Size of the header of an on-disk table file: a four byte magic
+/// number, the format version and the offset of the table's buckets. The
+/// table's entries follow the header.
+const unsigned OnDiskTableFileHeaderSize = 4 + 4 + 4;
+
+/// \brief Map the on-disk table file at \p Path read-only.
+///
+/// \returns null if the file is missing or doesn't start with \p Magic and
+/// \p Version, or if its bucket offset is out of range; otherwise the
+/// mapped file, with \p BucketOffset set.
+std::unique_ptr<llvm::MemoryBuffer> mapOnDiskTableFile(StringRef Path,
+                                                       StringRef Magic,
+                                                       uint32_t Version,
+                                                       uint32_t &BucketOffset);
+
+/// \brief Write an on-disk table file to \p Path.
+///
+/// The file is written to a temporary file that is renamed into place, so
+/// concurrent readers either see the old or the new file.
+///
+/// \param EmitTable Emits the table's entries and buckets to the given
+/// stream and returns the offset of the buckets.
+///
+/// \returns true if an error occurred, with \p ErrorMsg set.
+bool writeOnDiskTableFile(
+    StringRef Path, StringRef Magic, uint32_t Version,
+    llvm::function_ref<uint32_t(raw_ostream &)> EmitTable,
+    std::string &ErrorMsg);
+
+} // end namespace clang
+
+#endif
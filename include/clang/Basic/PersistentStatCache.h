@@ -0,0 +1,115 @@
+//===--- PersistentStatCache.h - On-disk cache of 'stat' calls --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the PersistentStatCache interface.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_PERSISTENTSTATCACHE_H
+#define LLVM_CLANG_BASIC_PERSISTENTSTATCACHE_H
+
+#include "clang/Basic/FileSystemStatCache.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+
+namespace clang {
+
+/// \brief A stat cache backed by a memory-mapped file that is shared by many
+/// compilations.
+///
+/// Most of the 'stat' and 'open' calls issued while searching the header
+/// search path fail, and they fail the same way in every compilation of a
+/// build. The cache file records these failed lookups for absolute paths,
+/// together with the identity and modification time of the directory that
+/// would contain the path. A recorded failure is trusted for as long as that
+/// directory is unchanged, which is checked with a single 'stat' of the
+/// directory per process; successful lookups always go to the file system.
+///
+/// The file is only read through a read-only mapping and is replaced
+/// atomically by \c writeToFile, so any number of compilations can use it
+/// concurrently.
+class PersistentStatCache : public FileSystemStatCache {
+public:
+  /// \brief The state of the parent directory of a cached path.
+  struct DirectoryState {
+    bool Exists;
+    llvm::sys::fs::UniqueID UniqueID;
+    uint64_t ModTime;
+
+    DirectoryState() : Exists(false), ModTime(0) {}
+
+    bool operator==(const DirectoryState &Other) const {
+      return Exists == Other.Exists && UniqueID == Other.UniqueID &&
+             ModTime == Other.ModTime;
+    }
+    bool operator!=(const DirectoryState &Other) const {
+      return !(*this == Other);
+    }
+  };
+
+private:
+  /// \brief The mapped cache file, if any.
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+
+  /// \brief The on-disk hash table in \c Buffer, if any. This is actually an
+  /// \c OnDiskIterableChainedHashTable<PersistentStatCacheTrait>.
+  void *Table;
+
+  /// \brief Whether failed lookups are recorded for \c writeToFile.
+  bool Record;
+
+  /// \brief The state of each directory seen so far, looked up at most once.
+  llvm::StringMap<DirectoryState, llvm::BumpPtrAllocator> Directories;
+
+  /// \brief Failed lookups recorded in this process.
+  llvm::StringMap<DirectoryState, llvm::BumpPtrAllocator> Recorded;
+
+  /// \brief Statistics.
+  unsigned NumLookups, NumHits, NumStaleHits, NumDirectoryStats;
+
+  PersistentStatCache(std::unique_ptr<llvm::MemoryBuffer> Buffer,
+                      uint32_t BucketOffset, bool Record);
+
+  /// \brief Returns the current state of \p Dir, querying the file system
+  /// the first time \p Dir is seen.
+  const DirectoryState &getDirectoryState(StringRef Dir, vfs::FileSystem &FS);
+
+public:
+  ~PersistentStatCache() override;
+
+  /// \brief Load the stat cache stored at \p Path.
+  ///
+  /// A missing or malformed cache file yields an empty cache, so that the
+  /// first compilation of a build can create it.
+  ///
+  /// \param Record Whether to record the failed lookups of this process so
+  /// that they can be added to the cache file with \c writeToFile.
+  static std::unique_ptr<PersistentStatCache> load(StringRef Path,
+                                                   bool Record);
+
+  /// \brief Write the entries of the loaded cache file that are still valid
+  /// together with the failed lookups recorded by this process to \p Path.
+  ///
+  /// \returns true if an error occurred, with \p ErrorMsg set.
+  bool writeToFile(StringRef Path, vfs::FileSystem &FS,
+                   std::string &ErrorMsg);
+
+  /// \brief Print statistics about the number of file system queries avoided.
+  void PrintStats() const;
+
+  LookupResult getStat(const char *Path, FileData &Data, bool isFile,
+                       std::unique_ptr<vfs::File> *F,
+                       vfs::FileSystem &FS) override;
+};
+
+} // end namespace clang
+
+#endif
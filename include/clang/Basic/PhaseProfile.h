@@ -0,0 +1,122 @@
+//===--- PhaseProfile.h - Per-phase compile time profile --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the PhaseProfile interface.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_PHASEPROFILE_H
+#define LLVM_CLANG_BASIC_PHASEPROFILE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Timer.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace clang {
+
+/// \brief A profile of where the time of a compilation goes, written as JSON
+/// for -ftime-report=json=<file>.
+///
+/// The compiler phases call into each other (the parser triggers template
+/// instantiation, which triggers IR generation, which may deserialize
+/// declarations from modules), so the time of each phase is exclusive: while
+/// a phase is entered from within another, the time is only charged to the
+/// inner one. The sum of all phases is the time spent in the profiled
+/// regions.
+class PhaseProfile {
+public:
+  enum PhaseKind {
+    /// \brief Everything done by the frontend action that is not covered by
+    /// one of the other phases.
+    Frontend,
+    /// \brief Handling of preprocessor directives.
+    Preprocess,
+    /// \brief Parsing and semantic analysis, including the lexing of the
+    /// tokens the parser consumes.
+    Parse,
+    /// \brief Instantiation of class, function and variable templates.
+    TemplateInstantiation,
+    /// \brief Reading module and precompiled header files.
+    ModuleLoading,
+    /// \brief Building modules imported by the compilation.
+    ModuleBuilding,
+    /// \brief Generation of LLVM IR.
+    IRGeneration,
+    /// \brief The LLVM optimization and code generation passes.
+    LLVMPasses,
+    NumPhases
+  };
+
+  /// \brief Charges the time between its construction and destruction to a
+  /// phase of a profile, if there is one.
+  class Region {
+    PhaseProfile *Profile;
+
+  public:
+    Region(PhaseProfile *Profile, PhaseKind Phase) : Profile(Profile) {
+      if (Profile)
+        Profile->enterPhase(Phase);
+    }
+    ~Region() {
+      if (Profile)
+        Profile->exitPhase();
+    }
+  };
+
+private:
+  struct PhaseData {
+    llvm::TimeRecord Time;
+    uint64_t Count;
+
+    PhaseData() : Count(0) {}
+  };
+
+  PhaseData Phases[NumPhases];
+
+  /// \brief The phases currently entered, innermost last.
+  SmallVector<PhaseKind, 8> Stack;
+
+  /// \brief When the innermost phase was last entered or resumed.
+  llvm::TimeRecord LastSwitch;
+
+  /// \brief Named counters, in the order they were first set.
+  std::vector<std::pair<std::string, uint64_t>> Counters;
+
+  /// \brief Charge the time since the last switch to the innermost phase.
+  void chargeInnermost();
+
+public:
+  /// \brief Returns the name of \p Phase as written to the profile.
+  static StringRef getPhaseName(PhaseKind Phase);
+
+  /// \brief Start charging time to \p Phase until the matching \c exitPhase.
+  void enterPhase(PhaseKind Phase);
+
+  /// \brief Stop charging time to the innermost phase, resuming the one that
+  /// entered it.
+  void exitPhase();
+
+  /// \brief Add \p Value to the counter \p Name.
+  void addCounter(StringRef Name, uint64_t Value);
+
+  /// \brief Write the profile of the compilation of \p InputFile to \p Path.
+  ///
+  /// \returns true if an error occurred, with \p ErrorMsg set.
+  bool writeJSON(StringRef Path, StringRef InputFile,
+                 std::string &ErrorMsg) const;
+};
+
+} // end namespace clang
+
+#endif
@@ -11,6 +11,7 @@
 #define LLVM_CLANG_CODEGEN_BACKENDUTIL_H
 
 #include "clang/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace llvm {
   class Module;
@@ -31,10 +32,15 @@ namespace clang {
     Backend_EmitObj        ///< Emit native object files
   };
 
+  /// Optimize \p M and emit it to \p OS. If \p PartitionOSs is not empty
+  /// and \p Action generates code, the module is split into one partition
+  /// for \p OS and one for each stream of \p PartitionOSs, and code is
+  /// generated for the partitions in parallel.
   void EmitBackendOutput(DiagnosticsEngine &Diags, const CodeGenOptions &CGOpts,
                          const TargetOptions &TOpts, const LangOptions &LOpts,
                          StringRef TDesc, llvm::Module *M, BackendAction Action,
-                         raw_pwrite_stream *OS);
+                         raw_pwrite_stream *OS,
+                         ArrayRef<raw_pwrite_stream *> PartitionOSs = None);
 }
 
 #endif
@@ -158,6 +158,12 @@ public:
                       const JobAction *JA,
                       bool IssueErrors = false) const;
 
+  /// PrintCommand - Print the command line of \p C, if requested by -v or
+  /// CC_PRINT_OPTIONS.
+  ///
+  /// \return False if the CC_PRINT_OPTIONS log file could not be opened.
+  bool PrintCommand(const Command &C) const;
+
   /// ExecuteCommand - Execute an actual command.
   ///
   /// \param FailingCommand - For non-zero results, this will be set to the
@@ -165,6 +171,14 @@ public:
   /// \return The result code of the subprocess.
   int ExecuteCommand(const Command &C, const Command *&FailingCommand) const;
 
+  /// ReportCommandResult - Diagnose the outcome of executing \p C.
+  ///
+  /// \param FailingCommand - For non-zero results, this will be set to \p C.
+  /// \return The result code to report for the command.
+  int ReportCommandResult(const Command &C, int Res, const std::string &Error,
+                          bool ExecutionFailed,
+                          const Command *&FailingCommand) const;
+
   /// ExecuteJob - Execute a single job.
   ///
   /// \param FailingCommands - For non-zero results, this will be a vector of
@@ -173,6 +187,16 @@ public:
       const JobList &Jobs,
       SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
 
+  /// ExecuteJobsInParallel - Execute up to \p NumParallelJobs independent
+  /// jobs at a time, starting a job once the jobs producing its inputs have
+  /// succeeded. The stderr of each job is buffered and replayed in job order.
+  ///
+  /// \param FailingCommands - For non-zero results, this will be a vector of
+  /// failing commands and their associated result code, in job order.
+  void ExecuteJobsInParallel(
+      const JobList &Jobs, unsigned NumParallelJobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
   /// initCompilationForDiagnostics - Remove stale state and suppress output
   /// so compilation can be reexecuted to generate additional diagnostic
   /// information (e.g., preprocessed source(s)).
@@ -67,6 +67,9 @@ class Driver {
     SaveTempsObj
   } SaveTemps;
 
+  /// The maximum number of jobs to execute concurrently.
+  unsigned NumParallelJobs;
+
 public:
   // Diag - Forwarding function for diagnostics.
   DiagnosticBuilder Diag(unsigned DiagID) const {
@@ -241,6 +244,8 @@ public:
   bool isSaveTempsEnabled() const { return SaveTemps != SaveTempsNone; }
   bool isSaveTempsObj() const { return SaveTemps == SaveTempsObj; }
 
+  unsigned getNumParallelJobs() const { return NumParallelJobs; }
+
   /// @}
   /// @name Primary Functionality
   /// @{
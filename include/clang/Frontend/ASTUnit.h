@@ -226,6 +226,38 @@ public:
     return Preamble;
   }
 
+  /// \brief The places in the main file at which a precompiled preamble may
+  /// end, recorded while parsing so that a later reparse can extend the
+  /// preamble over the top-level declarations that precede an edit.
+  struct DeclBoundaries {
+    /// \brief The offset just past each top-level declaration (including its
+    /// terminating semicolon), in increasing order.
+    std::vector<unsigned> DeclEnds;
+
+    /// \brief The offsets of each conditional directive block, from the
+    /// \#if to the matching \#endif.
+    std::vector<std::pair<unsigned, unsigned> > Conditionals;
+
+    /// \brief The offsets of the \#pragma directives.
+    std::vector<unsigned> Pragmas;
+
+    /// \brief The contents of the main file that these offsets refer to.
+    std::string Text;
+
+    /// \brief Forget the declarations and directives past \p Offset.
+    void dropAfter(unsigned Offset);
+
+    /// \brief Whether a preamble ending at \p Offset can be precompiled,
+    /// given that the preprocessor directives at the start of the file
+    /// take \p DirectivesSize bytes.
+    bool isSafeBoundary(unsigned Offset, unsigned DirectivesSize) const;
+  };
+
+  /// \brief Retrieve the recorded declaration boundaries of the main file,
+  /// or NULL if they are not tracked because the current parse does not
+  /// reuse unchanged declarations or no precompiled preamble is used.
+  DeclBoundaries *getDeclBoundaries();
+
   /// Data used to determine if a file used in the preamble has been changed.
   struct PreambleFileHash {
     /// All files have size set.
@@ -292,6 +324,13 @@ private:
   /// \brief A list of the serialization ID numbers for each of the top-level
   /// declarations parsed within the precompiled preamble.
   std::vector<serialization::DeclID> TopLevelDeclsInPreamble;
+
+  /// \brief The declaration boundaries recorded for the main file.
+  DeclBoundaries Boundaries;
+
+  /// \brief The offset of the first change in the main file the last time
+  /// that a reparse saw it changed, or ~0U if it has not changed yet.
+  unsigned LastChangeOffset;
   
   /// \brief Whether we should be caching code-completion results.
   bool ShouldCacheCodeCompletionResults : 1;
@@ -303,6 +342,15 @@ private:
   /// \brief True if non-system source files should be treated as volatile
   /// (likely to change while trying to use them).
   bool UserFilesAreVolatile : 1;
+
+  /// \brief Whether reparses should extend the precompiled preamble over the
+  /// unchanged top-level declarations of the main file.
+  bool ReuseUnchangedDecls : 1;
+
+  /// \brief Whether the precompiled preamble covers top-level declarations
+  /// of the main file, rather than only the preprocessor directives at its
+  /// start.
+  bool PreambleCoversDecls : 1;
  
   /// \brief The language options used when we load an AST file.
   LangOptions ASTFileLangOpts;
@@ -443,6 +491,8 @@ private:
   };
   ComputedPreamble ComputePreamble(CompilerInvocation &Invocation,
                                    unsigned MaxLines);
+  void extendPreambleOverUnchangedDecls(ComputedPreamble &NewPreamble,
+                                        bool AllowRebuild, unsigned MaxLines);
 
   std::unique_ptr<llvm::MemoryBuffer> getMainBufferWithPrecompiledPreamble(
       std::shared_ptr<PCHContainerOperations> PCHContainerOps,
@@ -850,10 +900,17 @@ public:
   /// \brief Reparse the source files using the same command-line options that
   /// were originally used to produce this translation unit.
   ///
+  /// \param ReuseUnchangedDecls When true, the precompiled preamble is
+  /// extended over the top-level declarations of the main file that precede
+  /// the first edit, so that only the rest of the main file is parsed again.
+  /// The boundaries of the declarations are only recorded by reparses that
+  /// pass this flag, so the first such reparse cannot reuse any.
+  ///
   /// \returns True if a failure occurred that causes the ASTUnit not to
   /// contain any translation-unit information, false otherwise.
   bool Reparse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-               ArrayRef<RemappedFile> RemappedFiles = None);
+               ArrayRef<RemappedFile> RemappedFiles = None,
+               bool ReuseUnchangedDecls = false);
 
   /// \brief Perform code completion at the given file, line, and
   /// column within this translation unit.
@@ -38,6 +38,8 @@ class ASTContext;
 class ASTConsumer;
 class ASTReader;
 class CodeCompleteConsumer;
+class ConstexprProfile;
+class CostReport;
 class DiagnosticsEngine;
 class DiagnosticConsumer;
 class ExternalASTSource;
@@ -45,6 +47,8 @@ class FileEntry;
 class FileManager;
 class FrontendAction;
 class Module;
+class PersistentStatCache;
+class PhaseProfile;
 class Preprocessor;
 class Sema;
 class SourceManager;
@@ -84,6 +88,10 @@ class CompilerInstance : public ModuleLoader {
   /// The file manager.
   IntrusiveRefCntPtr<FileManager> FileMgr;
 
+  /// The persistent stat cache installed in the file manager by
+  /// createFileManager, if any. Owned by the file manager.
+  PersistentStatCache *StatCache;
+
   /// The source manager.
   IntrusiveRefCntPtr<SourceManager> SourceMgr;
 
@@ -108,6 +116,17 @@ class CompilerInstance : public ModuleLoader {
   /// \brief The frontend timer.
   std::unique_ptr<llvm::Timer> FrontendTimer;
 
+  /// \brief The per-phase profile written for -ftime-report=json=<file>.
+  std::unique_ptr<PhaseProfile> Profile;
+
+  /// \brief The report of the time per header and template written for
+  /// -fcost-report=<file>.
+  std::unique_ptr<CostReport> Costs;
+
+  /// \brief The constant evaluation steps per function printed for
+  /// -fconstexpr-profile.
+  std::unique_ptr<ConstexprProfile> ConstexprProf;
+
   /// \brief The ASTReader, if one exists.
   IntrusiveRefCntPtr<ASTReader> ModuleManager;
 
@@ -563,6 +582,22 @@ public:
     return *FrontendTimer;
   }
 
+  /// }
+  /// @name Phase profile
+  /// {
+
+  /// \brief Returns the profile of the compiler phases, or null if no profile
+  /// was requested.
+  PhaseProfile *getPhaseProfile() const { return Profile.get(); }
+
+  /// \brief Returns the report of the time spent per header, template
+  /// instantiation and constexpr function, or null if none was requested.
+  CostReport *getCostReport() const { return Costs.get(); }
+
+  /// \brief Returns the profile of constant evaluation steps per constexpr
+  /// function, or null if none was requested.
+  ConstexprProfile *getConstexprProfile() const { return ConstexprProf.get(); }
+
   /// }
   /// @name Output Files
   /// {
@@ -127,6 +127,9 @@ public:
                                            /// metrics and statistics.
   unsigned ShowTimers : 1;                 ///< Show timers for individual
                                            /// actions.
+  unsigned ShowConstexprProfile : 1;       ///< Show the constant evaluation
+                                           /// steps of each constexpr
+                                           /// function.
   unsigned ShowVersion : 1;                ///< Show the -version text.
   unsigned FixWhatYouCan : 1;              ///< Apply fixes even if there are
                                            /// unfixable errors.
@@ -213,6 +216,18 @@ public:
   /// If given, filter dumped AST Decl nodes by this substring.
   std::string ASTDumpFilter;
 
+  /// If given, the file to write a JSON profile of the compiler phases to.
+  std::string TimeReportJSONPath;
+
+  /// If given, the file to write the time spent in each header, template
+  /// instantiation and constexpr function to.
+  std::string CostReportPath;
+
+  /// The maximum number of entries of each kind in the cost report, or 0 for
+  /// no limit. Reports are merged across a build, so there is no limit by
+  /// default.
+  unsigned CostReportLimit;
+
   /// If given, enable code completion at the provided location.
   ParsedSourceLocation CodeCompletionAt;
 
@@ -255,12 +270,13 @@ public:
 public:
   FrontendOptions() :
     DisableFree(false), RelocatablePCH(false), ShowHelp(false),
-    ShowStats(false), ShowTimers(false), ShowVersion(false),
+    ShowStats(false), ShowTimers(false), ShowConstexprProfile(false),
+    ShowVersion(false),
     FixWhatYouCan(false), FixOnlyWarnings(false), FixAndRecompile(false),
     FixToTemporaries(false), ARCMTMigrateEmitARCErrors(false),
     SkipFunctionBodies(false), UseGlobalModuleIndex(true),
     GenerateGlobalModuleIndex(true), ASTDumpDecls(false), ASTDumpLookups(false),
-    ARCMTAction(ARCMT_None), ObjCMTAction(ObjCMT_None),
+    ARCMTAction(ARCMT_None), ObjCMTAction(ObjCMT_None), CostReportLimit(0),
     ProgramAction(frontend::ParseSyntaxOnly)
   {}
 
@@ -33,6 +33,12 @@ namespace serialized_diags {
 /// This allows wrapper tools for Clang to get diagnostics from Clang
 /// (via libclang) without needing to parse Clang's command line output.
 ///
+/// The diagnostics are streamed to a temporary file as they are emitted.
+/// With DiagnosticOptions::SerializeDiagnosticsIndex, they are also indexed,
+/// so that readers can select diagnostics by file or category without reading
+/// the others. Indexed files are not readable by readers that predate the
+/// index.
+///
 std::unique_ptr<DiagnosticConsumer> create(StringRef OutputFile,
                                            DiagnosticOptions *Diags,
                                            bool MergeChildRecords = false);
@@ -33,7 +33,9 @@ enum class SDError {
   UnsupportedConstruct,
   /// A generic error for subclass handlers that don't want or need to define
   /// their own error_category.
-  HandlerFailed
+  HandlerFailed,
+  MissingIndex,
+  MalformedIndexBlock
 };
 
 const std::error_category &SDErrorCategory();
@@ -64,8 +66,44 @@ public:
   /// \brief Read the diagnostics in \c File
   std::error_code readDiagnostics(StringRef File);
 
+  /// \brief Read the top-level diagnostics in \c File that are located in the
+  /// source file \c SourceFile, together with their notes.
+  ///
+  /// Only the index and the selected diagnostics are read. All file,
+  /// category and flag records are visited first. Returns
+  /// \c SDError::MissingIndex if \c File was written without an index, that
+  /// is, without -serialize-diagnostic-index.
+  std::error_code readDiagnosticsInFile(StringRef File, StringRef SourceFile);
+
+  /// \brief Read the top-level diagnostics in \c File whose category is
+  /// named \c Category, like \c readDiagnosticsInFile.
+  std::error_code readDiagnosticsInCategory(StringRef File,
+                                            StringRef Category);
+
 private:
   enum class Cursor;
+  enum class IndexKey { File, Category };
+
+  /// \brief The bit offset of the last index block, as read from the META
+  /// block, or zero if there is none.
+  uint64_t IndexLocation = 0;
+
+  /// \brief Read the diagnostics in \c File whose file or category, as given
+  /// by \c Key, is named \c Name.
+  std::error_code readIndexedDiagnostics(StringRef File, IndexKey Key,
+                                         StringRef Name);
+
+  /// \brief Read an index block from \c Stream, and collect the offsets of
+  /// the diagnostic blocks whose file or category is named \c Name.
+  ///
+  /// \param IDs The IDs of the files or categories named \c Name, which are
+  /// collected from the names in the last index block, read first.
+  /// \param PreviousBitNo Set to the offset of the previous index block, if
+  /// there is one.
+  std::error_code readIndexBlock(llvm::BitstreamCursor &Stream, IndexKey Key,
+                                 StringRef Name, SmallVectorImpl<uint64_t> &IDs,
+                                 SmallVectorImpl<uint64_t> &Offsets,
+                                 uint64_t &PreviousBitNo);
 
   /// \brief Read to the next record or block to process.
   llvm::ErrorOr<Cursor> skipUntilRecordOrBlock(llvm::BitstreamCursor &Stream,
@@ -22,7 +22,13 @@ enum BlockIDs {
 
   /// \brief The this block acts as a container for all the information
   /// for a specific diagnostic.
-  BLOCK_DIAG
+  BLOCK_DIAG,
+
+  /// \brief A top-level block which lists the location of top-level
+  /// diagnostic blocks, so that diagnostics can be read selectively. The
+  /// last one, at the end of the file, also lists the files, categories
+  /// and flags. Only written with -serialize-diagnostic-index.
+  BLOCK_INDEX
 };
 
 enum RecordIDs {
@@ -37,6 +43,18 @@ enum RecordIDs {
   RECORD_LAST = RECORD_FIXIT
 };
 
+/// \brief Records of the index, which come after the records of the
+/// diagnostic blocks so that readers that do not know them skip them.
+enum IndexRecordIDs {
+  /// \brief The bit offset of the index block, in the META block.
+  RECORD_INDEX_LOCATION = RECORD_LAST + 1,
+  /// \brief The bit offset, file, category and level of a top-level
+  /// diagnostic block, in the INDEX block.
+  RECORD_INDEX_ENTRY,
+  /// \brief The bit offset of the previous INDEX block, in an INDEX block.
+  RECORD_INDEX_PREVIOUS
+};
+
 /// \brief A stable version of DiagnosticIDs::Level.
 ///
 /// Do not change the order of values in this enum, and please increment the
@@ -51,7 +69,11 @@ enum Level {
 };
 
 /// \brief The serialized diagnostics version number.
-enum { VersionNumber = 2 };
+///
+/// Files with INDEX blocks are version 3, so that readers which do not know
+/// the INDEX block reject them with a version mismatch. Files without an
+/// index are still written as version 2.
+enum { VersionNumber = 3, UnindexedVersionNumber = 2 };
 
 } // end serialized_diags namespace
 } // end clang namespace
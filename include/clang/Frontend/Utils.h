@@ -35,6 +35,7 @@ class ASTConsumer;
 class ASTReader;
 class CompilerInstance;
 class CompilerInvocation;
+class CostReport;
 class Decl;
 class DependencyOutputOptions;
 class DiagnosticsEngine;
@@ -160,6 +161,11 @@ void AttachHeaderIncludeGen(Preprocessor &PP, bool ShowAllHeaders = false,
                             StringRef OutputPath = "",
                             bool ShowDepth = true, bool MSStyle = false);
 
+/// AttachHeaderCostTracker - Create a callback that charges the time spent in
+/// each source file to it in \p Report, and attach it to the given
+/// preprocessor.
+void AttachHeaderCostTracker(Preprocessor &PP, CostReport &Report);
+
 /// Cache tokens for use with PCH. Note that this requires a seekable stream.
 void CacheTokens(Preprocessor &PP, raw_pwrite_stream *OS);
 
@@ -18,6 +18,7 @@
 #include "clang/Lex/ModuleMap.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Allocator.h"
@@ -32,6 +33,7 @@ class FileEntry;
 class FileManager;
 class HeaderSearchOptions;
 class IdentifierInfo;
+class IncludeGuardDatabase;
 class Preprocessor;
 
 /// \brief The preprocessor keeps track of this information for each
@@ -249,10 +251,18 @@ class HeaderSearch {
 
   /// \brief Entity used to look up stored header file information.
   ExternalHeaderFileInfoSource *ExternalSource;
+
+  /// \brief The include guards recorded by earlier compilations, if any.
+  std::unique_ptr<IncludeGuardDatabase> GuardDatabase;
+
+  /// \brief The working directory against which relative header paths are
+  /// made absolute for the include guard database, looked up once.
+  Optional<std::string> GuardDatabaseWorkingDir;
   
   // Various statistics we track for performance analysis.
   unsigned NumIncluded;
   unsigned NumMultiIncludeFileOptzn;
+  unsigned NumGuardDatabaseOptzn;
   unsigned NumFrameworkLookups, NumSubFrameworkLookups;
 
   const LangOptions &LangOpts;
@@ -359,6 +369,20 @@ public:
   void SetExternalSource(ExternalHeaderFileInfoSource *ES) {
     ExternalSource = ES;
   }
+
+  /// \brief Set the database of include guards recorded by earlier
+  /// compilations.
+  void setIncludeGuardDatabase(std::unique_ptr<IncludeGuardDatabase> DB);
+
+  IncludeGuardDatabase *getIncludeGuardDatabase() const {
+    return GuardDatabase.get();
+  }
+
+  /// \brief Add the include guards of the headers seen so far to the include
+  /// guard database and write it to \p Path.
+  ///
+  /// \returns true if an error occurred, with \p ErrorMsg set.
+  bool writeIncludeGuardDatabase(StringRef Path, std::string &ErrorMsg);
   
   /// \brief Set the target information for the header search, if not
   /// already known.
@@ -668,6 +692,11 @@ private:
 
   /// \brief Return the HeaderFileInfo structure for the specified FileEntry.
   HeaderFileInfo &getFileInfo(const FileEntry *FE);
+
+  /// \brief Compute the absolute path under which \p File is stored in the
+  /// include guard database.
+  bool getIncludeGuardDatabaseKey(const FileEntry *File,
+                                  SmallVectorImpl<char> &Path);
 };
 
 }  // end namespace clang
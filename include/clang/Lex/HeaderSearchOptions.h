@@ -168,6 +168,19 @@ public:
   /// \brief Whether to validate system input files when a module is loaded.
   unsigned ModulesValidateSystemHeaders : 1;
 
+  /// \brief The number of threads used to read the module files imported by
+  /// a module file ahead of loading them. Values below 2 disable prefetching
+  /// and read the files one at a time.
+  unsigned ModulesPrefetchThreads;
+
+  /// \brief If set, the path of a persistent include guard database used to
+  /// skip headers whose guard macro is already defined.
+  std::string IncludeGuardDatabasePath;
+
+  /// \brief Whether to add the include guards seen by this compilation to
+  /// the database at IncludeGuardDatabasePath.
+  unsigned RecordIncludeGuardDatabase : 1;
+
 public:
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(0),
@@ -177,7 +190,8 @@ public:
         UseBuiltinIncludes(true), UseStandardSystemIncludes(true),
         UseStandardCXXIncludes(true), UseLibcxx(false), Verbose(false),
         ModulesValidateOncePerBuildSession(false),
-        ModulesValidateSystemHeaders(false) {}
+        ModulesValidateSystemHeaders(false), ModulesPrefetchThreads(0),
+        RecordIncludeGuardDatabase(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
@@ -0,0 +1,115 @@
+//===--- IncludeGuardDatabase.h - Persistent include guards -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the IncludeGuardDatabase interface.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LEX_INCLUDEGUARDDATABASE_H
+#define LLVM_CLANG_LEX_INCLUDEGUARDDATABASE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+#include <string>
+
+namespace clang {
+
+class FileEntry;
+
+namespace vfs {
+class FileSystem;
+}
+
+/// \brief A database of the include guards of headers that is shared by
+/// many compilations.
+///
+/// The multiple-include optimization only learns the controlling macro of a
+/// header after lexing it once, so every compilation has to open and lex
+/// each header at least once, even when its guard macro is already defined.
+/// The database records the controlling macro of each header together with
+/// the identity, size and modification time of the file. An entry is trusted
+/// as long as these are unchanged, which is known from the 'stat' done when
+/// the header is looked up.
+///
+/// The file is only read through a read-only mapping and is replaced
+/// atomically by \c writeToFile, so any number of compilations can use it
+/// concurrently.
+class IncludeGuardDatabase {
+public:
+  /// \brief The include guard information recorded for a header.
+  struct HeaderGuard {
+    llvm::sys::fs::UniqueID UniqueID;
+    uint64_t Size;
+    uint64_t ModTime;
+    /// \brief The controlling macro.
+    StringRef ControllingMacro;
+
+    HeaderGuard() : Size(0), ModTime(0) {}
+
+    /// \brief Whether this entry describes the current contents of \p File.
+    bool matches(const FileEntry *File) const;
+  };
+
+private:
+  /// \brief The mapped database file, if any.
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+
+  /// \brief The on-disk hash table in \c Buffer, if any. This is actually an
+  /// \c OnDiskIterableChainedHashTable<IncludeGuardDatabaseTrait>.
+  void *Table;
+
+  /// \brief Headers recorded in this process. The controlling macro names
+  /// must stay alive until \c writeToFile.
+  llvm::StringMap<HeaderGuard, llvm::BumpPtrAllocator> Recorded;
+
+  /// \brief Statistics.
+  unsigned NumLookups, NumHits, NumStaleHits;
+
+  IncludeGuardDatabase(std::unique_ptr<llvm::MemoryBuffer> Buffer,
+                       uint32_t BucketOffset);
+
+public:
+  ~IncludeGuardDatabase();
+
+  /// \brief Load the include guard database stored at \p Path.
+  ///
+  /// A missing or malformed database yields an empty database, so that the
+  /// first compilation of a build can create it.
+  static std::unique_ptr<IncludeGuardDatabase> load(StringRef Path);
+
+  /// \brief Look up the include guard recorded for \p File, which was found
+  /// at the absolute path \p Path.
+  ///
+  /// \returns true if an entry that is still valid for \p File was found,
+  /// with \p Guard set.
+  bool lookup(StringRef Path, const FileEntry *File, HeaderGuard &Guard);
+
+  /// \brief Record the include guard of \p File, found at the absolute path
+  /// \p Path, for \c writeToFile.
+  void record(StringRef Path, const FileEntry *File,
+              StringRef ControllingMacro);
+
+  /// \brief Write the entries of the loaded database whose file is unchanged
+  /// together with the headers recorded by this process to \p Path.
+  ///
+  /// \returns true if an error occurred, with \p ErrorMsg set.
+  bool writeToFile(StringRef Path, vfs::FileSystem &FS, std::string &ErrorMsg);
+
+  /// \brief Print statistics about the lookups done in this process.
+  void PrintStats() const;
+};
+
+} // end namespace clang
+
+#endif
@@ -58,6 +58,7 @@ class DirectoryLookup;
 class PreprocessingRecord;
 class ModuleLoader;
 class PreprocessorOptions;
+class PhaseProfile;
 
 /// \brief Stores token information for comparing actual tokens with
 /// predefined values.  Only handles simple tokens and identifiers.
@@ -107,6 +108,10 @@ class Preprocessor : public RefCountedBase<Preprocessor> {
   /// \brief External source of macros.
   ExternalPreprocessorSource *ExternalSource;
 
+  /// \brief The profile the time spent handling directives is charged to, if
+  /// any.
+  PhaseProfile *Profile;
+
 
   /// An optional PTHManager object used for getting tokens from
   /// a token cache rather than lexing the original source file.
@@ -573,6 +578,8 @@ class Preprocessor : public RefCountedBase<Preprocessor> {
   unsigned NumMacroExpanded, NumFnMacroExpanded, NumBuiltinMacroExpanded;
   unsigned NumFastMacroExpanded, NumTokenPaste, NumFastTokenPaste;
   unsigned NumSkipped;
+  // Only counted while a phase profile is set.
+  unsigned NumLexedTokens;
 
   /// \brief The predefined macros that preprocessor should use from the
   /// command line etc.
@@ -688,6 +695,11 @@ public:
   Builtin::Context &getBuiltinInfo() { return BuiltinInfo; }
   llvm::BumpPtrAllocator &getPreprocessorAllocator() { return BP; }
 
+  /// \brief Set the profile that the time spent handling directives is
+  /// charged to, or null to stop profiling.
+  void setPhaseProfile(PhaseProfile *P) { Profile = P; }
+  PhaseProfile *getPhaseProfile() const { return Profile; }
+
   void setPTHManager(PTHManager* pm);
 
   PTHManager *getPTHManager() { return PTH.get(); }
@@ -1478,6 +1490,10 @@ public:
 
   void PrintStats();
 
+  /// \brief Add the statistics of this preprocessor to the counters of
+  /// \p Profile.
+  void addStatsToProfile(PhaseProfile &Profile) const;
+
   size_t getTotalMemory() const;
 
   /// When the macro expander pastes together a comment (/##/) in Microsoft
@@ -179,6 +179,10 @@ public:
   ///
   /// \returns true if the declaration was added, false otherwise.
   bool tryAddTopLevelDecl(NamedDecl *D, DeclarationName Name);
+
+  /// \brief Retrieve the number of times a declaration that is not local to
+  /// a function was added to or removed from the decl chains.
+  unsigned getNumNonLocalChanges() const { return NumNonLocalChanges; }
   
   explicit IdentifierResolver(Preprocessor &PP);
   ~IdentifierResolver();
@@ -190,6 +194,10 @@ private:
   class IdDeclInfoMap;
   IdDeclInfoMap *IdDeclInfos;
 
+  unsigned NumNonLocalChanges;
+
+  void noteChange(const NamedDecl *D);
+
   void updatingIdentifier(IdentifierInfo &II);
   void readingIdentifier(IdentifierInfo &II);
   
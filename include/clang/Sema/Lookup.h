@@ -17,6 +17,8 @@
 
 #include "clang/AST/DeclCXX.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
 
 namespace clang {
 
@@ -763,6 +765,69 @@ public:
   iterator end() { return iterator(Decls.end()); }
 };
 
+/// \brief The results of C++ unqualified name lookup in namespace scopes,
+/// reused by later lookups of the same name from the same scope.
+///
+/// Once unqualified lookup has searched the local, class and template
+/// parameter scopes, the rest of its result only depends on the
+/// declarations of the enclosing namespaces and of the namespaces nominated
+/// by their using-directives. Rather than tracking those contexts one by
+/// one, the cache is emptied whenever a declaration is added to or removed
+/// from any namespace, or from a scope that is not local to a function.
+class UnqualifiedLookupCache {
+  class Entry : public llvm::FoldingSetNode {
+  public:
+    DeclarationName Name;
+    Sema::LookupNameKind Kind;
+    unsigned IDNS;
+    Scope *S;
+    DeclContext *Entity;
+    /// \brief The declarations found, allocated along with the entry.
+    ArrayRef<NamedDecl *> Decls;
+
+    Entry(DeclarationName Name, Sema::LookupNameKind Kind, unsigned IDNS,
+          Scope *S, DeclContext *Entity, ArrayRef<NamedDecl *> Decls)
+        : Name(Name), Kind(Kind), IDNS(IDNS), S(S), Entity(Entity),
+          Decls(Decls) {}
+
+    void Profile(llvm::FoldingSetNodeID &ID) {
+      Profile(ID, Name, Kind, IDNS, S, Entity);
+    }
+    static void Profile(llvm::FoldingSetNodeID &ID, DeclarationName Name,
+                        Sema::LookupNameKind Kind, unsigned IDNS, Scope *S,
+                        DeclContext *Entity);
+  };
+
+  llvm::FoldingSet<Entry> Entries;
+  llvm::BumpPtrAllocator Allocator;
+
+  /// \brief The state of the translation unit the entries are valid for.
+  unsigned FileContextGeneration, ScopeGeneration;
+
+  unsigned NumHits, NumMisses, NumFlushes;
+
+public:
+  UnqualifiedLookupCache()
+      : FileContextGeneration(0), ScopeGeneration(0), NumHits(0),
+        NumMisses(0), NumFlushes(0) {}
+
+  /// \brief Forget all entries if the declarations of namespaces or of
+  /// non-local scopes changed since they were added.
+  void validate(unsigned FileContextChanges, unsigned ScopeChanges);
+
+  /// \brief Add the cached results of looking up the name of \p R from the
+  /// namespace scope \p S to \p R.
+  ///
+  /// \returns true if there were cached results, even if they are empty.
+  bool lookup(LookupResult &R, Scope *S);
+
+  /// \brief Record the declarations in \p R as the results of looking up
+  /// its name from the namespace scope \p S.
+  void insert(const LookupResult &R, Scope *S);
+
+  void PrintStats() const;
+};
+
 }
 
 #endif
@@ -23,6 +23,7 @@
 #include "clang/AST/UnresolvedSet.h"
 #include "clang/Sema/SemaFixItUtils.h"
 #include "clang/Sema/TemplateDeduction.h"
+#include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/AlignOf.h"
@@ -791,6 +792,60 @@ namespace clang {
                                  const OverloadCandidate& Cand2,
                                  SourceLocation Loc,
                                  bool UserDefinedConversion = false);
+
+  /// \brief The functions chosen by overload resolution for overloaded
+  /// operators, so that later uses of an operator with the same operands
+  /// and candidate functions only have to consider the function that won.
+  ///
+  /// The key of a resolution is built by the caller and covers everything
+  /// the result depends on except the definitions of classes. The cache is
+  /// therefore emptied whenever a class definition that is not a template
+  /// instantiation is completed, or the set of visible modules changes.
+  class OverloadResolutionCache {
+  public:
+    /// \brief A function chosen by overload resolution.
+    struct Result {
+      FunctionDecl *Function;
+      DeclAccessPair FoundDecl;
+      /// \brief Whether there was more than one candidate.
+      bool HadMultipleCandidates;
+    };
+
+  private:
+    class Entry : public llvm::FastFoldingSetNode {
+    public:
+      Result Resolution;
+
+      Entry(const llvm::FoldingSetNodeID &ID, const Result &Resolution)
+          : FastFoldingSetNode(ID), Resolution(Resolution) {}
+    };
+
+    llvm::FoldingSet<Entry> Entries;
+    llvm::SpecificBumpPtrAllocator<Entry> Allocator;
+
+    /// \brief The state of the translation unit the entries are valid for.
+    unsigned RecordDefinitionGeneration, VisibilityGeneration;
+
+    unsigned NumHits, NumMisses, NumFlushes;
+
+  public:
+    OverloadResolutionCache()
+        : RecordDefinitionGeneration(0), VisibilityGeneration(0), NumHits(0),
+          NumMisses(0), NumFlushes(0) {}
+
+    /// \brief Forget all entries if the number of completed class
+    /// definitions or the set of visible modules changed since they were
+    /// added.
+    void validate(unsigned RecordDefinitions, unsigned Visibility);
+
+    /// \brief Retrieve the result of the resolution \p ID, if any.
+    const Result *lookup(const llvm::FoldingSetNodeID &ID);
+
+    /// \brief Record \p Resolution as the result of the resolution \p ID.
+    void insert(const llvm::FoldingSetNodeID &ID, const Result &Resolution);
+
+    void PrintStats() const;
+  };
 } // end namespace clang
 
 #endif // LLVM_CLANG_SEMA_OVERLOAD_H
@@ -146,6 +146,7 @@ namespace clang {
   class OMPThreadPrivateDecl;
   class OMPClause;
   class OverloadCandidateSet;
+  class OverloadResolutionCache;
   class OverloadExpr;
   class ParenListExpr;
   class ParmVarDecl;
@@ -171,6 +172,7 @@ namespace clang {
   class TypeLoc;
   class TypoCorrectionConsumer;
   class UnqualifiedId;
+  class UnqualifiedLookupCache;
   class UnresolvedLookupExpr;
   class UnresolvedMemberExpr;
   class UnresolvedSetImpl;
@@ -674,6 +676,10 @@ public:
 
   IdentifierResolver IdResolver;
 
+  /// \brief The results of unqualified lookups in namespace scopes, created
+  /// the first time such a lookup is performed.
+  std::unique_ptr<UnqualifiedLookupCache> UnqualifiedLookups;
+
   /// Translation Unit Scope - useful to Objective-C actions that need
   /// to lookup file scope declarations in the "ordinary" C decl namespace.
   /// For example, user-defined classes, built-in "id" type, etc.
@@ -932,6 +938,23 @@ public:
   /// \brief The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// \brief The number of expressions of template patterns that template
+  /// instantiation reused as they are, and the number it transformed.
+  unsigned NumSharedInstantiatedExprs, NumRebuiltInstantiatedExprs;
+
+  /// \brief Whether each expression of a template pattern seen by template
+  /// instantiation can be reused as is by every instantiation.
+  ///
+  /// This is the case for expressions that neither depend on template
+  /// parameters nor refer to any declaration, such as arithmetic on
+  /// literals. The answer is the same for every specialization of the
+  /// pattern, so it is computed once.
+  llvm::DenseMap<const Expr *, bool> ShareableInstantiationExprs;
+
+  /// \brief The functions chosen for overloaded operators, created the
+  /// first time an overloaded operator is resolved.
+  std::unique_ptr<OverloadResolutionCache> OverloadCache;
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
@@ -384,6 +384,18 @@ private:
   /// \brief A timer used to track the time spent deserializing.
   std::unique_ptr<llvm::Timer> ReadTimer;
 
+  /// \brief The number of threads used to read the module files imported by
+  /// a module file before loading them. Values below 2 read them one at a
+  /// time.
+  unsigned ModuleFilePrefetchThreads;
+
+  /// \brief A timer used to track the time spent waiting for module files
+  /// to be read ahead of time.
+  std::unique_ptr<llvm::Timer> PrefetchTimer;
+
+  /// \brief The number of bytes of module files read ahead of time.
+  uint64_t NumModuleFileBytesPrefetched;
+
   /// \brief The location where the module file will be considered as
   /// imported from. For non-module AST types it should be invalid.
   SourceLocation CurrentImportLoc;
@@ -1405,6 +1417,17 @@ public:
   void setDeserializationListener(ASTDeserializationListener *Listener,
                                   bool TakeOwnership = false);
 
+  /// \brief Read the module files imported by each module file concurrently
+  /// on up to \p NumThreads threads before loading them one by one.
+  ///
+  /// \param Timer If non-null, a timer used to track the time spent waiting
+  /// for these reads.
+  void setModuleFilePrefetching(unsigned NumThreads,
+                                std::unique_ptr<llvm::Timer> Timer = {}) {
+    ModuleFilePrefetchThreads = NumThreads;
+    PrefetchTimer = std::move(Timer);
+  }
+
   /// \brief Determine whether this AST reader has a global index.
   bool hasGlobalIndex() const { return (bool)GlobalIndex; }
 
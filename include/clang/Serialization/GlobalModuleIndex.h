@@ -122,6 +122,8 @@ class GlobalModuleIndex {
   GlobalModuleIndex(const GlobalModuleIndex &) = delete;
   GlobalModuleIndex &operator=(const GlobalModuleIndex &) = delete;
 
+  friend class GlobalModuleIndexBuilder;
+
 public:
   ~GlobalModuleIndex();
 
@@ -192,14 +194,24 @@ public:
 
   /// \brief Write a global index into the given
   ///
+  /// The information of the existing index in \p Path is reused for the
+  /// module files that have not changed since it was written, so only new and
+  /// rebuilt module files are read.
+  ///
   /// \param FileMgr The file manager to use to load module files.
   /// \param PCHContainerRdr - The PCHContainerOperations to use for loading and
   /// creating modules.
   /// \param Path The path to the directory containing module files, into
   /// which the global index will be written.
+  /// \param NumModuleFilesRead If non-null, set to the number of module files
+  /// that were read.
+  /// \param NumModuleFilesReused If non-null, set to the number of module
+  /// files whose information was taken from the existing index.
   static ErrorCode writeIndex(FileManager &FileMgr,
                               const PCHContainerReader &PCHContainerRdr,
-                              StringRef Path);
+                              StringRef Path,
+                              unsigned *NumModuleFilesRead = nullptr,
+                              unsigned *NumModuleFilesReused = nullptr);
 };
 }
 
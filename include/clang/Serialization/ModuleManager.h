@@ -63,6 +63,12 @@ class ModuleManager {
   llvm::DenseMap<const FileEntry *, std::unique_ptr<llvm::MemoryBuffer>>
       InMemoryBuffers;
 
+  /// \brief The contents of module files read ahead of time by
+  /// \c prefetchModuleFiles, which \c addModule uses instead of reading the
+  /// file again.
+  llvm::DenseMap<const FileEntry *, std::unique_ptr<llvm::MemoryBuffer>>
+      PrefetchedBuffers;
+
   /// \brief The visitation order.
   SmallVector<ModuleFile *, 4> VisitOrder;
       
@@ -238,6 +244,33 @@ public:
   void addInMemoryBuffer(StringRef FileName,
                          std::unique_ptr<llvm::MemoryBuffer> Buffer);
 
+  /// \brief A module file to read ahead of time, with the expectations
+  /// \c addModule will check it against.
+  struct PrefetchedModuleFile {
+    std::string FileName;
+    ModuleKind Type;
+    off_t ExpectedSize;
+    time_t ExpectedModTime;
+  };
+
+  /// \brief Read the given module files concurrently on up to \p NumThreads
+  /// threads, so that a following sequence of \c addModule calls for them
+  /// does not have to wait for the file system.
+  ///
+  /// As in \c addModule, each file is opened and checked against its
+  /// expected size and modification time first, and is then read through
+  /// its open \c FileEntry. Files that are already loaded, that don't exist
+  /// or that are out of date are skipped; errors are left for \c addModule
+  /// to report.
+  ///
+  /// \returns the number of bytes read.
+  uint64_t prefetchModuleFiles(ArrayRef<PrefetchedModuleFile> Files,
+                               unsigned NumThreads);
+
+  /// \brief Drop the prefetched module files that were not used, since the
+  /// files may be rebuilt before they are loaded again.
+  void clearPrefetchedModuleFiles() { PrefetchedBuffers.clear(); }
+
   /// \brief Set the global module index.
   void setGlobalIndex(GlobalModuleIndex *Index);
 
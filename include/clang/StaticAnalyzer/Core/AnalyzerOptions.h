@@ -121,6 +121,25 @@ enum IPAKind {
   IPAK_DynamicDispatchBifurcate = 5
 };
 
+/// \brief Describes the order in which the exploded graph is explored.
+enum ExplorationStrategyKind {
+  ESK_NotSet = 0,
+
+  /// Explore the most recently enqueued nodes first.
+  ESK_DFS = 1,
+
+  /// Explore the nodes in the order in which they were enqueued.
+  ESK_BFS = 2,
+
+  /// Explore the CFG blocks breadth-first, and their contents depth-first.
+  ESK_BFSBlockDFSContents = 3,
+
+  /// Explore first the nodes entering the CFG blocks which were entered the
+  /// fewest times; nodes entering a block again wait behind those entering
+  /// blocks not yet explored.
+  ESK_UnexploredFirst = 4
+};
+
 class AnalyzerOptions : public RefCountedBase<AnalyzerOptions> {
 public:
   typedef llvm::StringMap<std::string> ConfigTable;
@@ -198,6 +217,9 @@ private:
   /// Controls the mode of inter-procedural analysis.
   IPAKind IPAMode;
 
+  /// Controls the order in which the exploded graph is explored.
+  ExplorationStrategyKind ExplorationStrategy;
+
   /// Controls which C++ member functions will be considered for inlining.
   CXXInlineableMemberKind CXXMemberInliningMode;
   
@@ -250,12 +272,21 @@ private:
   /// \sa getGraphTrimInterval
   Optional<unsigned> GraphTrimInterval;
 
+  /// \sa shouldReclaimGraphGenerations
+  Optional<bool> ReclaimGraphGenerations;
+
+  /// \sa shouldMergeStatesAtJoins
+  Optional<bool> MergeStatesAtJoins;
+
   /// \sa getMaxTimesInlineLarge
   Optional<unsigned> MaxTimesInlineLarge;
 
   /// \sa getMaxNodesPerTopLevelFunction
   Optional<unsigned> MaxNodesPerTopLevelFunction;
 
+  /// \sa getWorkerProcesses
+  Optional<unsigned> WorkerProcesses;
+
   /// A helper function that retrieves option for a given full-qualified
   /// checker name.
   /// Options for checkers can be specified via 'analyzer-config' command-line
@@ -361,6 +392,11 @@ public:
   /// \brief Returns the inter-procedural analysis mode.
   IPAKind getIPAMode();
 
+  /// \brief Returns the order in which the exploded graph is explored.
+  ///
+  /// This is controlled by the 'exploration_strategy' config option.
+  ExplorationStrategyKind getExplorationStrategy();
+
   /// Returns the option controlling which C++ member functions will be
   /// considered for inlining.
   ///
@@ -497,6 +533,24 @@ public:
   /// node reclamation, set the option to "0".
   unsigned getGraphTrimInterval();
 
+  /// Returns true if, whenever the ExplodedGraph has doubled in size, the
+  /// subgraphs which lead neither to a bug report nor to a node left to
+  /// explore should be freed.
+  ///
+  /// This is controlled by the 'graph-generational-reclaim' config option,
+  /// which accepts the values "true" and "false".
+  bool shouldReclaimGraphGenerations();
+
+  /// Returns true if the paths which enter a loop head for the last time the
+  /// maximum block count allows should be merged with the paths which entered
+  /// the loop, when their states differ only in the values of local scalar
+  /// variables. Those are widened to fresh symbols, so that the merged path
+  /// can still leave the loop.
+  ///
+  /// This is controlled by the 'state-merging' config option, which accepts
+  /// the values "true" and "false".
+  bool shouldMergeStatesAtJoins();
+
   /// Returns the maximum times a large function could be inlined.
   ///
   /// This is controlled by the 'max-times-inline-large' config option.
@@ -509,6 +563,15 @@ public:
   /// This is controlled by the 'max-nodes' config option.
   unsigned getMaxNodesPerTopLevelFunction();
 
+  /// Returns the number of worker processes that explore the top level
+  /// functions of the translation unit in parallel; 0 means that they are
+  /// all explored by the compiler process itself. Workers are only started
+  /// on Linux hosts, and only when the compiler process runs a single
+  /// thread.
+  ///
+  /// This is controlled by the 'worker-processes' config option.
+  unsigned getWorkerProcesses();
+
 public:
   AnalyzerOptions() :
     AnalysisStoreOpt(RegionStoreModel),
@@ -532,6 +595,7 @@ public:
     InliningMode(NoRedundancy),
     UserMode(UMK_NotSet),
     IPAMode(IPAK_NotSet),
+    ExplorationStrategy(ESK_NotSet),
     CXXMemberInliningMode() {}
 
 };
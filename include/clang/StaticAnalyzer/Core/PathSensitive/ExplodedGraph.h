@@ -285,6 +285,13 @@ protected:
   /// Counter to determine when to reclaim nodes.
   unsigned ReclaimCounter;
 
+  /// The number of nodes at which the next generation of nodes is reclaimed,
+  /// or 0 if generational reclamation is disabled.
+  unsigned NextGeneration;
+
+  /// The maximum number of nodes the graph has had at any time.
+  unsigned PeakNumNodes;
+
 public:
 
   /// \brief Retrieve the node associated with a (Location,State) pair,
@@ -385,6 +392,33 @@ public:
   /// was called.
   void reclaimRecentlyAllocatedNodes();
 
+  /// Enable reclamation of the subgraphs which are no longer needed, each time
+  /// the graph has doubled in size; see reclaimGeneration().
+  void enableGenerationalReclamation();
+
+  /// Returns true if the graph has grown enough since the last generation
+  /// was reclaimed to reclaim another one.
+  bool shouldReclaimGeneration() const {
+    return NextGeneration && NumNodes >= NextGeneration;
+  }
+
+  /// Free every node from which none of \p LiveNodes can be reached.
+  ///
+  /// The roots, the end-of-path nodes and the block entrances of the top
+  /// level stack frame are kept, without their edges, since clients use them
+  /// to find what was explored. A path which reaches a freed node again
+  /// creates it anew.
+  void reclaimGeneration(ArrayRef<const ExplodedNode *> LiveNodes);
+
+  /// Returns the maximum number of nodes the graph has had at any time.
+  unsigned getPeakNumNodes() const { return PeakNumNodes; }
+
+  /// Returns the number of bytes allocated for the nodes and their states.
+  ///
+  /// Memory is never returned to the allocator, so this is the peak memory
+  /// used by the graph; reclaimed nodes and states are recycled instead.
+  size_t getAllocatedMemory() { return getAllocator().getTotalMemory(); }
+
   /// \brief Returns true if nodes for the given expression kind are always
   ///        kept around.
   static bool isInterestingLValueExpr(const Expr *Ex);
@@ -392,6 +426,9 @@ public:
 private:
   bool shouldCollect(const ExplodedNode *node);
   void collectNode(ExplodedNode *node);
+  bool shouldKeepWithoutEdges(
+      const ExplodedNode *node,
+      const llvm::SmallPtrSetImpl<const ExplodedNode *> &EndNodeSet) const;
 };
 
 class ExplodedNodeSet {
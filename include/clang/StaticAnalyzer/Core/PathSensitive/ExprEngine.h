@@ -25,6 +25,7 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramState.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/SubEngine.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace clang {
 
@@ -96,6 +97,17 @@ private:
   /// The flag, which specifies the mode of inlining for the engine.
   InliningModes HowToInline;
 
+  /// Whether paths should be merged at loop heads.
+  /// \sa AnalyzerOptions::shouldMergeStatesAtJoins
+  bool MergeStatesAtJoins;
+
+  typedef std::pair<const CFGBlock *, const StackFrameContext *> JoinPoint;
+
+  /// The states which entered each loop head, after dead bindings were
+  /// removed. The paths entering it for the last time are merged into one of
+  /// these.
+  llvm::DenseMap<JoinPoint, SmallVector<ProgramStateRef, 4> > JoinedStates;
+
 public:
   ExprEngine(AnalysisManager &mgr, bool gcEnabled,
              SetOfConstDecls *VisitedCalleesIn,
@@ -196,6 +208,24 @@ public:
 
   void ProcessStmt(const CFGStmt S, ExplodedNode *Pred);
 
+  /// Free the subgraphs of the ExplodedGraph which lead neither to a bug
+  /// report nor to a node left to explore, \p Pred being explored now.
+  void reclaimGraphGeneration(ExplodedNode *Pred);
+
+  /// Merge the paths in \p Src, which are about to evaluate the first
+  /// statement \p S of a loop head, with the paths which entered the loop.
+  /// Only paths entering the block for the last time the maximum block count
+  /// allows are merged. Only the paths which still need exploring are put
+  /// into \p Dst.
+  void mergeStatesAtLoopHead(const Stmt *S, ExplodedNodeSet &Src,
+                             ExplodedNodeSet &Dst);
+
+  /// Returns a state which over-approximates both \p Joined and \p State,
+  /// or null if they differ in more than the values of local scalar
+  /// variables of the current stack frame.
+  ProgramStateRef joinStates(ProgramStateRef Joined, ProgramStateRef State,
+                             const Stmt *S, const LocationContext *LC);
+
   void ProcessInitializer(const CFGInitializer I, ExplodedNode *Pred);
 
   void ProcessImplicitDtor(const CFGImplicitDtor D, ExplodedNode *Pred);
@@ -20,6 +20,8 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include <deque>
+#include <memory>
+#include <vector>
 
 namespace clang {
 class Decl;
@@ -47,17 +49,102 @@ class FunctionSummariesTy {
     /// The number of times the function has been inlined.
     unsigned TimesInlined : 32;
 
+    /// True if exploring an inlined call of this function reached the maximum
+    /// block count.
+    unsigned ReachedMaxBlockCount : 1;
+
+    /// The number of blocks the function had when a previous analysis
+    /// recorded the summary below, or 0 if there is no such summary.
+    unsigned PreviousBasicBlocks : 30;
+
+    /// True if a previous analysis reached the maximum block count when
+    /// exploring an inlined call of this function.
+    unsigned PreviousReachedMaxBlockCount : 1;
+
+    /// True if a previous analysis inlined this function without ever
+    /// reaching the maximum block count.
+    unsigned PreviousCheapToInline : 1;
+
     FunctionSummary() :
       TotalBasicBlocks(0),
       InlineChecked(0),
-      TimesInlined(0) {}
+      TimesInlined(0),
+      ReachedMaxBlockCount(0),
+      PreviousBasicBlocks(0),
+      PreviousReachedMaxBlockCount(0),
+      PreviousCheapToInline(0) {}
   };
 
   typedef llvm::DenseMap<const Decl *, FunctionSummary> MapTy;
   MapTy Map;
 
+  /// A summary as it was when first read or changed since
+  /// startRecordingChanges(), and the blocks visited since.
+  struct RecordedSummary {
+    FunctionSummary Original;
+    llvm::SmallBitVector VisitedBasicBlocks;
+  };
+  typedef llvm::DenseMap<const Decl *, RecordedSummary> RecordedMapTy;
+
+  /// The summaries read or changed since startRecordingChanges(), or null if
+  /// changes are not being recorded.
+  std::unique_ptr<RecordedMapTy> Recorded;
+
+  /// Remember the summary of \p D as it is now, if changes are recorded and
+  /// it was not read or changed since recording started.
+  void recordOriginal(const Decl *D) {
+    if (!Recorded || Recorded->count(D))
+      return;
+    RecordedSummary R;
+    MapTy::const_iterator I = Map.find(D);
+    if (I != Map.end())
+      R.Original = I->second;
+    Recorded->insert(std::make_pair(D, R));
+  }
+
 public:
+  /// What was learned about a function while changes were recorded.
+  struct Change {
+    const Decl *D;
+    /// The number of times the function was inlined.
+    unsigned TimesInlined;
+    /// Whether the function has been checked against the rules for which
+    /// functions may be inlined, and whether it may be inlined. Like
+    /// \c ReachedMaxBlockCount, these describe the summary when recording
+    /// stopped, including what was learned before recording started.
+    bool InlineChecked;
+    bool MayInline;
+    /// Whether exploring an inlined call has reached the maximum block count.
+    bool ReachedMaxBlockCount;
+    /// The total number of blocks in the function, and the IDs of the blocks
+    /// that were visited.
+    unsigned TotalBasicBlocks;
+    std::vector<unsigned> VisitedBasicBlocks;
+    /// The summary as the analysis first read it. The inlining decisions of
+    /// the analysis were based on it; see isConsistentWith().
+    unsigned ReadTimesInlined;
+    bool ReadInlineChecked;
+    bool ReadMayInline;
+    bool ReadReachedMaxBlockCount;
+  };
+
+  /// Start recording the changes to the summaries.
+  void startRecordingChanges() { Recorded.reset(new RecordedMapTy()); }
+
+  /// Stop recording the changes to the summaries, and return them.
+  std::vector<Change> takeChanges();
+
+  /// Merge a change that was recorded by the summaries of another
+  /// analysis of the same translation unit.
+  void mergeChange(const Change &C);
+
+  /// Returns true if the other analysis which recorded \p C would have made
+  /// the same inlining decisions about its function with this summary as
+  /// with the one it read.
+  bool isConsistentWith(const Change &C, unsigned MaxTimesInlineLarge);
+
   MapTy::iterator findOrInsertSummary(const Decl *D) {
+    recordOriginal(D);
     MapTy::iterator I = Map.find(D);
     if (I != Map.end())
       return I;
@@ -82,9 +169,43 @@ public:
 
   void markReachedMaxBlockCount(const Decl *D) {
     markShouldNotInline(D);
+    Map[D].ReachedMaxBlockCount = 1;
+  }
+
+  bool hasReachedMaxBlockCount(const Decl *D) {
+    recordOriginal(D);
+    MapTy::const_iterator I = Map.find(D);
+    return I != Map.end() && I->second.ReachedMaxBlockCount;
+  }
+
+  /// Record what a previous analysis learned about inlining \p D, when its
+  /// CFG had \p NumBlocks blocks.
+  void setPreviousSummary(const Decl *D, unsigned NumBlocks,
+                          bool ReachedMaxBlockCount, bool CheapToInline) {
+    MapTy::iterator I = findOrInsertSummary(D);
+    I->second.PreviousBasicBlocks = NumBlocks;
+    I->second.PreviousReachedMaxBlockCount = ReachedMaxBlockCount;
+    I->second.PreviousCheapToInline = CheapToInline;
+  }
+
+  /// Returns true if a previous analysis reached the maximum block count when
+  /// inlining \p D, and the CFG of \p D still has \p NumBlocks blocks.
+  bool previouslyReachedMaxBlockCount(const Decl *D, unsigned NumBlocks) {
+    MapTy::const_iterator I = Map.find(D);
+    return I != Map.end() && I->second.PreviousBasicBlocks == NumBlocks &&
+           I->second.PreviousReachedMaxBlockCount;
+  }
+
+  /// Returns true if a previous analysis inlined \p D without reaching the
+  /// maximum block count, and the CFG of \p D still has \p NumBlocks blocks.
+  bool previouslyCheapToInline(const Decl *D, unsigned NumBlocks) {
+    MapTy::const_iterator I = Map.find(D);
+    return I != Map.end() && I->second.PreviousBasicBlocks == NumBlocks &&
+           I->second.PreviousCheapToInline;
   }
 
   Optional<bool> mayInline(const Decl *D) {
+    recordOriginal(D);
     MapTy::const_iterator I = Map.find(D);
     if (I != Map.end() && I->second.InlineChecked)
       return I->second.MayInline;
@@ -100,6 +221,13 @@ public:
       I->second.TotalBasicBlocks = TotalIDs;
     }
     Blocks.set(ID);
+
+    if (Recorded) {
+      llvm::SmallBitVector &RecordedBlocks = (*Recorded)[D].VisitedBasicBlocks;
+      if (TotalIDs > RecordedBlocks.size())
+        RecordedBlocks.resize(TotalIDs);
+      RecordedBlocks.set(ID);
+    }
   }
 
   unsigned getNumVisitedBasicBlocks(const Decl* D) {
@@ -109,7 +237,15 @@ public:
     return 0;
   }
 
+  unsigned getNumBasicBlocks(const Decl* D) {
+    MapTy::const_iterator I = Map.find(D);
+    if (I != Map.end())
+      return I->second.TotalBasicBlocks;
+    return 0;
+  }
+
   unsigned getNumTimesInlined(const Decl* D) {
+    recordOriginal(D);
     MapTy::const_iterator I = Map.find(D);
     if (I != Map.end())
       return I->second.TimesInlined;
@@ -57,6 +57,7 @@ namespace tooling {
 ///   CommonOptionsParser OptionsParser(argc, argv, MyToolCategory);
 ///   ClangTool Tool(OptionsParser.getCompilations(),
 ///                  OptionsParser.getSourcePathListi());
+///   Tool.setNumThreads(OptionsParser.getNumThreads());
 ///   return Tool.run(newFrontendActionFactory<clang::SyntaxOnlyAction>());
 /// }
 /// \endcode
@@ -84,11 +85,18 @@ public:
     return SourcePathList;
   }
 
+  /// Returns the number of translation units to process concurrently, as
+  /// given by -j. Pass it on to \c ClangTool::setNumThreads.
+  unsigned getNumThreads() const {
+    return NumThreads;
+  }
+
   static const char *const HelpMessage;
 
 private:
   std::unique_ptr<CompilationDatabase> Compilations;
   std::vector<std::string> SourcePathList;
+  unsigned NumThreads;
   std::vector<std::string> ExtraArgsBefore;
   std::vector<std::string> ExtraArgsAfter;
 };
@@ -40,6 +40,7 @@
 #include "clang/Lex/ModuleLoader.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Option/Option.h"
@@ -312,6 +313,17 @@ class ClangTool {
   /// \brief Clear the command line arguments adjuster chain.
   void clearArgumentsAdjusters();
 
+  /// \brief Set the number of translation units processed concurrently.
+  ///
+  /// With more than one thread, all compile commands are looked up before any
+  /// of them runs, every command gets its own \c FileManager and
+  /// \c CompilerInstance, and the process working directory is left alone.
+  /// The \c ToolAction, and the \c DiagnosticConsumer if one is set, must be
+  /// safe to use from several threads; calls into the consumer are
+  /// serialized. Diagnostics printed by the default consumer are buffered per
+  /// compile command and emitted in input order.
+  void setNumThreads(unsigned N) { NumThreads = N ? N : 1; }
+
   /// Runs an action over all files specified in the command line.
   ///
   /// \param Action Tool action.
@@ -319,6 +331,9 @@ class ClangTool {
 
   /// \brief Create an AST for each file specified in the command line and
   /// append them to ASTs.
+  ///
+  /// The ASTs are appended in input order, also when running on several
+  /// threads.
   int buildASTs(std::vector<std::unique_ptr<ASTUnit>> &ASTs);
 
   /// \brief Returns the file manager used in the tool.
@@ -338,6 +353,21 @@ class ClangTool {
   ArgumentsAdjuster ArgsAdjuster;
 
   DiagnosticConsumer *DiagConsumer;
+
+  unsigned NumThreads;
+
+  /// \brief A source file paired with one of its adjusted compile commands.
+  typedef std::pair<std::string, CompileCommand> FileCommand;
+
+  /// \brief Looks up and adjusts the compile commands of all source paths.
+  std::vector<FileCommand> collectFileCommands(StringRef MainExecutable);
+
+  /// \brief Runs every command in \p Commands on a pool of \c NumThreads
+  /// workers, using the action returned by \p ActionForCommand for the
+  /// command with the given index.
+  int runConcurrently(ArrayRef<FileCommand> Commands,
+                      llvm::function_ref<ToolAction *(unsigned)>
+                          ActionForCommand);
 };
 
 template <typename T>
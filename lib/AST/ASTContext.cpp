@@ -18,6 +18,7 @@
 #include "clang/AST/CharUnits.h"
 #include "clang/AST/Comment.h"
 #include "clang/AST/CommentCommandTraits.h"
+#include "clang/AST/ConstexprCallCache.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
 #include "clang/AST/DeclTemplate.h"
@@ -745,7 +746,10 @@ ASTContext::ASTContext(LangOptions &LOpts, SourceManager &SM,
       Idents(idents), Selectors(sels), BuiltinInfo(builtins),
       DeclarationNames(*this), ExternalSource(nullptr), Listener(nullptr),
       Comments(SM), CommentsLoaded(false),
-      CommentCommandTraits(BumpAlloc, LOpts.CommentOpts), LastSDM(nullptr, 0) {
+      CommentCommandTraits(BumpAlloc, LOpts.CommentOpts), LastSDM(nullptr, 0),
+      NumDeclsCreated(0), NumDeclsDeserialized(0),
+      NumRecordDefinitionsCompleted(0), NumFileContextChanges(0),
+      Costs(nullptr), ConstexprProf(nullptr) {
   TUDecl = TranslationUnitDecl::Create(*this);
 }
 
@@ -798,6 +802,12 @@ void ASTContext::ReleaseParentMapEntries() {
   }
 }
 
+ConstexprCallCache &ASTContext::getConstexprCallCache() const {
+  if (!ConstexprCalls)
+    ConstexprCalls.reset(new ConstexprCallCache());
+  return *ConstexprCalls;
+}
+
 void ASTContext::AddDeallocation(void (*Callback)(void*), void *Data) {
   Deallocations[Callback].push_back(Data);
 }
@@ -835,6 +845,10 @@ void ASTContext::PrintStats() const {
 #include "clang/AST/TypeNodes.def"
 
   llvm::errs() << "Total bytes = " << TotalBytes << "\n";
+  llvm::errs() << "  " << NumDeclsCreated << " decls created, "
+               << NumDeclsDeserialized << " deserialized.\n";
+  if (ConstexprCalls)
+    ConstexprCalls->PrintStats();
 
   // Implicit special member functions.
   llvm::errs() << NumImplicitDefaultConstructorsDeclared << "/"
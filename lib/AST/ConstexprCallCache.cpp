@@ -0,0 +1,130 @@
+//===--- ConstexprCallCache.cpp - Memoized constexpr calls ----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the ConstexprCallCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/ConstexprCallCache.h"
+#include "clang/AST/Decl.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace clang;
+
+/// \brief Add \p Value to \p ID, or return false if it refers to an object
+/// rather than being a plain value.
+static bool profileValue(const APValue &Value, llvm::FoldingSetNodeID &ID) {
+  ID.AddInteger(Value.getKind());
+  switch (Value.getKind()) {
+  case APValue::Uninitialized:
+    return true;
+
+  case APValue::Int:
+    Value.getInt().Profile(ID);
+    return true;
+
+  case APValue::Float:
+    Value.getFloat().Profile(ID);
+    return true;
+
+  case APValue::ComplexInt:
+    Value.getComplexIntReal().Profile(ID);
+    Value.getComplexIntImag().Profile(ID);
+    return true;
+
+  case APValue::ComplexFloat:
+    Value.getComplexFloatReal().Profile(ID);
+    Value.getComplexFloatImag().Profile(ID);
+    return true;
+
+  case APValue::Vector:
+    ID.AddInteger(Value.getVectorLength());
+    for (unsigned I = 0, N = Value.getVectorLength(); I != N; ++I)
+      if (!profileValue(Value.getVectorElt(I), ID))
+        return false;
+    return true;
+
+  case APValue::Array:
+    ID.AddInteger(Value.getArraySize());
+    ID.AddInteger(Value.getArrayInitializedElts());
+    for (unsigned I = 0, N = Value.getArrayInitializedElts(); I != N; ++I)
+      if (!profileValue(Value.getArrayInitializedElt(I), ID))
+        return false;
+    ID.AddBoolean(Value.hasArrayFiller());
+    return !Value.hasArrayFiller() || profileValue(Value.getArrayFiller(), ID);
+
+  case APValue::Struct:
+    ID.AddInteger(Value.getStructNumBases());
+    ID.AddInteger(Value.getStructNumFields());
+    for (unsigned I = 0, N = Value.getStructNumBases(); I != N; ++I)
+      if (!profileValue(Value.getStructBase(I), ID))
+        return false;
+    for (unsigned I = 0, N = Value.getStructNumFields(); I != N; ++I)
+      if (!profileValue(Value.getStructField(I), ID))
+        return false;
+    return true;
+
+  case APValue::Union:
+    ID.AddPointer(Value.getUnionField());
+    return !Value.getUnionField() || profileValue(Value.getUnionValue(), ID);
+
+  case APValue::LValue:
+  case APValue::MemberPointer:
+  case APValue::AddrLabelDiff:
+    // These refer to objects, whose values are not part of the key.
+    return false;
+  }
+  llvm_unreachable("Unknown APValue kind");
+}
+
+bool ConstexprCallCache::isMemoizableValue(const APValue &Value) {
+  llvm::FoldingSetNodeID ID;
+  return profileValue(Value, ID);
+}
+
+bool ConstexprCallCache::profileCall(const FunctionDecl *Callee,
+                                     ArrayRef<APValue> Args,
+                                     llvm::FoldingSetNodeID &ID) {
+  ID.AddPointer(Callee->getCanonicalDecl());
+  ID.AddInteger(Args.size());
+  for (const APValue &Arg : Args)
+    if (!profileValue(Arg, ID))
+      return false;
+  return true;
+}
+
+const APValue *ConstexprCallCache::lookup(const llvm::FoldingSetNodeID &ID,
+                                          unsigned MaxSteps, unsigned MaxDepth,
+                                          unsigned &Steps, unsigned &Depth) {
+  void *InsertPos;
+  Entry *E = Entries.FindNodeOrInsertPos(ID, InsertPos);
+  if (E && E->Steps <= MaxSteps && E->Depth <= MaxDepth) {
+    ++NumHits;
+    Steps = E->Steps;
+    Depth = E->Depth;
+    return &E->Result;
+  }
+  ++NumMisses;
+  return nullptr;
+}
+
+void ConstexprCallCache::insert(const llvm::FoldingSetNodeID &ID,
+                                const APValue &Result, unsigned Steps,
+                                unsigned Depth) {
+  void *InsertPos;
+  if (Entries.FindNodeOrInsertPos(ID, InsertPos))
+    return;
+  Entries.InsertNode(new (Allocator.Allocate())
+                         Entry(ID, Result, Steps, Depth), InsertPos);
+}
+
+void ConstexprCallCache::PrintStats() const {
+  llvm::errs() << "  " << Entries.size() << " constexpr call results memoized, "
+               << NumHits << " reused, " << NumMisses << " evaluated.\n";
+}
@@ -0,0 +1,66 @@
+//===--- ConstexprProfile.cpp - Constexpr evaluation per function ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the ConstexprProfile class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/ConstexprProfile.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/PrettyPrinter.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+using namespace clang;
+
+void ConstexprProfile::addCall(const FunctionDecl *Callee, uint64_t Steps) {
+  FunctionCounts &Counts = Functions[Callee->getCanonicalDecl()];
+  Counts.Steps += Steps;
+  ++Counts.Calls;
+}
+
+void ConstexprProfile::addReusedCall(const FunctionDecl *Callee) {
+  FunctionCounts &Counts = Functions[Callee->getCanonicalDecl()];
+  ++Counts.Calls;
+  ++Counts.ReusedCalls;
+}
+
+void ConstexprProfile::print(raw_ostream &OS,
+                             const PrintingPolicy &Policy) const {
+  typedef std::pair<std::string, FunctionCounts> Row;
+  std::vector<Row> Rows;
+  uint64_t TotalSteps = 0;
+  for (const auto &Function : Functions) {
+    std::string Name;
+    llvm::raw_string_ostream NameOS(Name);
+    Function.first->getNameForDiagnostic(NameOS, Policy, /*Qualified=*/true);
+    Rows.push_back(Row(NameOS.str(), Function.second));
+    TotalSteps += Function.second.Steps;
+  }
+
+  // Sort by steps, breaking ties by name so that the output is stable.
+  std::sort(Rows.begin(), Rows.end(), [](const Row &A, const Row &B) {
+    if (A.second.Steps != B.second.Steps)
+      return A.second.Steps > B.second.Steps;
+    return A.first < B.first;
+  });
+
+  OS << "\n*** Constexpr Evaluation Profile:\n";
+  OS << "  " << TotalSteps << " steps in " << Rows.size() << " functions.\n";
+  OS << llvm::format("%12s %10s %10s  %s\n", "Steps", "Calls", "Reused",
+                     "Function");
+  for (const Row &R : Rows)
+    OS << llvm::format("%12llu %10llu %10llu  ",
+                       (unsigned long long)R.second.Steps,
+                       (unsigned long long)R.second.Calls,
+                       (unsigned long long)R.second.ReusedCalls)
+       << R.first << "\n";
+}
@@ -3638,6 +3638,12 @@ RecordDecl::field_iterator RecordDecl::field_begin() const {
 void RecordDecl::completeDefinition() {
   assert(!isCompleteDefinition() && "Cannot redefine record!");
   TagDecl::completeDefinition();
+  // Instantiations are not counted: whoever needs one complete instantiates
+  // it, so it cannot have been seen incomplete while it was instantiable.
+  const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(this);
+  if (!CXXRD ||
+      !isTemplateInstantiation(CXXRD->getTemplateSpecializationKind()))
+    ++getASTContext().NumRecordDefinitionsCompleted;
 }
 
 /// isMsStruct - Get whether or not this record uses ms_struct layout.
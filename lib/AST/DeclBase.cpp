@@ -69,12 +69,16 @@ void *Decl::operator new(std::size_t Size, const ASTContext &Context,
   // Store the global declaration ID in the second 4 bytes.
   PrefixPtr[1] = ID;
 
+  ++Context.NumDeclsCreated;
+  ++Context.NumDeclsDeserialized;
+
   return Result;
 }
 
 void *Decl::operator new(std::size_t Size, const ASTContext &Ctx,
                          DeclContext *Parent, std::size_t Extra) {
   assert(!Parent || &Parent->getParentASTContext() == &Ctx);
+  ++Ctx.NumDeclsCreated;
   // With local visibility enabled, we track the owning module even for local
   // declarations.
   if (Ctx.getLangOpts().ModulesLocalVisibility) {
@@ -1197,6 +1201,8 @@ void DeclContext::removeDecl(Decl *D) {
   // Mark that D is no longer in the decl chain.
   D->NextInContextAndBits.setPointer(nullptr);
 
+  noteFileContextChange();
+
   // Remove D from the lookup table if necessary.
   if (isa<NamedDecl>(D)) {
     NamedDecl *ND = cast<NamedDecl>(D);
@@ -1227,6 +1233,8 @@ void DeclContext::addHiddenDecl(Decl *D) {
     FirstDecl = LastDecl = D;
   }
 
+  noteFileContextChange();
+
   // Notify a C++ record declaration that we've added a member, so it can
   // update it's class-specific state.
   if (CXXRecordDecl *Record = dyn_cast<CXXRecordDecl>(this))
@@ -1543,6 +1551,8 @@ void DeclContext::makeDeclVisibleInContextWithFlags(NamedDecl *D, bool Internal,
   if (shouldBeHidden(D))
     return;
 
+  noteFileContextChange();
+
   // If we already have a lookup data structure, perform the insertion into
   // it. If we might have externally-stored decls with this name, look them
   // up and perform the insertion. If this decl was declared outside its
@@ -1577,6 +1587,11 @@ void DeclContext::makeDeclVisibleInContextWithFlags(NamedDecl *D, bool Internal,
       L->AddedVisibleDecl(this, D);
 }
 
+void DeclContext::noteFileContextChange() const {
+  if (getRedeclContext()->isFileContext())
+    ++getParentASTContext().NumFileContextChanges;
+}
+
 void DeclContext::makeDeclVisibleInContextImpl(NamedDecl *D, bool Internal) {
   // Find or create the stored declaration map.
   StoredDeclsMap *Map = LookupPtr;
@@ -37,11 +37,14 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTDiagnostic.h"
 #include "clang/AST/CharUnits.h"
+#include "clang/AST/ConstexprCallCache.h"
+#include "clang/AST/ConstexprProfile.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/AST/StmtVisitor.h"
 #include "clang/AST/TypeLoc.h"
 #include "clang/Basic/Builtins.h"
+#include "clang/Basic/CostReport.h"
 #include "clang/Basic/TargetInfo.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/raw_ostream.h"
@@ -314,6 +317,10 @@ namespace {
     /// Temporaries - Temporary lvalues materialized within this stack frame.
     MapTy Temporaries;
 
+    /// Steps - The number of evaluation steps performed by this call, not
+    /// counting the calls it made.
+    uint64_t Steps;
+
     CallStackFrame(EvalInfo &Info, SourceLocation CallLoc,
                    const FunctionDecl *Callee, const LValue *This,
                    APValue *Arguments);
@@ -426,6 +433,11 @@ namespace {
     /// CallStackDepth - The number of calls in the call stack right now.
     unsigned CallStackDepth;
 
+    /// DeepestCallCheck - The largest call stack depth at which a call was
+    /// checked against the depth limit, either by evaluating the call or by
+    /// reusing a memoized result.
+    unsigned DeepestCallCheck;
+
     /// NextCallIndex - The next call index to assign.
     unsigned NextCallIndex;
 
@@ -507,9 +519,26 @@ namespace {
     // in such constructs, not just overflow.
     bool checkingForOverflow() { return EvalMode == EM_EvaluateForOverflow; }
 
+    /// Can the results of constexpr function calls be taken from, and added
+    /// to, the constexpr call cache? Potential constant expressions have no
+    /// argument values, and overflow checking must see every operation.
+    bool canMemoizeCalls() const {
+      return getLangOpts().MemoizeConstexprCalls &&
+             !checkingPotentialConstantExpression() &&
+             EvalMode != EM_EvaluateForOverflow;
+    }
+
+    /// Has this evaluation so far produced neither a diagnostic nor a side
+    /// effect? A call evaluated while this holds, and after which it still
+    /// holds, is a constant expression in every evaluation mode.
+    bool isCleanEvaluation() const {
+      return EvalStatus.Diag && EvalStatus.Diag->empty() &&
+             !EvalStatus.HasSideEffects;
+    }
+
     EvalInfo(const ASTContext &C, Expr::EvalStatus &S, EvaluationMode Mode)
       : Ctx(const_cast<ASTContext &>(C)), EvalStatus(S), CurrentCall(nullptr),
-        CallStackDepth(0), NextCallIndex(1),
+        CallStackDepth(0), DeepestCallCheck(0), NextCallIndex(1),
         StepsLeft(getLangOpts().ConstexprStepLimit),
         BottomFrame(*this, SourceLocation(), nullptr, nullptr, nullptr),
         EvaluatingDecl((const ValueDecl *)nullptr),
@@ -533,6 +562,7 @@ namespace {
         Diag(Loc, diag::note_constexpr_call_limit_exceeded);
         return false;
       }
+      DeepestCallCheck = std::max(DeepestCallCheck, CallStackDepth);
       if (CallStackDepth <= getLangOpts().ConstexprCallDepth)
         return true;
       Diag(Loc, diag::note_constexpr_depth_limit_exceeded)
@@ -556,6 +586,7 @@ namespace {
         return false;
       }
       --StepsLeft;
+      ++CurrentCall->Steps;
       return true;
     }
 
@@ -822,13 +853,30 @@ CallStackFrame::CallStackFrame(EvalInfo &Info, SourceLocation CallLoc,
                                const FunctionDecl *Callee, const LValue *This,
                                APValue *Arguments)
     : Info(Info), Caller(Info.CurrentCall), CallLoc(CallLoc), Callee(Callee),
-      Index(Info.NextCallIndex++), This(This), Arguments(Arguments) {
+      Index(Info.NextCallIndex++), This(This), Arguments(Arguments),
+      Steps(0) {
   Info.CurrentCall = this;
   ++Info.CallStackDepth;
+
+  if (Callee) {
+    if (CostReport *Costs = Info.Ctx.getCostReport()) {
+      std::string Name;
+      llvm::raw_string_ostream OS(Name);
+      Callee->getNameForDiagnostic(OS, Info.Ctx.getPrintingPolicy(),
+                                   /*Qualified=*/true);
+      Costs->enter(CostReport::ConstexprCall, OS.str());
+    }
+  }
 }
 
 CallStackFrame::~CallStackFrame() {
   assert(Info.CurrentCall == this && "calls retired out of order");
+  if (Callee && Info.Ctx.getCostReport())
+    Info.Ctx.getCostReport()->exit(CostReport::ConstexprCall);
+  // Checking whether a function could be constexpr is not an evaluation.
+  if (Callee && Info.Ctx.getConstexprProfile() &&
+      !Info.checkingPotentialConstantExpression())
+    Info.Ctx.getConstexprProfile()->addCall(Callee, Steps);
   --Info.CallStackDepth;
   Info.CurrentCall = Caller;
 }
@@ -3715,6 +3763,45 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!EvaluateArgs(Args, ArgValues, Info))
     return false;
 
+  // A call with no implicit object argument whose arguments are plain values
+  // always produces the same value, so reuse the result of an earlier call
+  // with the same arguments if there was one.
+  llvm::FoldingSetNodeID CallID;
+  bool Memoizable = !This && Info.canMemoizeCalls() &&
+                    ConstexprCallCache::profileCall(Callee, ArgValues, CallID);
+  // The reused call is charged the steps and the call depth its evaluation
+  // took, so the limits are reached at the same point as without the cache.
+  // A call which would not fit within them is evaluated to diagnose it.
+  unsigned DepthLimit = Info.getLangOpts().ConstexprCallDepth;
+  if (Memoizable && Info.CallStackDepth <= DepthLimit) {
+    ConstexprCallCache &Cache = Info.Ctx.getConstexprCallCache();
+    unsigned Steps, Depth;
+    if (const APValue *Known =
+            Cache.lookup(CallID, Info.StepsLeft,
+                         DepthLimit - Info.CallStackDepth, Steps, Depth)) {
+      if (ConstexprProfile *Profile = Info.Ctx.getConstexprProfile())
+        Profile->addReusedCall(Callee);
+      Info.StepsLeft -= Steps;
+      Info.DeepestCallCheck =
+          std::max(Info.DeepestCallCheck, Info.CallStackDepth + Depth);
+      Result = *Known;
+      return true;
+    }
+  }
+  bool WasClean = Info.isCleanEvaluation();
+  unsigned StepsBefore = Info.StepsLeft;
+  unsigned DepthBefore = Info.CallStackDepth;
+  unsigned DeepestBefore = Info.DeepestCallCheck;
+  Info.DeepestCallCheck = 0;
+  // Restores the deepest check of the caller, including those of this call.
+  struct RestoreDeepestCallCheck {
+    EvalInfo &Info;
+    unsigned Deepest;
+    ~RestoreDeepestCallCheck() {
+      Info.DeepestCallCheck = std::max(Info.DeepestCallCheck, Deepest);
+    }
+  } RestoreDeepest = { Info, DeepestBefore };
+
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
@@ -3751,7 +3838,17 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
       return true;
     Info.Diag(Callee->getLocEnd(), diag::note_constexpr_no_return);
   }
-  return ESR == ESR_Returned;
+  if (ESR != ESR_Returned)
+    return false;
+
+  // Only memoize results that did not rely on anything the current
+  // evaluation mode tolerates but a stricter one would not.
+  if (Memoizable && WasClean && Info.isCleanEvaluation() &&
+      ConstexprCallCache::isMemoizableValue(Result))
+    Info.Ctx.getConstexprCallCache().insert(
+        CallID, Result, StepsBefore - Info.StepsLeft,
+        Info.DeepestCallCheck - DepthBefore);
+  return true;
 }
 
 /// Evaluate a constructor call.
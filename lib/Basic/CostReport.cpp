@@ -0,0 +1,138 @@
+//===--- CostReport.cpp - Compile time per header and template ------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the CostReport class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/CostReport.h"
+#include "clang/Basic/JsonSupport.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <vector>
+
+using namespace clang;
+
+CostReport::CostReport() : Start(llvm::sys::TimeValue::now()) {}
+
+double CostReport::now() const {
+  llvm::sys::TimeValue Elapsed = llvm::sys::TimeValue::now() - Start;
+  return Elapsed.seconds() + Elapsed.nanoseconds() / 1e9;
+}
+
+StringRef CostReport::getKindName(EntityKind Kind) {
+  switch (Kind) {
+  case Header: return "headers";
+  case TemplateInstantiation: return "templates";
+  case ConstexprCall: return "constexpr";
+  case NumEntityKinds: break;
+  }
+  llvm_unreachable("Invalid entity kind");
+}
+
+void CostReport::enter(EntityKind Kind, StringRef Name) {
+  KindData &K = Kinds[Kind];
+  double Now = now();
+  if (!K.Stack.empty())
+    K.Stack.back()->SelfTime += Now - K.LastSwitch;
+  K.LastSwitch = Now;
+
+  Entity &E = K.Entities[Name];
+  ++E.Count;
+  if (E.Active++ == 0)
+    E.OutermostStart = Now;
+  K.Stack.push_back(&E);
+}
+
+void CostReport::exit(EntityKind Kind) {
+  KindData &K = Kinds[Kind];
+  assert(!K.Stack.empty() && "Unbalanced exit from an entity");
+  double Now = now();
+  Entity *E = K.Stack.pop_back_val();
+  E->SelfTime += Now - K.LastSwitch;
+  K.LastSwitch = Now;
+  if (--E->Active == 0)
+    E->TotalTime += Now - E->OutermostStart;
+}
+
+void CostReport::exitAll() {
+  for (unsigned I = 0; I != NumEntityKinds; ++I)
+    while (!Kinds[I].Stack.empty())
+      exit(static_cast<EntityKind>(I));
+}
+
+void CostReport::reset() {
+  for (KindData &K : Kinds) {
+    K.Entities.clear();
+    K.Stack.clear();
+    K.LastSwitch = 0;
+  }
+  Start = llvm::sys::TimeValue::now();
+}
+
+bool CostReport::writeJSON(StringRef Path, StringRef InputFile, unsigned Limit,
+                           std::string &ErrorMsg) const {
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::F_Text);
+  if (EC) {
+    ErrorMsg = EC.message();
+    return true;
+  }
+
+  // Rank the entities by total time, breaking ties by name so that the
+  // report is deterministic.
+  typedef llvm::StringMapEntry<Entity> EntryType;
+  std::vector<const EntryType *> Ranked[NumEntityKinds];
+  bool Truncated = false;
+  for (unsigned I = 0; I != NumEntityKinds; ++I) {
+    for (const EntryType &Entry : Kinds[I].Entities)
+      Ranked[I].push_back(&Entry);
+    std::sort(Ranked[I].begin(), Ranked[I].end(),
+              [](const EntryType *A, const EntryType *B) {
+      if (A->second.TotalTime != B->second.TotalTime)
+        return A->second.TotalTime > B->second.TotalTime;
+      return A->first() < B->first();
+    });
+    if (Limit && Ranked[I].size() > Limit) {
+      Ranked[I].resize(Limit);
+      Truncated = true;
+    }
+  }
+
+  OS << "{\n";
+  OS << "  \"file\": ";
+  printJSONString(OS, InputFile);
+  // Mark a truncated report, whose entries cannot be merged exactly.
+  if (Truncated)
+    OS << ",\n  \"truncated\": true";
+  for (unsigned I = 0; I != NumEntityKinds; ++I) {
+    OS << ",\n  \"" << getKindName(static_cast<EntityKind>(I)) << "\": [";
+    for (unsigned J = 0, N = Ranked[I].size(); J != N; ++J) {
+      const Entity &E = Ranked[I][J]->second;
+      OS << (J ? ",\n" : "\n") << "    { \"name\": ";
+      printJSONString(OS, Ranked[I][J]->first());
+      OS << ", \"self\": " << llvm::format("%.6f", E.SelfTime)
+         << ", \"total\": " << llvm::format("%.6f", E.TotalTime)
+         << ", \"count\": " << E.Count << " }";
+    }
+    OS << (Ranked[I].empty() ? "]" : "\n  ]");
+  }
+  OS << "\n}\n";
+
+  OS.close();
+  if (OS.has_error()) {
+    ErrorMsg = "could not write file";
+    OS.clear_error();
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,53 @@
+//===--- JsonSupport.cpp - Writing JSON output ----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/JsonSupport.h"
+#include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+void clang::printJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  const UTF8 *Ptr = reinterpret_cast<const UTF8 *>(Str.begin());
+  const UTF8 *End = reinterpret_cast<const UTF8 *>(Str.end());
+  while (Ptr != End) {
+    unsigned char C = *Ptr;
+    if (C >= 0x80) {
+      unsigned Len = getNumBytesForUTF8(C);
+      if (Len <= unsigned(End - Ptr) && isLegalUTF8Sequence(Ptr, Ptr + Len)) {
+        OS.write(reinterpret_cast<const char *>(Ptr), Len);
+        Ptr += Len;
+      } else {
+        OS << "\\ufffd";
+        ++Ptr;
+      }
+      continue;
+    }
+
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\b': OS << "\\b"; break;
+    case '\f': OS << "\\f"; break;
+    case '\n': OS << "\\n"; break;
+    case '\r': OS << "\\r"; break;
+    case '\t': OS << "\\t"; break;
+    default:
+      if (C < 0x20)
+        OS << "\\u" << llvm::format("%04x", C);
+      else
+        OS << C;
+      break;
+    }
+    ++Ptr;
+  }
+  OS << '"';
+}
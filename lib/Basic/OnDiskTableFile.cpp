@@ -0,0 +1,97 @@
+//===--- OnDiskTableFile.cpp - Files holding an on-disk hash table --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements reading and writing of on-disk table files.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/OnDiskTableFile.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+std::unique_ptr<llvm::MemoryBuffer>
+clang::mapOnDiskTableFile(StringRef Path, StringRef Magic, uint32_t Version,
+                          uint32_t &BucketOffset) {
+  assert(Magic.size() == 4 && "Magic number must have four bytes");
+
+  // The buffer is never written to, so the file can be mapped even while
+  // other processes use it.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> BufferOrErr =
+      llvm::MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
+    return nullptr;
+  std::unique_ptr<llvm::MemoryBuffer> Buffer = std::move(*BufferOrErr);
+  if (Buffer->getBufferSize() <= OnDiskTableFileHeaderSize ||
+      !Buffer->getBuffer().startswith(Magic))
+    return nullptr;
+
+  using namespace llvm::support;
+  const unsigned char *D =
+      (const unsigned char *)Buffer->getBufferStart() + Magic.size();
+  uint32_t FileVersion = endian::readNext<uint32_t, little, unaligned>(D);
+  BucketOffset = endian::readNext<uint32_t, little, unaligned>(D);
+  if (FileVersion != Version || BucketOffset < OnDiskTableFileHeaderSize ||
+      BucketOffset >= Buffer->getBufferSize())
+    return nullptr;
+  return Buffer;
+}
+
+bool clang::writeOnDiskTableFile(
+    StringRef Path, StringRef Magic, uint32_t Version,
+    llvm::function_ref<uint32_t(raw_ostream &)> EmitTable,
+    std::string &ErrorMsg) {
+  assert(Magic.size() == 4 && "Magic number must have four bytes");
+
+  SmallString<4096> Contents;
+  {
+    using namespace llvm::support;
+    llvm::raw_svector_ostream Out(Contents);
+    endian::Writer<little> LE(Out);
+    Out << Magic;
+    LE.write<uint32_t>(Version);
+    // Placeholder for the bucket offset.
+    LE.write<uint32_t>(0);
+    uint32_t BucketOffset = EmitTable(Out);
+    Out.flush();
+    char *BucketOffsetPtr = Contents.data() + 8;
+    endian::write<uint32_t, little, unaligned>(BucketOffsetPtr, BucketOffset);
+  }
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // readers either see the old or the new file.
+  SmallString<128> TmpPath;
+  int TmpFD;
+  if (std::error_code EC = llvm::sys::fs::createUniqueFile(
+          Path + "-%%%%%%%%", TmpFD, TmpPath)) {
+    ErrorMsg = EC.message();
+    return true;
+  }
+  {
+    llvm::raw_fd_ostream Out(TmpFD, /*shouldClose=*/true);
+    Out.write(Contents.data(), Contents.size());
+    Out.close();
+    if (Out.has_error()) {
+      ErrorMsg = "could not write temporary file";
+      Out.clear_error();
+      llvm::sys::fs::remove(TmpPath);
+      return true;
+    }
+  }
+  if (std::error_code EC = llvm::sys::fs::rename(TmpPath, Path)) {
+    ErrorMsg = EC.message();
+    llvm::sys::fs::remove(TmpPath);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,231 @@
+//===--- PersistentStatCache.cpp - On-disk cache of 'stat' calls ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the PersistentStatCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/PersistentStatCache.h"
+#include "clang/Basic/OnDiskTableFile.h"
+#include "clang/Basic/VirtualFileSystem.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/OnDiskHashTable.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <ctime>
+
+using namespace clang;
+
+/// \brief The magic number at the start of a stat cache file.
+static const char StatCacheMagic[] = "CSTC";
+
+/// \brief The version of the stat cache format. Bump this whenever the
+/// format changes; files of other versions are ignored.
+static const unsigned StatCacheVersion = 1;
+
+/// \brief Size of the data stored for each path.
+static const unsigned StatCacheDataSize = 1 + 8 + 8 + 8;
+
+namespace {
+class PersistentStatCacheTrait {
+public:
+  typedef StringRef external_key_type;
+  typedef StringRef internal_key_type;
+  typedef PersistentStatCache::DirectoryState data_type;
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+
+  static bool EqualKey(const internal_key_type &a, const internal_key_type &b) {
+    return a == b;
+  }
+
+  static hash_value_type ComputeHash(const internal_key_type &a) {
+    return llvm::HashString(a);
+  }
+
+  static const internal_key_type &
+  GetInternalKey(const external_key_type &x) { return x; }
+
+  static const external_key_type &
+  GetExternalKey(const internal_key_type &x) { return x; }
+
+  static std::pair<unsigned, unsigned>
+  ReadKeyDataLength(const unsigned char *&d) {
+    using namespace llvm::support;
+    unsigned KeyLen = endian::readNext<uint16_t, little, unaligned>(d);
+    unsigned DataLen = endian::readNext<uint16_t, little, unaligned>(d);
+    return std::make_pair(KeyLen, DataLen);
+  }
+
+  static internal_key_type ReadKey(const unsigned char *d, unsigned n) {
+    return StringRef((const char *)d, n);
+  }
+
+  static data_type ReadData(const internal_key_type &k, const unsigned char *d,
+                            unsigned DataLen) {
+    using namespace llvm::support;
+    data_type State;
+    if (DataLen != StatCacheDataSize)
+      return State;
+    State.Exists = *d++;
+    uint64_t File = endian::readNext<uint64_t, little, unaligned>(d);
+    uint64_t Device = endian::readNext<uint64_t, little, unaligned>(d);
+    State.UniqueID = llvm::sys::fs::UniqueID(Device, File);
+    State.ModTime = endian::readNext<uint64_t, little, unaligned>(d);
+    return State;
+  }
+
+  // Writer interface.
+  typedef StringRef key_type;
+  typedef StringRef key_type_ref;
+  typedef const data_type &data_type_ref;
+
+  std::pair<unsigned, unsigned>
+  EmitKeyDataLength(raw_ostream &Out, key_type_ref Key, data_type_ref Data) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    LE.write<uint16_t>(Key.size());
+    LE.write<uint16_t>(StatCacheDataSize);
+    return std::make_pair(Key.size(), StatCacheDataSize);
+  }
+
+  void EmitKey(raw_ostream &Out, key_type_ref Key, unsigned KeyLen) {
+    Out.write(Key.data(), KeyLen);
+  }
+
+  void EmitData(raw_ostream &Out, key_type_ref Key, data_type_ref Data,
+                unsigned DataLen) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    LE.write<uint8_t>(Data.Exists);
+    LE.write<uint64_t>(Data.UniqueID.getFile());
+    LE.write<uint64_t>(Data.UniqueID.getDevice());
+    LE.write<uint64_t>(Data.ModTime);
+  }
+};
+
+typedef llvm::OnDiskIterableChainedHashTable<PersistentStatCacheTrait>
+    StatCacheTable;
+} // end anonymous namespace
+
+PersistentStatCache::PersistentStatCache(
+    std::unique_ptr<llvm::MemoryBuffer> Buffer, uint32_t BucketOffset,
+    bool Record)
+    : Buffer(std::move(Buffer)), Table(nullptr), Record(Record), NumLookups(0),
+      NumHits(0), NumStaleHits(0), NumDirectoryStats(0) {
+  if (!this->Buffer)
+    return;
+
+  const unsigned char *Start =
+      (const unsigned char *)this->Buffer->getBufferStart();
+  Table = StatCacheTable::Create(Start + BucketOffset,
+                                 Start + OnDiskTableFileHeaderSize, Start);
+}
+
+PersistentStatCache::~PersistentStatCache() {
+  delete static_cast<StatCacheTable *>(Table);
+}
+
+std::unique_ptr<PersistentStatCache>
+PersistentStatCache::load(StringRef Path, bool Record) {
+  uint32_t BucketOffset = 0;
+  std::unique_ptr<llvm::MemoryBuffer> Buffer =
+      mapOnDiskTableFile(Path, StatCacheMagic, StatCacheVersion, BucketOffset);
+  return std::unique_ptr<PersistentStatCache>(
+      new PersistentStatCache(std::move(Buffer), BucketOffset, Record));
+}
+
+const PersistentStatCache::DirectoryState &
+PersistentStatCache::getDirectoryState(StringRef Dir, vfs::FileSystem &FS) {
+  auto Known = Directories.insert(std::make_pair(Dir, DirectoryState()));
+  DirectoryState &State = Known.first->second;
+  if (!Known.second)
+    return State;
+
+  ++NumDirectoryStats;
+  llvm::ErrorOr<vfs::Status> Status = FS.status(Dir);
+  if (Status && Status->isDirectory()) {
+    State.Exists = true;
+    State.UniqueID = Status->getUniqueID();
+    State.ModTime = Status->getLastModificationTime().toEpochTime();
+  }
+  return State;
+}
+
+PersistentStatCache::LookupResult
+PersistentStatCache::getStat(const char *Path, FileData &Data, bool isFile,
+                             std::unique_ptr<vfs::File> *F,
+                             vfs::FileSystem &FS) {
+  // Relative paths depend on the working directory, so only failed lookups
+  // of absolute paths are cached.
+  if (!llvm::sys::path::is_absolute(Path))
+    return statChained(Path, Data, isFile, F, FS);
+
+  ++NumLookups;
+  StringRef Dir = llvm::sys::path::parent_path(Path);
+  if (StatCacheTable *T = static_cast<StatCacheTable *>(Table)) {
+    StatCacheTable::iterator Pos = T->find(Path);
+    if (Pos != T->end()) {
+      if (*Pos == getDirectoryState(Dir, FS)) {
+        ++NumHits;
+        return CacheMissing;
+      }
+      ++NumStaleHits;
+    }
+  }
+
+  LookupResult Result = statChained(Path, Data, isFile, F, FS);
+  if (!Record || Result != CacheMissing)
+    return Result;
+
+  // A directory modified within the last couple of seconds may be modified
+  // again without its modification time changing, so don't trust it yet.
+  const DirectoryState &State = getDirectoryState(Dir, FS);
+  if (!State.Exists || State.ModTime + 2 < (uint64_t)::time(nullptr))
+    Recorded[Path] = State;
+  return Result;
+}
+
+bool PersistentStatCache::writeToFile(StringRef Path, vfs::FileSystem &FS,
+                                      std::string &ErrorMsg) {
+  llvm::OnDiskChainedHashTableGenerator<PersistentStatCacheTrait> Generator;
+  PersistentStatCacheTrait Trait;
+
+  // Keep the entries of the loaded file whose directory is unchanged, unless
+  // this process recorded a newer state for them.
+  if (StatCacheTable *T = static_cast<StatCacheTable *>(Table)) {
+    for (StatCacheTable::key_iterator K = T->key_begin(), KEnd = T->key_end();
+         K != KEnd; ++K) {
+      StringRef Key = *K;
+      if (Recorded.count(Key))
+        continue;
+      DirectoryState State = *T->find(Key);
+      if (State == getDirectoryState(llvm::sys::path::parent_path(Key), FS))
+        Generator.insert(Key, State, Trait);
+    }
+  }
+  for (const auto &Entry : Recorded)
+    Generator.insert(Entry.first(), Entry.second, Trait);
+
+  return writeOnDiskTableFile(
+      Path, StatCacheMagic, StatCacheVersion,
+      [&](raw_ostream &Out) { return Generator.Emit(Out, Trait); }, ErrorMsg);
+}
+
+void PersistentStatCache::PrintStats() const {
+  llvm::errs() << "\n*** Persistent Stat Cache Stats:\n";
+  llvm::errs() << NumLookups << " lookups of absolute paths, " << NumHits
+               << " answered from the cache, " << NumStaleHits
+               << " stale.\n";
+  llvm::errs() << NumDirectoryStats << " directory lookups to validate the "
+               << "cache.\n";
+  llvm::errs() << (int)NumHits - (int)NumDirectoryStats
+               << " file system queries avoided.\n";
+}
@@ -0,0 +1,120 @@
+//===--- PhaseProfile.cpp - Per-phase compile time profile ----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the PhaseProfile class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/PhaseProfile.h"
+#include "clang/Basic/JsonSupport.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+StringRef PhaseProfile::getPhaseName(PhaseKind Phase) {
+  switch (Phase) {
+  case Frontend: return "frontend";
+  case Preprocess: return "preprocess";
+  case Parse: return "parse";
+  case TemplateInstantiation: return "template-instantiation";
+  case ModuleLoading: return "module-loading";
+  case ModuleBuilding: return "module-building";
+  case IRGeneration: return "ir-generation";
+  case LLVMPasses: return "llvm-passes";
+  case NumPhases: break;
+  }
+  llvm_unreachable("Invalid phase");
+}
+
+void PhaseProfile::chargeInnermost() {
+  llvm::TimeRecord Now = llvm::TimeRecord::getCurrentTime();
+  if (!Stack.empty()) {
+    llvm::TimeRecord Elapsed = Now;
+    Elapsed -= LastSwitch;
+    Phases[Stack.back()].Time += Elapsed;
+  }
+  LastSwitch = Now;
+}
+
+void PhaseProfile::enterPhase(PhaseKind Phase) {
+  chargeInnermost();
+  Stack.push_back(Phase);
+  ++Phases[Phase].Count;
+}
+
+void PhaseProfile::exitPhase() {
+  assert(!Stack.empty() && "Unbalanced exit from a phase");
+  chargeInnermost();
+  Stack.pop_back();
+}
+
+void PhaseProfile::addCounter(StringRef Name, uint64_t Value) {
+  for (auto &Counter : Counters) {
+    if (Counter.first == Name) {
+      Counter.second += Value;
+      return;
+    }
+  }
+  Counters.push_back(std::make_pair(Name.str(), Value));
+}
+
+static void writeTimes(raw_ostream &OS, const llvm::TimeRecord &Time) {
+  OS << "\"wall\": " << llvm::format("%.6f", Time.getWallTime())
+     << ", \"user\": " << llvm::format("%.6f", Time.getUserTime())
+     << ", \"system\": " << llvm::format("%.6f", Time.getSystemTime());
+}
+
+bool PhaseProfile::writeJSON(StringRef Path, StringRef InputFile,
+                             std::string &ErrorMsg) const {
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::F_Text);
+  if (EC) {
+    ErrorMsg = EC.message();
+    return true;
+  }
+
+  llvm::TimeRecord Total;
+  for (const PhaseData &Data : Phases)
+    Total += Data.Time;
+
+  OS << "{\n";
+  OS << "  \"file\": ";
+  printJSONString(OS, InputFile);
+  OS << ",\n";
+  OS << "  \"total\": { ";
+  writeTimes(OS, Total);
+  OS << " },\n";
+  OS << "  \"phases\": {\n";
+  for (unsigned I = 0; I != NumPhases; ++I) {
+    OS << "    \"" << getPhaseName(static_cast<PhaseKind>(I)) << "\": { ";
+    writeTimes(OS, Phases[I].Time);
+    OS << ", \"count\": " << Phases[I].Count << " }"
+       << (I + 1 != NumPhases ? ",\n" : "\n");
+  }
+  OS << "  },\n";
+  OS << "  \"counters\": {\n";
+  for (unsigned I = 0, N = Counters.size(); I != N; ++I) {
+    OS << "    ";
+    printJSONString(OS, Counters[I].first);
+    OS << ": " << Counters[I].second << (I + 1 != N ? ",\n" : "\n");
+  }
+  OS << "  }\n";
+  OS << "}\n";
+
+  OS.close();
+  if (OS.has_error()) {
+    ErrorMsg = "could not write file";
+    OS.clear_error();
+    return true;
+  }
+  return false;
+}
@@ -14,10 +14,12 @@
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/Utils.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeWriterPass.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/RegAllocRegistry.h"
 #include "llvm/CodeGen/SchedulerRegistry.h"
 #include "llvm/IR/DataLayout.h"
@@ -27,6 +29,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/Timer.h"
@@ -39,6 +42,7 @@
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/ObjCARC.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
 #include <memory>
 using namespace clang;
@@ -46,6 +50,23 @@ using namespace llvm;
 
 namespace {
 
+/// A stream that only feeds what is written to it into an MD5 hash.
+class MD5Stream : public raw_ostream {
+  MD5 &Hash;
+  uint64_t Pos;
+
+  void write_impl(const char *Ptr, size_t Size) override {
+    Hash.update(
+        ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(Ptr), Size));
+    Pos += Size;
+  }
+  uint64_t current_pos() const override { return Pos; }
+
+public:
+  explicit MD5Stream(MD5 &Hash) : Hash(Hash), Pos(0) {}
+  ~MD5Stream() override { flush(); }
+};
+
 class EmitAssemblyHelper {
   DiagnosticsEngine &Diags;
   const CodeGenOptions &CodeGenOpts;
@@ -111,6 +132,11 @@ private:
   /// \return True on success.
   bool AddEmitPasses(BackendAction Action, raw_pwrite_stream &OS);
 
+  /// Split a copy of the module into one partition per stream and generate
+  /// code for each of them on its own thread.
+  void EmitPartitions(BackendAction Action,
+                      ArrayRef<raw_pwrite_stream *> OSs);
+
 public:
   EmitAssemblyHelper(DiagnosticsEngine &_Diags,
                      const CodeGenOptions &CGOpts,
@@ -132,7 +158,8 @@ public:
 
   std::unique_ptr<TargetMachine> TM;
 
-  void EmitAssembly(BackendAction Action, raw_pwrite_stream *OS);
+  void EmitAssembly(BackendAction Action, raw_pwrite_stream *OS,
+                    ArrayRef<raw_pwrite_stream *> PartitionOSs);
 };
 
 // We need this wrapper to access LangOpts and CGOpts from extension functions
@@ -558,6 +585,15 @@ TargetMachine *EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
   return TM;
 }
 
+static TargetMachine::CodeGenFileType getCodeGenFileType(BackendAction Action) {
+  if (Action == Backend_EmitObj)
+    return TargetMachine::CGFT_ObjectFile;
+  if (Action == Backend_EmitMCNull)
+    return TargetMachine::CGFT_Null;
+  assert(Action == Backend_EmitAssembly && "Invalid action!");
+  return TargetMachine::CGFT_AssemblyFile;
+}
+
 bool EmitAssemblyHelper::AddEmitPasses(BackendAction Action,
                                        raw_pwrite_stream &OS) {
 
@@ -572,13 +608,7 @@ bool EmitAssemblyHelper::AddEmitPasses(BackendAction Action,
 
   // Normal mode, emit a .s or .o file by running the code generator. Note,
   // this also adds codegenerator level optimization passes.
-  TargetMachine::CodeGenFileType CGFT = TargetMachine::CGFT_AssemblyFile;
-  if (Action == Backend_EmitObj)
-    CGFT = TargetMachine::CGFT_ObjectFile;
-  else if (Action == Backend_EmitMCNull)
-    CGFT = TargetMachine::CGFT_Null;
-  else
-    assert(Action == Backend_EmitAssembly && "Invalid action!");
+  TargetMachine::CodeGenFileType CGFT = getCodeGenFileType(Action);
 
   // Add ObjC ARC final-cleanup optimizations. This is done as part of the
   // "codegen" passes so that it isn't run multiple times when there is
@@ -595,10 +625,54 @@ bool EmitAssemblyHelper::AddEmitPasses(BackendAction Action,
   return true;
 }
 
-void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
-                                      raw_pwrite_stream *OS) {
+void EmitAssemblyHelper::EmitPartitions(BackendAction Action,
+                                        ArrayRef<raw_pwrite_stream *> OSs) {
+  std::unique_ptr<Module> Clone(CloneModule(TheModule));
+
+  // Splitting the module gives its local symbols external linkage and
+  // hidden visibility, so that the partitions can refer to each other's.
+  // Make their names unique to this module, so that they do not clash with
+  // the local symbols of other objects linked with these. The module
+  // identifier alone is not enough: it is the same when one source file is
+  // compiled twice with different options, so hash the whole module.
+  MD5 Hash;
+  {
+    MD5Stream HashOS(Hash);
+    TheModule->print(HashOS, nullptr);
+  }
+  MD5::MD5Result HashResult;
+  Hash.final(HashResult);
+  SmallString<32> Suffix;
+  MD5::stringifyResult(HashResult, Suffix);
+  auto Rename = [&](GlobalValue &GV) {
+    if (GV.hasLocalLinkage())
+      GV.setName((GV.hasName() ? GV.getName() : "__unnamed") + ".part." +
+                 Suffix);
+  };
+  for (Function &F : Clone->functions())
+    Rename(F);
+  for (GlobalVariable &GV : Clone->globals())
+    Rename(GV);
+  for (GlobalAlias &GA : Clone->aliases())
+    Rename(GA);
+
+  splitCodeGen(std::move(Clone), OSs, TM->getTargetCPU(),
+               TM->getTargetFeatureString(), TM->Options,
+               TM->getRelocationModel(), TM->getCodeModel(),
+               TM->getOptLevel(), getCodeGenFileType(Action));
+}
+
+void EmitAssemblyHelper::EmitAssembly(
+    BackendAction Action, raw_pwrite_stream *OS,
+    ArrayRef<raw_pwrite_stream *> PartitionOSs) {
   TimeRegion Region(llvm::TimePassesIsEnabled ? &CodeGenerationTime : nullptr);
 
+  // With more than one output stream, the code generator runs on partitions
+  // of the module after it has been optimized as a whole.
+  bool EmitsPartitions = !PartitionOSs.empty() &&
+                         (Action == Backend_EmitObj ||
+                          Action == Backend_EmitAssembly);
+
   bool UsesCodeGen = (Action != Backend_EmitNothing &&
                       Action != Backend_EmitBC &&
                       Action != Backend_EmitLL);
@@ -626,8 +700,14 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     break;
 
   default:
-    if (!AddEmitPasses(Action, *OS))
+    if (EmitsPartitions) {
+      // The code generator passes of the partitions are only those of the
+      // target, so run the final ARC cleanup on the whole module.
+      if (CodeGenOpts.OptimizationLevel > 0)
+        getPerModulePasses()->add(createObjCARCContractPass());
+    } else if (!AddEmitPasses(Action, *OS)) {
       return;
+    }
   }
 
   // Before executing passes, print the final values of the LLVM options.
@@ -655,6 +735,13 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     PrettyStackTraceString CrashInfo("Code generation");
     CodeGenPasses->run(*TheModule);
   }
+
+  if (EmitsPartitions) {
+    PrettyStackTraceString CrashInfo("Parallel code generation");
+    SmallVector<raw_pwrite_stream *, 8> OSs(1, OS);
+    OSs.append(PartitionOSs.begin(), PartitionOSs.end());
+    EmitPartitions(Action, OSs);
+  }
 }
 
 void clang::EmitBackendOutput(DiagnosticsEngine &Diags,
@@ -662,10 +749,11 @@ void clang::EmitBackendOutput(DiagnosticsEngine &Diags,
                               const clang::TargetOptions &TOpts,
                               const LangOptions &LOpts, StringRef TDesc,
                               Module *M, BackendAction Action,
-                              raw_pwrite_stream *OS) {
+                              raw_pwrite_stream *OS,
+                              ArrayRef<raw_pwrite_stream *> PartitionOSs) {
   EmitAssemblyHelper AsmHelper(Diags, CGOpts, TOpts, LOpts, M);
 
-  AsmHelper.EmitAssembly(Action, OS);
+  AsmHelper.EmitAssembly(Action, OS, PartitionOSs);
 
   // If an optional clang TargetInfo description string was passed in, use it to
   // verify the LLVM TargetMachine's DataLayout.
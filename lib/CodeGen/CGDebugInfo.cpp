@@ -1395,6 +1395,27 @@ llvm::DIType *CGDebugInfo::getOrCreateInterfaceType(QualType D,
   return T;
 }
 
+/// Return true if every object of \p RD is created by emitted code calling one
+/// of its user-declared constructors, other than copy and move constructors.
+/// Aggregates, lambdas and classes with a trivial default constructor or a
+/// constexpr constructor can be created without any constructor being emitted.
+static bool canUseCtorHoming(const CXXRecordDecl *RD) {
+  if (!RD->hasDefinition())
+    return false;
+  RD = RD->getDefinition();
+  if (RD->isLambda() || RD->isAggregate() ||
+      RD->hasTrivialDefaultConstructor() ||
+      RD->hasConstexprNonCopyMoveConstructor())
+    return false;
+  for (const CXXConstructorDecl *Ctor : RD->ctors()) {
+    if (Ctor->isCopyOrMoveConstructor())
+      continue;
+    if (!Ctor->isDeleted())
+      return true;
+  }
+  return false;
+}
+
 void CGDebugInfo::completeType(const EnumDecl *ED) {
   if (DebugKind <= CodeGenOptions::DebugLineTablesOnly)
     return;
@@ -1418,9 +1439,14 @@ void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
   if (DebugKind <= CodeGenOptions::DebugLineTablesOnly)
     return;
 
-  if (const CXXRecordDecl *CXXDecl = dyn_cast<CXXRecordDecl>(RD))
+  if (const CXXRecordDecl *CXXDecl = dyn_cast<CXXRecordDecl>(RD)) {
     if (CXXDecl->isDynamicClass())
       return;
+    // The definition is completed when a constructor is emitted.
+    if (DebugKind <= CodeGenOptions::LimitedDebugInfo &&
+        CGM.getCodeGenOpts().DebugCtorHoming && canUseCtorHoming(CXXDecl))
+      return;
+  }
 
   QualType Ty = CGM.getContext().getRecordType(RD);
   llvm::DIType *T = getTypeOrNull(Ty);
@@ -1441,6 +1467,13 @@ void CGDebugInfo::completeClassData(const RecordDecl *RD) {
   TypeCache[TyPtr].reset(Res);
 }
 
+void CGDebugInfo::completeConstructedClass(const CXXRecordDecl *RD) {
+  if (DebugKind != CodeGenOptions::LimitedDebugInfo ||
+      !CGM.getCodeGenOpts().DebugCtorHoming || !canUseCtorHoming(RD))
+    return;
+  completeClassData(RD);
+}
+
 static bool hasExplicitMemberDefinition(CXXRecordDecl::method_iterator I,
                                         CXXRecordDecl::method_iterator End) {
   for (; I != End; ++I)
@@ -1453,7 +1486,8 @@ static bool hasExplicitMemberDefinition(CXXRecordDecl::method_iterator I,
 
 static bool shouldOmitDefinition(CodeGenOptions::DebugInfoKind DebugKind,
                                  const RecordDecl *RD,
-                                 const LangOptions &LangOpts) {
+                                 const LangOptions &LangOpts,
+                                 bool CtorHoming) {
   if (DebugKind > CodeGenOptions::LimitedDebugInfo)
     return false;
 
@@ -1471,6 +1505,13 @@ static bool shouldOmitDefinition(CodeGenOptions::DebugInfoKind DebugKind,
   if (CXXDecl->hasDefinition() && CXXDecl->isDynamicClass())
     return true;
 
+  // Like the vtable of a dynamic class, a constructor that has to run for
+  // every object of the class gives it a home: the definition is emitted
+  // wherever a constructor is.
+  if (CtorHoming && CXXDecl->hasDefinition() &&
+      canUseCtorHoming(CXXDecl->getDefinition()))
+    return true;
+
   TemplateSpecializationKind Spec = TSK_Undeclared;
   if (const ClassTemplateSpecializationDecl *SD =
           dyn_cast<ClassTemplateSpecializationDecl>(RD))
@@ -1487,7 +1528,8 @@ static bool shouldOmitDefinition(CodeGenOptions::DebugInfoKind DebugKind,
 llvm::DIType *CGDebugInfo::CreateType(const RecordType *Ty) {
   RecordDecl *RD = Ty->getDecl();
   llvm::DIType *T = cast_or_null<llvm::DIType>(getTypeOrNull(QualType(Ty, 0)));
-  if (T || shouldOmitDefinition(DebugKind, RD, CGM.getLangOpts())) {
+  if (T || shouldOmitDefinition(DebugKind, RD, CGM.getLangOpts(),
+                                CGM.getCodeGenOpts().DebugCtorHoming)) {
     if (!T)
       T = getOrCreateRecordFwdDecl(
           Ty, getContextDescriptor(cast<Decl>(RD->getDeclContext())));
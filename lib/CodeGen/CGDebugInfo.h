@@ -347,6 +347,10 @@ public:
   void completeRequiredType(const RecordDecl *RD);
   void completeClassData(const RecordDecl *RD);
 
+  /// Emit the definition of \p RD if a constructor of it is being emitted
+  /// and it is described where its constructors are (-fdebug-info-ctor-homing).
+  void completeConstructedClass(const CXXRecordDecl *RD);
+
   void completeTemplateDefinition(const ClassTemplateSpecializationDecl &SD);
 
 private:
@@ -13,6 +13,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclGroup.h"
 #include "clang/Basic/FileManager.h"
+#include "clang/Basic/PhaseProfile.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/CodeGen/BackendUtil.h"
@@ -32,6 +33,7 @@
 #include "llvm/Linker/Linker.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/Timer.h"
 #include <memory>
@@ -47,10 +49,17 @@ namespace clang {
     const TargetOptions &TargetOpts;
     const LangOptions &LangOpts;
     raw_pwrite_stream *AsmOutStream;
+    /// \brief The outputs of the partitions after the first one, if the
+    /// backend splits the module.
+    SmallVector<raw_pwrite_stream *, 4> PartitionOutStreams;
     ASTContext *Context;
 
     Timer LLVMIRGeneration;
 
+    /// \brief The profile IR generation and the backend are charged to, if
+    /// any.
+    PhaseProfile *Profile;
+
     std::unique_ptr<CodeGenerator> Gen;
 
     std::unique_ptr<llvm::Module> TheModule, LinkModule;
@@ -63,11 +72,15 @@ namespace clang {
                     const TargetOptions &TargetOpts,
                     const LangOptions &LangOpts, bool TimePasses,
                     const std::string &InFile, llvm::Module *LinkModule,
-                    raw_pwrite_stream *OS, LLVMContext &C,
-                    CoverageSourceInfo *CoverageInfo = nullptr)
+                    raw_pwrite_stream *OS,
+                    ArrayRef<raw_pwrite_stream *> PartitionOSs,
+                    LLVMContext &C, CoverageSourceInfo *CoverageInfo = nullptr,
+                    PhaseProfile *Profile = nullptr)
         : Diags(Diags), Action(Action), CodeGenOpts(CodeGenOpts),
           TargetOpts(TargetOpts), LangOpts(LangOpts), AsmOutStream(OS),
+          PartitionOutStreams(PartitionOSs.begin(), PartitionOSs.end()),
           Context(nullptr), LLVMIRGeneration("LLVM IR Generation Time"),
+          Profile(Profile),
           Gen(CreateLLVMCodeGen(Diags, InFile, HeaderSearchOpts, PPOpts,
                                 CodeGenOpts, C, CoverageInfo)),
           LinkModule(LinkModule) {
@@ -89,6 +102,7 @@ namespace clang {
         
       Context = &Ctx;
 
+      PhaseProfile::Region ProfileRegion(Profile, PhaseProfile::IRGeneration);
       if (llvm::TimePassesIsEnabled)
         LLVMIRGeneration.startTimer();
 
@@ -105,6 +119,7 @@ namespace clang {
                                      Context->getSourceManager(),
                                      "LLVM IR generation of declaration");
 
+      PhaseProfile::Region ProfileRegion(Profile, PhaseProfile::IRGeneration);
       if (llvm::TimePassesIsEnabled)
         LLVMIRGeneration.startTimer();
 
@@ -120,6 +135,7 @@ namespace clang {
       PrettyStackTraceDecl CrashInfo(D, SourceLocation(),
                                      Context->getSourceManager(),
                                      "LLVM IR generation of inline method");
+      PhaseProfile::Region ProfileRegion(Profile, PhaseProfile::IRGeneration);
       if (llvm::TimePassesIsEnabled)
         LLVMIRGeneration.startTimer();
 
@@ -132,6 +148,8 @@ namespace clang {
     void HandleTranslationUnit(ASTContext &C) override {
       {
         PrettyStackTraceString CrashInfo("Per-file LLVM IR generation");
+        PhaseProfile::Region ProfileRegion(Profile,
+                                           PhaseProfile::IRGeneration);
         if (llvm::TimePassesIsEnabled)
           LLVMIRGeneration.startTimer();
 
@@ -179,9 +197,13 @@ namespace clang {
       void *OldDiagnosticContext = Ctx.getDiagnosticContext();
       Ctx.setDiagnosticHandler(DiagnosticHandler, this);
 
-      EmitBackendOutput(Diags, CodeGenOpts, TargetOpts, LangOpts,
-                        C.getTargetInfo().getTargetDescription(),
-                        TheModule.get(), Action, AsmOutStream);
+      {
+        PhaseProfile::Region ProfileRegion(Profile, PhaseProfile::LLVMPasses);
+        EmitBackendOutput(Diags, CodeGenOpts, TargetOpts, LangOpts,
+                          C.getTargetInfo().getTargetDescription(),
+                          TheModule.get(), Action, AsmOutStream,
+                          PartitionOutStreams);
+      }
 
       Ctx.setInlineAsmDiagnosticHandler(OldHandler, OldContext);
 
@@ -632,12 +654,46 @@ GetOutputStream(CompilerInstance &CI, StringRef InFile, BackendAction Action) {
   llvm_unreachable("Invalid action!");
 }
 
+/// Create the outputs of the partitions after the first one if the backend
+/// splits the module, named after the output file.
+///
+/// \returns false if an error occurred.
+static bool GetPartitionStreams(CompilerInstance &CI, BackendAction Action,
+                                SmallVectorImpl<raw_pwrite_stream *> &OSs) {
+  unsigned Partitions = CI.getCodeGenOpts().BackendPartitions;
+  if (Partitions <= 1 ||
+      (Action != Backend_EmitObj && Action != Backend_EmitAssembly))
+    return true;
+
+  StringRef OutputFile = CI.getFrontendOpts().OutputFile;
+  if (OutputFile.empty() || OutputFile == "-") {
+    CI.getDiagnostics().Report(diag::err_fe_backend_partitions_output);
+    return false;
+  }
+
+  StringRef Extension = llvm::sys::path::extension(OutputFile);
+  StringRef Stem = OutputFile.drop_back(Extension.size());
+  for (unsigned I = 1; I != Partitions; ++I) {
+    raw_pwrite_stream *OS = CI.createOutputFile(
+        (Stem + ".part" + Twine(I) + Extension).str(),
+        /*Binary=*/Action == Backend_EmitObj, /*RemoveFileOnSignal=*/true,
+        /*BaseInput=*/"", /*Extension=*/"", /*UseTemporary=*/true);
+    if (!OS)
+      return false;
+    OSs.push_back(OS);
+  }
+  return true;
+}
+
 std::unique_ptr<ASTConsumer>
 CodeGenAction::CreateASTConsumer(CompilerInstance &CI, StringRef InFile) {
   BackendAction BA = static_cast<BackendAction>(Act);
   raw_pwrite_stream *OS = GetOutputStream(CI, InFile, BA);
   if (BA != Backend_EmitNothing && !OS)
     return nullptr;
+  SmallVector<raw_pwrite_stream *, 4> PartitionOSs;
+  if (!GetPartitionStreams(CI, BA, PartitionOSs))
+    return nullptr;
 
   llvm::Module *LinkModuleToUse = LinkModule;
 
@@ -673,7 +729,8 @@ CodeGenAction::CreateASTConsumer(CompilerInstance &CI, StringRef InFile) {
       BA, CI.getDiagnostics(), CI.getHeaderSearchOpts(),
       CI.getPreprocessorOpts(), CI.getCodeGenOpts(), CI.getTargetOpts(),
       CI.getLangOpts(), CI.getFrontendOpts().ShowTimers, InFile,
-      LinkModuleToUse, OS, *VMContext, CoverageInfo));
+      LinkModuleToUse, OS, PartitionOSs, *VMContext, CoverageInfo,
+      CI.getPhaseProfile()));
   BEConsumer = Result.get();
   return std::move(Result);
 }
@@ -692,6 +749,9 @@ void CodeGenAction::ExecuteAction() {
     raw_pwrite_stream *OS = GetOutputStream(CI, getCurrentFile(), BA);
     if (BA != Backend_EmitNothing && !OS)
       return;
+    SmallVector<raw_pwrite_stream *, 4> PartitionOSs;
+    if (!GetPartitionStreams(CI, BA, PartitionOSs))
+      return;
 
     bool Invalid;
     SourceManager &SM = CI.getSourceManager();
@@ -734,9 +794,11 @@ void CodeGenAction::ExecuteAction() {
 
     LLVMContext &Ctx = TheModule->getContext();
     Ctx.setInlineAsmDiagnosticHandler(BitcodeInlineAsmDiagHandler);
+    PhaseProfile::Region ProfileRegion(CI.getPhaseProfile(),
+                                       PhaseProfile::LLVMPasses);
     EmitBackendOutput(CI.getDiagnostics(), CI.getCodeGenOpts(), TargetOpts,
                       CI.getLangOpts(), CI.getTarget().getTargetDescription(),
-                      TheModule.get(), BA, OS);
+                      TheModule.get(), BA, OS, PartitionOSs);
     return;
   }
 
@@ -14,9 +14,16 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace clang::driver;
 using namespace clang;
@@ -122,8 +129,7 @@ bool Compilation::CleanupFileMap(const ArgStringMap &Files,
   return Success;
 }
 
-int Compilation::ExecuteCommand(const Command &C,
-                                const Command *&FailingCommand) const {
+bool Compilation::PrintCommand(const Command &C) const {
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
     raw_ostream *OS = &llvm::errs();
@@ -138,9 +144,8 @@ int Compilation::ExecuteCommand(const Command &C,
       if (EC) {
         getDriver().Diag(clang::diag::err_drv_cc_print_options_failure)
             << EC.message();
-        FailingCommand = &C;
         delete OS;
-        return 1;
+        return false;
       }
     }
 
@@ -152,10 +157,26 @@ int Compilation::ExecuteCommand(const Command &C,
     if (OS != &llvm::errs())
       delete OS;
   }
+  return true;
+}
+
+int Compilation::ExecuteCommand(const Command &C,
+                                const Command *&FailingCommand) const {
+  if (!PrintCommand(C)) {
+    FailingCommand = &C;
+    return 1;
+  }
 
   std::string Error;
   bool ExecutionFailed;
   int Res = C.Execute(Redirects, &Error, &ExecutionFailed);
+  return ReportCommandResult(C, Res, Error, ExecutionFailed, FailingCommand);
+}
+
+int Compilation::ReportCommandResult(const Command &C, int Res,
+                                     const std::string &Error,
+                                     bool ExecutionFailed,
+                                     const Command *&FailingCommand) const {
   if (!Error.empty()) {
     assert(Res && "Error string set with 0 result code!");
     getDriver().Diag(clang::diag::err_drv_command_failure) << Error;
@@ -192,8 +213,40 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+/// Adds \p A and its (transitive) inputs to \p Reachable.
+static void
+CollectInputActions(const Action *A,
+                    llvm::SmallPtrSetImpl<const Action *> &Reachable) {
+  if (!Reachable.insert(A).second)
+    return;
+  for (const Action *AI : *A)
+    CollectInputActions(AI, Reachable);
+}
+
+/// Returns true if \p C writes its output to the standard output.
+static bool WritesToStdout(const Command &C) {
+  const ArgStringList &Args = C.getArguments();
+  for (unsigned I = 0, E = Args.size(); I + 1 < E; ++I)
+    if (StringRef(Args[I]) == "-o" && StringRef(Args[I + 1]) == "-")
+      return true;
+  return false;
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands) const {
+#if LLVM_ENABLE_THREADS
+  // Reproducers for crash diagnostics are always generated serially, and so
+  // are jobs sharing the standard output, whose output would interleave.
+  unsigned NumWritingStdout = 0;
+  for (const auto &Job : Jobs)
+    if (WritesToStdout(Job))
+      ++NumWritingStdout;
+  if (!ForDiagnostics && getDriver().getNumParallelJobs() > 1 &&
+      Jobs.size() > 1 && NumWritingStdout <= 1)
+    return ExecuteJobsInParallel(Jobs, getDriver().getNumParallelJobs(),
+                                 FailingCommands);
+#endif
+
   for (const auto &Job : Jobs) {
     if (!InputsOk(Job, FailingCommands))
       continue;
@@ -203,6 +256,143 @@ void Compilation::ExecuteJobs(const JobList &Jobs,
   }
 }
 
+void Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, unsigned NumParallelJobs,
+    FailingCommandList &FailingCommands) const {
+  SmallVector<const Command *, 8> Commands;
+  for (const auto &Job : Jobs)
+    Commands.push_back(&Job);
+  const unsigned NumCommands = Commands.size();
+
+  // The job list is built in dependency order, so a command can only depend
+  // on the earlier commands whose actions feed into its own action.
+  // Walk the inputs of each command once rather than once per earlier
+  // command.
+  SmallVector<SmallVector<unsigned, 4>, 8> Dependencies(NumCommands);
+  for (unsigned J = 0; J != NumCommands; ++J) {
+    llvm::SmallPtrSet<const Action *, 16> Reachable;
+    CollectInputActions(&Commands[J]->getSource(), Reachable);
+    for (unsigned I = 0; I != J; ++I)
+      if (Reachable.count(&Commands[I]->getSource()))
+        Dependencies[J].push_back(I);
+  }
+
+  enum CommandState { Pending, Running, Succeeded, Failed, PrintFailed,
+                      Skipped };
+  struct CommandResult {
+    int Res = 0;
+    std::string Error;
+    bool ExecutionFailed = false;
+    // The file the command's stderr is captured in, if any.
+    SmallString<128> ErrorFile;
+  };
+  SmallVector<CommandState, 8> States(NumCommands, Pending);
+  std::vector<CommandResult> Results(NumCommands);
+
+  // Report the commands that are done in input order, independent of
+  // completion order: replay the captured stderr of each command, then
+  // diagnose its failure, like the serial case would.
+  unsigned NextToReport = 0;
+  auto ReportFinishedCommands = [&] {
+    for (; NextToReport != NumCommands; ++NextToReport) {
+      unsigned J = NextToReport;
+      if (States[J] == Pending || States[J] == Running)
+        return;
+      CommandResult &Result = Results[J];
+      if (!Result.ErrorFile.empty()) {
+        if (auto Buffer = llvm::MemoryBuffer::getFile(Result.ErrorFile)) {
+          llvm::errs() << (*Buffer)->getBuffer();
+          llvm::errs().flush();
+        }
+        llvm::sys::fs::remove(Result.ErrorFile);
+      }
+      if (States[J] == PrintFailed) {
+        FailingCommands.push_back(std::make_pair(1, Commands[J]));
+      } else if (States[J] == Failed) {
+        const Command *FailingCommand = nullptr;
+        int Res = ReportCommandResult(*Commands[J], Result.Res, Result.Error,
+                                      Result.ExecutionFailed, FailingCommand);
+        FailingCommands.push_back(std::make_pair(Res, FailingCommand));
+      }
+    }
+  };
+
+  std::mutex Mutex;
+  std::condition_variable CommandFinished;
+  SmallVector<unsigned, 8> FinishedCommands;
+  std::vector<std::thread> Threads;
+  unsigned NumRunning = 0, NumDone = 0;
+
+  while (NumDone != NumCommands) {
+    // Start every command whose inputs are available, in input order. A
+    // command whose inputs failed is skipped, like in the serial case.
+    for (unsigned J = 0; J != NumCommands && NumRunning < NumParallelJobs;
+         ++J) {
+      if (States[J] != Pending)
+        continue;
+      bool Ready = true, InputFailed = false;
+      for (unsigned I : Dependencies[J]) {
+        if (States[I] == Failed || States[I] == PrintFailed ||
+            States[I] == Skipped)
+          InputFailed = true;
+        else if (States[I] != Succeeded)
+          Ready = false;
+      }
+      if (InputFailed) {
+        States[J] = Skipped;
+        ++NumDone;
+        continue;
+      }
+      if (!Ready)
+        continue;
+      if (!PrintCommand(*Commands[J])) {
+        States[J] = PrintFailed;
+        ++NumDone;
+        continue;
+      }
+
+      // Capture stderr so that diagnostics of concurrent commands do not
+      // interleave. If no file can be created, the command writes to the
+      // driver's stderr directly.
+      CommandResult &Result = Results[J];
+      if (llvm::sys::fs::createTemporaryFile("clang-job", "txt",
+                                             Result.ErrorFile))
+        Result.ErrorFile.clear();
+
+      States[J] = Running;
+      ++NumRunning;
+      Threads.emplace_back([&, J] {
+        CommandResult &Result = Results[J];
+        StringRef ErrorFile = Result.ErrorFile;
+        const StringRef *CommandRedirects[] = {nullptr, nullptr, &ErrorFile};
+        Result.Res = Commands[J]->Execute(
+            ErrorFile.empty() ? nullptr : CommandRedirects, &Result.Error,
+            &Result.ExecutionFailed);
+        std::lock_guard<std::mutex> Lock(Mutex);
+        FinishedCommands.push_back(J);
+        CommandFinished.notify_one();
+      });
+    }
+
+    if (NumRunning) {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      CommandFinished.wait(Lock, [&] { return !FinishedCommands.empty(); });
+      for (unsigned J : FinishedCommands) {
+        const CommandResult &Result = Results[J];
+        States[J] = Result.Res || Result.ExecutionFailed ? Failed : Succeeded;
+        --NumRunning;
+        ++NumDone;
+      }
+      FinishedCommands.clear();
+    }
+
+    ReportFinishedCommands();
+  }
+
+  for (std::thread &Thread : Threads)
+    Thread.join();
+}
+
 void Compilation::initCompilationForDiagnostics() {
   ForDiagnostics = true;
 
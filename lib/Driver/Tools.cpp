@@ -2584,6 +2584,70 @@ static void SplitDebugInfo(const ToolChain &TC, Compilation &C, const Tool &T,
   C.addCommand(llvm::make_unique<Command>(JA, T, Exec, StripArgs, II));
 }
 
+/// \brief Returns the GNU ld emulation for \p T, or null if it is not known.
+static const char *getLDMOption(const llvm::Triple &T, const ArgList &Args);
+
+/// \brief Returns the number of partitions the backend should generate code
+/// for concurrently with -fparallel-codegen=N, or 1 if the object file is
+/// produced in one piece.
+static unsigned getParallelCodeGenPartitions(const ToolChain &TC,
+                                             const ArgList &Args,
+                                             const InputInfo &Output) {
+  Arg *A = Args.getLastArg(options::OPT_fparallel_codegen_EQ);
+  if (!A)
+    return 1;
+
+  unsigned Partitions;
+  StringRef Value = A->getValue();
+  if (Value.getAsInteger(10, Partitions) || Partitions == 0) {
+    TC.getDriver().Diag(diag::err_drv_invalid_int_value)
+        << A->getAsString(Args) << Value;
+    return 1;
+  }
+
+  // The partitions are combined with a relocatable link and objcopy, which
+  // is only supported for the Linux targets whose linker emulation is known.
+  // Split DWARF and the cl.exe fallback expect a single object file from the
+  // compiler.
+  const llvm::Triple &Triple = TC.getTriple();
+  if (Output.getType() != types::TY_Object || !Output.isFilename() ||
+      !Triple.isOSLinux() || !getLDMOption(Triple, Args) ||
+      Args.hasArg(options::OPT_gsplit_dwarf) ||
+      Args.hasArg(options::OPT__SLASH_fallback))
+    return 1;
+  return Partitions;
+}
+
+/// \brief Combine the object files written by a compilation with
+/// -backend-partitions into the object file \p Output.
+static void LinkCodeGenPartitions(const ToolChain &TC, Compilation &C,
+                                  const Tool &T, const JobAction &JA,
+                                  const ArgList &Args, const InputInfo &Output,
+                                  ArrayRef<const char *> PartitionFiles) {
+  ArgStringList LinkArgs;
+  LinkArgs.push_back("-r");
+  LinkArgs.push_back("-m");
+  LinkArgs.push_back(getLDMOption(TC.getTriple(), Args));
+  LinkArgs.push_back("-o");
+  LinkArgs.push_back(Output.getFilename());
+  LinkArgs.append(PartitionFiles.begin(), PartitionFiles.end());
+
+  const char *Exec = Args.MakeArgString(TC.GetLinkerPath());
+  InputInfo II(Output.getFilename(), types::TY_Object, Output.getFilename());
+  C.addCommand(llvm::make_unique<Command>(JA, T, Exec, LinkArgs, II));
+
+  // The backend gave the local symbols shared between partitions hidden
+  // external linkage and a ".part.<hash>" suffix. Make them local again, so
+  // that the combined object looks like one compiled in one piece. Other
+  // hidden symbols may be referenced by other objects and are left alone.
+  ArgStringList LocalizeArgs;
+  LocalizeArgs.push_back("--wildcard");
+  LocalizeArgs.push_back("--localize-symbol=*.part.*");
+  LocalizeArgs.push_back(Output.getFilename());
+  const char *Objcopy = Args.MakeArgString(TC.GetProgramPath("objcopy"));
+  C.addCommand(llvm::make_unique<Command>(JA, T, Objcopy, LocalizeArgs, II));
+}
+
 /// \brief Vectorize at all optimization levels greater than 1 except for -Oz.
 /// For -Oz the loop vectorizer is disable, while the slp vectorizer is enabled.
 static bool shouldEnableVectorizerAtOLevel(const ArgList &Args, bool isSlpVec) {
@@ -3604,6 +3668,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back("-generate-type-units");
   }
 
+  if (Args.hasFlag(options::OPT_fdebug_info_ctor_homing,
+                   options::OPT_fno_debug_info_ctor_homing, false))
+    CmdArgs.push_back("-fdebug-info-ctor-homing");
+
   // CloudABI uses -ffunction-sections and -fdata-sections by default.
   bool UseSeparateSections = Triple.getOS() == llvm::Triple::CloudABI;
 
@@ -4011,6 +4079,9 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   Args.AddLastArg(CmdArgs, options::OPT_fdiagnostics_print_source_range_info);
   Args.AddLastArg(CmdArgs, options::OPT_fdiagnostics_parseable_fixits);
   Args.AddLastArg(CmdArgs, options::OPT_ftime_report);
+  Args.AddLastArg(CmdArgs, options::OPT_ftime_report_EQ);
+  Args.AddLastArg(CmdArgs, options::OPT_fcost_report_EQ);
+  Args.AddLastArg(CmdArgs, options::OPT_fconstexpr_profile);
   Args.AddLastArg(CmdArgs, options::OPT_ftrapv);
 
   if (Arg *A = Args.getLastArg(options::OPT_ftrapv_handler_EQ)) {
@@ -4809,7 +4880,29 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (C.getDriver().isSaveTempsEnabled() && isa<CompileJobAction>(JA))
     CmdArgs.push_back("-disable-llvm-passes");
 
-  if (Output.getType() == types::TY_Dependencies) {
+  // With -fparallel-codegen=N the backend writes N temporary object files,
+  // which are linked into the requested output once the compilation is done.
+  SmallVector<const char *, 8> CodeGenPartitionFiles;
+  unsigned CodeGenPartitions =
+      getParallelCodeGenPartitions(getToolChain(), Args, Output);
+  if (CodeGenPartitions > 1) {
+    std::string TmpName = D.GetTemporaryPath(
+        llvm::sys::path::stem(Input.getBaseInput()),
+        types::getTypeTempSuffix(types::TY_Object));
+    const char *TmpPath = C.addTempFile(Args.MakeArgString(TmpName));
+    CodeGenPartitionFiles.push_back(TmpPath);
+
+    StringRef Extension = llvm::sys::path::extension(TmpName);
+    StringRef Stem = StringRef(TmpName).drop_back(Extension.size());
+    for (unsigned I = 1; I != CodeGenPartitions; ++I)
+      CodeGenPartitionFiles.push_back(C.addTempFile(Args.MakeArgString(
+          Stem + ".part" + Twine(I) + Extension)));
+
+    CmdArgs.push_back("-backend-partitions");
+    CmdArgs.push_back(Args.MakeArgString(Twine(CodeGenPartitions)));
+    CmdArgs.push_back("-o");
+    CmdArgs.push_back(TmpPath);
+  } else if (Output.getType() == types::TY_Dependencies) {
     // Handled with other dependency code.
   } else if (Output.isFilename()) {
     CmdArgs.push_back("-o");
@@ -4881,6 +4974,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     C.addCommand(llvm::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
   }
 
+  if (CodeGenPartitions > 1)
+    LinkCodeGenPartitions(getToolChain(), C, *this, JA, Args, Output,
+                          CodeGenPartitionFiles);
+
   // Handle the debug info splitting at object creation time if we're
   // creating an object.
   // TODO: Currently only works on linux with newer objcopy.
@@ -8003,7 +8100,7 @@ static const char *getLDMOption(const llvm::Triple &T, const ArgList &Args) {
       return "elf32_x86_64";
     return "elf_x86_64";
   default:
-    llvm_unreachable("Unexpected arch");
+    return nullptr;
   }
 }
 
@@ -8056,8 +8153,11 @@ void gnutools::Linker::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back("--eh-frame-hdr");
   }
 
+  const char *Emulation = getLDMOption(ToolChain.getTriple(), Args);
+  if (!Emulation)
+    llvm_unreachable("Unexpected arch");
   CmdArgs.push_back("-m");
-  CmdArgs.push_back(getLDMOption(ToolChain.getTriple(), Args));
+  CmdArgs.push_back(Emulation);
 
   if (Args.hasArg(options::OPT_static)) {
     if (Arch == llvm::Triple::arm || Arch == llvm::Triple::armeb ||
@@ -219,9 +219,10 @@ ASTUnit::ASTUnit(bool _MainFileIsAST)
     OwnsRemappedFileBuffers(true),
     NumStoredDiagnosticsFromDriver(0),
     PreambleRebuildCounter(0),
-    NumWarningsInPreamble(0),
+    NumWarningsInPreamble(0), LastChangeOffset(~0U),
     ShouldCacheCodeCompletionResults(false),
     IncludeBriefCommentsInCodeCompletion(false), UserFilesAreVolatile(false),
+    ReuseUnchangedDecls(false), PreambleCoversDecls(false),
     CompletionCacheTopLevelHashValue(0),
     PreambleTopLevelHashValue(0),
     CurrentTopLevelHashValue(0),
@@ -773,6 +774,101 @@ public:
   }
 };
 
+/// \brief Preprocessor callback class that records the conditional blocks and
+/// pragmas of the main file, which limit where a precompiled preamble that
+/// covers top-level declarations may end.
+class DeclBoundaryPPCallbacks : public PPCallbacks {
+  const SourceManager &SM;
+  ASTUnit::DeclBoundaries &Boundaries;
+  SmallVector<unsigned, 4> OpenConditionals;
+
+  bool getMainFileOffset(SourceLocation Loc, unsigned &Offset) const {
+    FileID FID;
+    std::tie(FID, Offset) = SM.getDecomposedExpansionLoc(Loc);
+    return FID == SM.getMainFileID();
+  }
+
+  void enterConditional(SourceLocation Loc) {
+    unsigned Offset;
+    if (getMainFileOffset(Loc, Offset))
+      OpenConditionals.push_back(Offset);
+  }
+
+public:
+  DeclBoundaryPPCallbacks(const SourceManager &SM,
+                          ASTUnit::DeclBoundaries &Boundaries)
+    : SM(SM), Boundaries(Boundaries) { }
+
+  void If(SourceLocation Loc, SourceRange ConditionRange,
+          ConditionValueKind ConditionValue) override {
+    enterConditional(Loc);
+  }
+
+  void Ifdef(SourceLocation Loc, const Token &MacroNameTok,
+             const MacroDefinition &MD) override {
+    enterConditional(Loc);
+  }
+
+  void Ifndef(SourceLocation Loc, const Token &MacroNameTok,
+              const MacroDefinition &MD) override {
+    enterConditional(Loc);
+  }
+
+  void Endif(SourceLocation Loc, SourceLocation IfLoc) override {
+    unsigned Offset;
+    if (!getMainFileOffset(Loc, Offset) || OpenConditionals.empty())
+      return;
+    Boundaries.Conditionals.push_back(
+        std::make_pair(OpenConditionals.pop_back_val(), Offset));
+  }
+
+  void PragmaDirective(SourceLocation Loc,
+                       PragmaIntroducerKind Introducer) override {
+    unsigned Offset;
+    if (getMainFileOffset(Loc, Offset))
+      Boundaries.Pragmas.push_back(Offset);
+  }
+
+  void EndOfMainFile() override {
+    // A conditional that was never closed extends to the end of the file.
+    for (unsigned Start : OpenConditionals)
+      Boundaries.Conditionals.push_back(std::make_pair(Start, ~0U));
+    OpenConditionals.clear();
+  }
+};
+
+/// \brief Record the end of the given top-level declaration group, including
+/// the semicolon that terminates it, as a place where a precompiled preamble
+/// may end.
+void AddTopLevelDeclEnd(DeclGroupRef DG, const SourceManager &SM,
+                        const LangOptions &LangOpts,
+                        ASTUnit::DeclBoundaries &Boundaries) {
+  Decl *Last = nullptr;
+  for (Decl *D : DG)
+    Last = D;
+  if (!Last || !Last->getLexicalDeclContext()->isTranslationUnit())
+    return;
+
+  SourceLocation End = Last->getLocEnd();
+  if (End.isInvalid())
+    return;
+  End = SM.getExpansionRange(End).second;
+
+  SourceLocation AfterEnd = Lexer::findLocationAfterToken(
+      End, tok::semi, SM, LangOpts, /*SkipTrailingWhitespaceAndNewLine=*/false);
+  if (AfterEnd.isInvalid())
+    AfterEnd = Lexer::getLocForEndOfToken(End, 0, SM, LangOpts);
+
+  FileID FID;
+  unsigned Offset;
+  std::tie(FID, Offset) = SM.getDecomposedLoc(AfterEnd);
+  if (FID != SM.getMainFileID())
+    return;
+
+  if (Boundaries.DeclEnds.empty() || Boundaries.DeclEnds.back() < Offset)
+    Boundaries.DeclEnds.push_back(Offset);
+}
+
 /// \brief Add the given declaration to the hash of all top-level entities.
 void AddTopLevelDeclarationToHash(Decl *D, unsigned &Hash) {
   if (!D)
@@ -818,10 +914,17 @@ void AddTopLevelDeclarationToHash(Decl *D, unsigned &Hash) {
 class TopLevelDeclTrackerConsumer : public ASTConsumer {
   ASTUnit &Unit;
   unsigned &Hash;
+  const SourceManager &SM;
+  const LangOptions &LangOpts;
+  ASTUnit::DeclBoundaries *Boundaries;
   
 public:
-  TopLevelDeclTrackerConsumer(ASTUnit &_Unit, unsigned &Hash)
-    : Unit(_Unit), Hash(Hash) {
+  TopLevelDeclTrackerConsumer(ASTUnit &_Unit, unsigned &Hash,
+                              const SourceManager &SM,
+                              const LangOptions &LangOpts,
+                              ASTUnit::DeclBoundaries *Boundaries)
+    : Unit(_Unit), Hash(Hash), SM(SM), LangOpts(LangOpts),
+      Boundaries(Boundaries) {
     Hash = 0;
   }
 
@@ -853,6 +956,8 @@ public:
   bool HandleTopLevelDecl(DeclGroupRef D) override {
     for (Decl *TopLevelDecl : D)
       handleTopLevelDecl(TopLevelDecl);
+    if (Boundaries)
+      AddTopLevelDeclEnd(D, SM, LangOpts, *Boundaries);
     return true;
   }
 
@@ -882,8 +987,14 @@ public:
     CI.getPreprocessor().addPPCallbacks(
         llvm::make_unique<MacroDefinitionTrackerPPCallbacks>(
                                            Unit.getCurrentTopLevelHashValue()));
+    ASTUnit::DeclBoundaries *Boundaries = Unit.getDeclBoundaries();
+    if (Boundaries)
+      CI.getPreprocessor().addPPCallbacks(
+          llvm::make_unique<DeclBoundaryPPCallbacks>(CI.getSourceManager(),
+                                                     *Boundaries));
     return llvm::make_unique<TopLevelDeclTrackerConsumer>(
-        Unit, Unit.getCurrentTopLevelHashValue());
+        Unit, Unit.getCurrentTopLevelHashValue(), CI.getSourceManager(),
+        CI.getLangOpts(), Boundaries);
   }
 
 public:
@@ -920,15 +1031,20 @@ class PrecompilePreambleConsumer : public PCHGenerator {
   std::vector<Decl *> TopLevelDecls;
   PrecompilePreambleAction *Action;
   raw_ostream *Out;
+  const SourceManager &SM;
+  const LangOptions &LangOpts;
+  ASTUnit::DeclBoundaries *Boundaries;
 
 public:
   PrecompilePreambleConsumer(ASTUnit &Unit, PrecompilePreambleAction *Action,
                              const Preprocessor &PP, StringRef isysroot,
-                             raw_ostream *Out)
+                             raw_ostream *Out,
+                             ASTUnit::DeclBoundaries *Boundaries)
       : PCHGenerator(PP, "", nullptr, isysroot, std::make_shared<PCHBuffer>(),
                      /*AllowASTWithErrors=*/true),
         Unit(Unit), Hash(Unit.getCurrentTopLevelHashValue()), Action(Action),
-        Out(Out) {
+        Out(Out), SM(PP.getSourceManager()), LangOpts(PP.getLangOpts()),
+        Boundaries(Boundaries) {
     Hash = 0;
   }
 
@@ -943,6 +1059,8 @@ public:
       AddTopLevelDeclarationToHash(D, Hash);
       TopLevelDecls.push_back(D);
     }
+    if (Boundaries)
+      AddTopLevelDeclEnd(DG, SM, LangOpts, *Boundaries);
     return true;
   }
 
@@ -991,8 +1109,13 @@ PrecompilePreambleAction::CreateASTConsumer(CompilerInstance &CI,
   CI.getPreprocessor().addPPCallbacks(
       llvm::make_unique<MacroDefinitionTrackerPPCallbacks>(
                                            Unit.getCurrentTopLevelHashValue()));
+  ASTUnit::DeclBoundaries *Boundaries = Unit.getDeclBoundaries();
+  if (Boundaries)
+    CI.getPreprocessor().addPPCallbacks(
+        llvm::make_unique<DeclBoundaryPPCallbacks>(CI.getSourceManager(),
+                                                   *Boundaries));
   return llvm::make_unique<PrecompilePreambleConsumer>(
-      Unit, this, CI.getPreprocessor(), Sysroot, OS);
+      Unit, this, CI.getPreprocessor(), Sysroot, OS, Boundaries);
 }
 
 static bool isNonDriverDiag(const StoredDiagnostic &StoredDiag) {
@@ -1127,6 +1250,14 @@ bool ASTUnit::Parse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
     SavedMainFileBuffer = std::move(OverrideMainBuffer);
   }
 
+  // The declaration boundaries past the preamble are recorded again while
+  // parsing the rest of the main file. A parse that does not record them
+  // drops them all, as they would no longer match the main file.
+  if (getDeclBoundaries())
+    Boundaries.dropAfter(SavedMainFileBuffer ? Preamble.size() : 0);
+  else
+    Boundaries = DeclBoundaries();
+
   std::unique_ptr<TopLevelDeclTrackerAction> Act(
       new TopLevelDeclTrackerAction(*this));
 
@@ -1146,6 +1277,10 @@ bool ASTUnit::Parse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
   if (!Act->Execute())
     goto error;
 
+  if (getDeclBoundaries())
+    Boundaries.Text =
+        getSourceManager().getBufferData(getSourceManager().getMainFileID());
+
   transferASTDataFromCompilerInstance(*Clang);
   
   Act->EndSourceFile();
@@ -1350,6 +1485,8 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
     = PreambleInvocation->getPreprocessorOpts();
 
   ComputedPreamble NewPreamble = ComputePreamble(*PreambleInvocation, MaxLines);
+  unsigned DirectivesSize = NewPreamble.Size;
+  extendPreambleOverUnchangedDecls(NewPreamble, AllowRebuild, MaxLines);
 
   if (!NewPreamble.Size) {
     // We couldn't find a preamble in the main source. Clear out the current
@@ -1488,6 +1625,7 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
                   NewPreamble.Buffer->getBufferStart(),
                   NewPreamble.Buffer->getBufferStart() + NewPreamble.Size);
   PreambleEndsAtStartOfLine = NewPreamble.PreambleEndsAtStartOfLine;
+  PreambleCoversDecls = NewPreamble.Size != DirectivesSize;
 
   PreambleBuffer = llvm::MemoryBuffer::getMemBufferCopy(
       NewPreamble.Buffer->getBuffer().slice(0, Preamble.size()), MainFilename);
@@ -1548,6 +1686,7 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   TopLevelDecls.clear();
   TopLevelDeclsInPreamble.clear();
   PreambleDiagnostics.clear();
+  Boundaries = DeclBoundaries();
 
   IntrusiveRefCntPtr<vfs::FileSystem> VFS =
       createVFSFromCompilerInvocation(Clang->getInvocation(), getDiagnostics());
@@ -1637,6 +1776,116 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
                                               MainFilename);
 }
 
+void ASTUnit::DeclBoundaries::dropAfter(unsigned Offset) {
+  DeclEnds.erase(std::upper_bound(DeclEnds.begin(), DeclEnds.end(), Offset),
+                 DeclEnds.end());
+  Conditionals.erase(
+      std::remove_if(Conditionals.begin(), Conditionals.end(),
+                     [=](const std::pair<unsigned, unsigned> &C) {
+                       return C.first >= Offset;
+                     }),
+      Conditionals.end());
+  Pragmas.erase(std::remove_if(Pragmas.begin(), Pragmas.end(),
+                               [=](unsigned P) { return P >= Offset; }),
+                Pragmas.end());
+}
+
+bool ASTUnit::DeclBoundaries::isSafeBoundary(unsigned Offset,
+                                             unsigned DirectivesSize) const {
+  // The preamble cannot end inside a conditional directive block.
+  for (const auto &C : Conditionals)
+    if (C.first < Offset && Offset <= C.second)
+      return false;
+
+  // Not all pragmas record their state in a precompiled header. Those within
+  // the preprocessor directives at the start of the file are part of any
+  // preamble, so only the others matter here.
+  for (unsigned P : Pragmas)
+    if (P >= DirectivesSize && P < Offset)
+      return false;
+
+  return true;
+}
+
+ASTUnit::DeclBoundaries *ASTUnit::getDeclBoundaries() {
+  // Only reparses that reuse unchanged declarations pay for recording them
+  // and for keeping a copy of the main file.
+  if (!ReuseUnchangedDecls)
+    return nullptr;
+  if (PreambleRebuildCounter > 0 || !getPreambleFile(this).empty())
+    return &Boundaries;
+  return nullptr;
+}
+
+/// \brief When reparsing with \c ReuseUnchangedDecls, extend the preamble
+/// past the preprocessor directives at the start of the main file over the
+/// top-level declarations that precede the first edit, so that they are
+/// loaded from the precompiled preamble rather than parsed again.
+///
+/// The declarations after the edit may depend on the edited one, so they
+/// are always parsed again.
+void ASTUnit::extendPreambleOverUnchangedDecls(ComputedPreamble &NewPreamble,
+                                               bool AllowRebuild,
+                                               unsigned MaxLines) {
+  if (!ReuseUnchangedDecls || !NewPreamble.Buffer || Boundaries.Text.empty())
+    return;
+
+  // Find the first byte that differs from the text for which the boundaries
+  // were recorded.
+  StringRef Text = NewPreamble.Buffer->getBuffer();
+  StringRef OldText = Boundaries.Text;
+  size_t CommonSize = std::min(Text.size(), OldText.size());
+  unsigned Unchanged =
+      std::mismatch(Text.begin(), Text.begin() + CommonSize, OldText.begin())
+          .first - Text.begin();
+  if (Unchanged != Text.size() || Text.size() != OldText.size())
+    LastChangeOffset = Unchanged;
+
+  // The preamble must end before the line that MaxLines excludes.
+  if (MaxLines) {
+    unsigned Line = 0;
+    for (unsigned I = 0; I != Unchanged; ++I) {
+      if (Text[I] == '\n' && ++Line == MaxLines) {
+        Unchanged = I + 1;
+        break;
+      }
+    }
+  }
+
+  // Keep the current preamble for as long as the declarations it covers are
+  // unchanged.
+  unsigned Current = 0;
+  if (PreambleCoversDecls && Preamble.size() > NewPreamble.Size &&
+      Preamble.size() <= Unchanged)
+    Current = Preamble.size();
+
+  // Edits tend to recur where the user last typed, so don't extend the
+  // preamble over the declaration that changed most recently.
+  unsigned Limit = std::min(Unchanged, LastChangeOffset);
+  unsigned Best = Current;
+  for (unsigned End : Boundaries.DeclEnds) {
+    if (End > Limit)
+      break;
+    if (End > Best && End > NewPreamble.Size &&
+        Boundaries.isSafeBoundary(End, NewPreamble.Size))
+      Best = End;
+  }
+
+  // Precompiling a larger preamble costs a parse of everything it covers, so
+  // only do so when that saves at least a quarter of the text that would
+  // otherwise be parsed on each reparse.
+  unsigned Size = Current;
+  if (AllowRebuild && Best > Current &&
+      (Best - Current) * 4 >= Text.size() - Current)
+    Size = Best;
+  if (!Size)
+    return;
+
+  NewPreamble.Size = Size;
+  NewPreamble.PreambleEndsAtStartOfLine =
+      Text[Size - 1] == '\n' || Text[Size - 1] == '\r';
+}
+
 void ASTUnit::RealizeTopLevelDeclsFromPreamble() {
   std::vector<Decl *> Resolved;
   Resolved.reserve(TopLevelDeclsInPreamble.size());
@@ -2015,11 +2264,13 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
 }
 
 bool ASTUnit::Reparse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-                      ArrayRef<RemappedFile> RemappedFiles) {
+                      ArrayRef<RemappedFile> RemappedFiles,
+                      bool ReuseUnchangedDecls) {
   if (!Invocation)
     return true;
 
   clearFileLevelDecls();
+  this->ReuseUnchangedDecls = ReuseUnchangedDecls;
   
   SimpleTimer ParsingTimer(WantTiming);
   ParsingTimer.setOutput("Reparsing " + getMainFileName());
@@ -2613,6 +2864,17 @@ void ASTUnit::findFileRegionDecls(FileID File, unsigned Offset, unsigned Length,
                                                          Decls);
   }
 
+  // The declarations in the part of the main file that is covered by the
+  // precompiled preamble were loaded from it.
+  if (PreambleCoversDecls && File == SourceMgr->getMainFileID() &&
+      Offset < Preamble.size() && SourceMgr->getPreambleFileID().isValid()) {
+    assert(Ctx->getExternalSource() && "No external source!");
+    unsigned PreambleLength = std::min<unsigned>(Length,
+                                                 Preamble.size() - Offset);
+    Ctx->getExternalSource()->FindFileRegionDecls(
+        SourceMgr->getPreambleFileID(), Offset, PreambleLength, Decls);
+  }
+
   FileDeclsTy::iterator I = FileDecls.find(File);
   if (I == FileDecls.end())
     return;
@@ -10,9 +10,13 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/ConstexprProfile.h"
 #include "clang/AST/Decl.h"
+#include "clang/Basic/CostReport.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/FileManager.h"
+#include "clang/Basic/PersistentStatCache.h"
+#include "clang/Basic/PhaseProfile.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Basic/Version.h"
@@ -27,6 +31,7 @@
 #include "clang/Frontend/Utils.h"
 #include "clang/Frontend/VerifyDiagnosticConsumer.h"
 #include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/IncludeGuardDatabase.h"
 #include "clang/Lex/PTHManager.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Sema/CodeCompleteConsumer.h"
@@ -55,9 +60,9 @@ CompilerInstance::CompilerInstance(
     std::shared_ptr<PCHContainerOperations> PCHContainerOps,
     bool BuildingModule)
     : ModuleLoader(BuildingModule), Invocation(new CompilerInvocation()),
-      ModuleManager(nullptr), ThePCHContainerOperations(PCHContainerOps),
-      BuildGlobalModuleIndex(false), HaveFullGlobalModuleIndex(false),
-      ModuleBuildFailed(false) {}
+      StatCache(nullptr), ModuleManager(nullptr),
+      ThePCHContainerOperations(PCHContainerOps), BuildGlobalModuleIndex(false),
+      HaveFullGlobalModuleIndex(false), ModuleBuildFailed(false) {}
 
 CompilerInstance::~CompilerInstance() {
   assert(OutputFiles.empty() && "Still output files in flight?");
@@ -84,6 +89,7 @@ void CompilerInstance::setTarget(TargetInfo *Value) {
 
 void CompilerInstance::setFileManager(FileManager *Value) {
   FileMgr = Value;
+  StatCache = nullptr;
   if (Value)
     VirtualFileSystem = Value->getVirtualFileSystem();
   else
@@ -227,6 +233,15 @@ void CompilerInstance::createFileManager() {
     setVirtualFileSystem(vfs::getRealFileSystem());
   }
   FileMgr = new FileManager(getFileSystemOpts(), VirtualFileSystem);
+  StatCache = nullptr;
+
+  const FileSystemOptions &FSOpts = getFileSystemOpts();
+  if (!FSOpts.StatCachePath.empty()) {
+    std::unique_ptr<PersistentStatCache> Cache =
+        PersistentStatCache::load(FSOpts.StatCachePath, FSOpts.RecordStatCache);
+    StatCache = Cache.get();
+    FileMgr->addStatCache(std::move(Cache));
+  }
 }
 
 // Source Manager
@@ -305,6 +320,9 @@ void CompilerInstance::createPreprocessor(TranslationUnitKind TUKind) {
                         getSourceManager(), *HeaderInfo, *this, PTHMgr,
                         /*OwnsHeaderSearch=*/true, TUKind);
   PP->Initialize(getTarget());
+  PP->setPhaseProfile(Profile.get());
+  if (Costs)
+    AttachHeaderCostTracker(*PP, *Costs);
 
   // Note that this is different then passing PTHMgr to Preprocessor's ctor.
   // That argument is used as the IdentifierInfoLookup argument to
@@ -334,6 +352,11 @@ void CompilerInstance::createPreprocessor(TranslationUnitKind TUKind) {
   if (PP->getLangOpts().Modules)
     PP->getHeaderSearchInfo().setModuleCachePath(getSpecificModuleCachePath());
 
+  if (!getHeaderSearchOpts().IncludeGuardDatabasePath.empty())
+    PP->getHeaderSearchInfo().setIncludeGuardDatabase(
+        IncludeGuardDatabase::load(
+            getHeaderSearchOpts().IncludeGuardDatabasePath));
+
   // Handle generating dependencies, if requested.
   const DependencyOutputOptions &DepOpts = getDependencyOutputOpts();
   if (!DepOpts.OutputFile.empty())
@@ -387,6 +410,8 @@ void CompilerInstance::createASTContext() {
                            PP.getIdentifierTable(), PP.getSelectorTable(),
                            PP.getBuiltinInfo());
   Context->InitBuiltinTypes(getTarget());
+  Context->setCostReport(Costs.get());
+  Context->setConstexprProfile(ConstexprProf.get());
 }
 
 // ExternalASTSource
@@ -806,6 +831,21 @@ bool CompilerInstance::ExecuteAction(FrontendAction &Act) {
   if (getFrontendOpts().ShowTimers)
     createFrontendTimer();
 
+  if (!getFrontendOpts().TimeReportJSONPath.empty())
+    Profile.reset(new PhaseProfile());
+
+  // The preprocessor callbacks and the AST context of an earlier action may
+  // still refer to the report, so reuse it rather than replacing it.
+  if (!getFrontendOpts().CostReportPath.empty()) {
+    if (Costs)
+      Costs->reset();
+    else
+      Costs.reset(new CostReport());
+  }
+
+  if (getFrontendOpts().ShowConstexprProfile)
+    ConstexprProf.reset(new ConstexprProfile());
+
   if (getFrontendOpts().ShowStats)
     llvm::EnableStatistics();
 
@@ -821,6 +861,45 @@ bool CompilerInstance::ExecuteAction(FrontendAction &Act) {
     }
   }
 
+  if (StatCache && getFileSystemOpts().RecordStatCache) {
+    std::string ErrorMsg;
+    if (StatCache->writeToFile(getFileSystemOpts().StatCachePath,
+                               getVirtualFileSystem(), ErrorMsg))
+      getDiagnostics().Report(diag::warn_fe_stat_cache_write_failure)
+          << getFileSystemOpts().StatCachePath << ErrorMsg;
+  }
+
+  if (Profile) {
+    std::string ErrorMsg;
+    const std::string &Path = getFrontendOpts().TimeReportJSONPath;
+    StringRef InputFile = getFrontendOpts().Inputs.empty()
+                              ? StringRef()
+                              : getFrontendOpts().Inputs[0].getFile();
+    if (Profile->writeJSON(Path, InputFile, ErrorMsg))
+      getDiagnostics().Report(diag::warn_fe_time_report_write_failure)
+          << Path << ErrorMsg;
+    if (hasPreprocessor())
+      getPreprocessor().setPhaseProfile(nullptr);
+    Profile.reset();
+  }
+
+  if (Costs && !getFrontendOpts().CostReportPath.empty()) {
+    // The main file is never left, so charge the time so far to it.
+    Costs->exitAll();
+    std::string ErrorMsg;
+    const std::string &Path = getFrontendOpts().CostReportPath;
+    StringRef InputFile = getFrontendOpts().Inputs.empty()
+                              ? StringRef()
+                              : getFrontendOpts().Inputs[0].getFile();
+    if (Costs->writeJSON(Path, InputFile, getFrontendOpts().CostReportLimit,
+                         ErrorMsg))
+      getDiagnostics().Report(diag::warn_fe_cost_report_write_failure)
+          << Path << ErrorMsg;
+    // Don't charge anything done by a later action on this instance to the
+    // entities of this one.
+    Costs->reset();
+  }
+
   // Notify the diagnostic client that all files were processed.
   getDiagnostics().getClient()->finish();
 
@@ -842,6 +921,8 @@ bool CompilerInstance::ExecuteAction(FrontendAction &Act) {
 
   if (getFrontendOpts().ShowStats && hasFileManager()) {
     getFileManager().PrintStats();
+    if (StatCache)
+      StatCache->PrintStats();
     OS << "\n";
   }
 
@@ -911,6 +992,9 @@ static bool compileModuleImpl(CompilerInstance &ImportingInstance,
   FrontendOpts.OutputFile = ModuleFileName.str();
   FrontendOpts.DisableFree = false;
   FrontendOpts.GenerateGlobalModuleIndex = false;
+  FrontendOpts.TimeReportJSONPath.clear();
+  FrontendOpts.CostReportPath.clear();
+  FrontendOpts.ShowConstexprProfile = false;
   FrontendOpts.Inputs.clear();
   InputKind IK = getSourceInputKindFromOptions(*Invocation->getLangOpts());
 
@@ -982,8 +1066,13 @@ static bool compileModuleImpl(CompilerInstance &ImportingInstance,
   // thread so that we get a stack large enough.
   const unsigned ThreadStackSize = 8 << 20;
   llvm::CrashRecoveryContext CRC;
-  CRC.RunSafelyOnThread([&]() { Instance.ExecuteAction(CreateModuleAction); },
-                        ThreadStackSize);
+  {
+    PhaseProfile::Region ProfileRegion(ImportingInstance.getPhaseProfile(),
+                                       PhaseProfile::ModuleBuilding);
+    CRC.RunSafelyOnThread(
+        [&]() { Instance.ExecuteAction(CreateModuleAction); },
+        ThreadStackSize);
+  }
 
   ImportingInstance.getDiagnostics().Report(ImportLoc,
                                             diag::remark_module_build_done)
@@ -1250,6 +1339,14 @@ void CompilerInstance::createModuleManager() {
         HSOpts.ModulesValidateSystemHeaders,
         getFrontendOpts().UseGlobalModuleIndex,
         std::move(ReadTimer));
+    if (HSOpts.ModulesPrefetchThreads > 1) {
+      std::unique_ptr<llvm::Timer> PrefetchTimer;
+      if (FrontendTimerGroup)
+        PrefetchTimer = llvm::make_unique<llvm::Timer>(
+            "Prefetching module files", *FrontendTimerGroup);
+      ModuleManager->setModuleFilePrefetching(HSOpts.ModulesPrefetchThreads,
+                                              std::move(PrefetchTimer));
+    }
     if (hasASTConsumer()) {
       ModuleManager->setDeserializationListener(
         getASTConsumer().GetASTDeserializationListener());
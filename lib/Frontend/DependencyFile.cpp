@@ -50,7 +50,19 @@ struct DepCollectorPPCallbacks : public PPCallbacks {
     if (!FE)
       return;
 
-    StringRef Filename = FE->getName();
+    addFileDependency(*FE, FileType);
+  }
+
+  void FileSkipped(const FileEntry &SkippedFile, const Token &FilenameTok,
+                   SrcMgr::CharacteristicKind FileType) override {
+    // A header can be skipped without ever being entered, e.g. when its
+    // include guard is known from the include guard database.
+    addFileDependency(SkippedFile, FileType);
+  }
+
+  void addFileDependency(const FileEntry &FE,
+                         SrcMgr::CharacteristicKind FileType) {
+    StringRef Filename = FE.getName();
 
     // Remove leading "./" (or ".//" or "././" etc.)
     while (Filename.size() > 2 && Filename[0] == '.' &&
@@ -170,6 +182,8 @@ public:
   void FileChanged(SourceLocation Loc, FileChangeReason Reason,
                    SrcMgr::CharacteristicKind FileType,
                    FileID PrevFID) override;
+  void FileSkipped(const FileEntry &SkippedFile, const Token &FilenameTok,
+                   SrcMgr::CharacteristicKind FileType) override;
   void InclusionDirective(SourceLocation HashLoc, const Token &IncludeTok,
                           StringRef FileName, bool IsAngled,
                           CharSourceRange FilenameRange, const FileEntry *File,
@@ -181,6 +195,7 @@ public:
   }
 
   void AddFilename(StringRef Filename);
+  void AddFileEntry(const FileEntry &FE, SrcMgr::CharacteristicKind FileType);
   bool includeSystemHeaders() const { return IncludeSystemHeaders; }
   bool includeModuleFiles() const { return IncludeModuleFiles; }
 };
@@ -255,7 +270,21 @@ void DFGImpl::FileChanged(SourceLocation Loc,
     SM.getFileEntryForID(SM.getFileID(SM.getExpansionLoc(Loc)));
   if (!FE) return;
 
-  StringRef Filename = FE->getName();
+  AddFileEntry(*FE, FileType);
+}
+
+void DFGImpl::FileSkipped(const FileEntry &SkippedFile,
+                          const Token &FilenameTok,
+                          SrcMgr::CharacteristicKind FileType) {
+  // A header skipped by the multiple-include optimization has usually been
+  // entered before, but one whose include guard came from the include guard
+  // database never is.
+  AddFileEntry(SkippedFile, FileType);
+}
+
+void DFGImpl::AddFileEntry(const FileEntry &FE,
+                           SrcMgr::CharacteristicKind FileType) {
+  StringRef Filename = FE.getName();
   if (!FileMatchesDepCriteria(Filename.data(), FileType))
     return;
 
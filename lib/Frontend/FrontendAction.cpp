@@ -10,7 +10,9 @@
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/ConstexprProfile.h"
 #include "clang/AST/DeclGroup.h"
+#include "clang/Basic/PhaseProfile.h"
 #include "clang/Frontend/ASTUnit.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
@@ -429,22 +431,63 @@ bool FrontendAction::BeginSourceFile(CompilerInstance &CI,
   return false;
 }
 
+/// \brief Add the sizes of what the compilation of the current file read and
+/// built to the counters of \p Profile.
+static void addStatsToProfile(CompilerInstance &CI, PhaseProfile &Profile) {
+  if (CI.hasPreprocessor())
+    CI.getPreprocessor().addStatsToProfile(Profile);
+
+  if (CI.hasASTContext()) {
+    ASTContext &Ctx = CI.getASTContext();
+    Profile.addCounter("decls", Ctx.getNumDeclsCreated());
+    Profile.addCounter("decls-deserialized", Ctx.getNumDeclsDeserialized());
+    Profile.addCounter("types", Ctx.getTypes().size());
+  }
+
+  if (CI.hasSourceManager()) {
+    SourceManager &SM = CI.getSourceManager();
+    uint64_t Bytes = 0;
+    for (SourceManager::fileinfo_iterator I = SM.fileinfo_begin(),
+                                          E = SM.fileinfo_end();
+         I != E; ++I)
+      if (llvm::MemoryBuffer *Buffer = I->second->getRawBuffer())
+        Bytes += Buffer->getBufferSize();
+    Profile.addCounter("source-bytes-read", Bytes);
+  }
+
+  if (IntrusiveRefCntPtr<ASTReader> Reader = CI.getModuleManager()) {
+    uint64_t Bytes = 0;
+    for (ModuleFile *M : Reader->getModuleManager())
+      if (M->Buffer)
+        Bytes += M->Buffer->getBufferSize();
+    Profile.addCounter("module-bytes-read", Bytes);
+  }
+}
+
 bool FrontendAction::Execute() {
   CompilerInstance &CI = getCompilerInstance();
 
-  if (CI.hasFrontendTimer()) {
-    llvm::TimeRegion Timer(CI.getFrontendTimer());
-    ExecuteAction();
+  {
+    PhaseProfile::Region ProfileRegion(CI.getPhaseProfile(),
+                                       PhaseProfile::Frontend);
+    if (CI.hasFrontendTimer()) {
+      llvm::TimeRegion Timer(CI.getFrontendTimer());
+      ExecuteAction();
+    }
+    else ExecuteAction();
   }
-  else ExecuteAction();
 
   // If we are supposed to rebuild the global module index, do so now unless
   // there were any module-build failures.
   if (CI.shouldBuildGlobalModuleIndex() && CI.hasFileManager() &&
       CI.hasPreprocessor()) {
-    GlobalModuleIndex::writeIndex(
-        CI.getFileManager(), CI.getPCHContainerReader(),
-        CI.getPreprocessor().getHeaderSearchInfo().getModuleCachePath());
+    unsigned NumRead, NumReused;
+    if (GlobalModuleIndex::writeIndex(
+            CI.getFileManager(), CI.getPCHContainerReader(),
+            CI.getPreprocessor().getHeaderSearchInfo().getModuleCachePath(),
+            &NumRead, &NumReused) == GlobalModuleIndex::EC_None)
+      CI.getDiagnostics().Report(diag::remark_module_index_written)
+          << NumRead << NumReused;
   }
 
   return true;
@@ -460,6 +503,32 @@ void FrontendAction::EndSourceFile() {
   if (CI.hasPreprocessor())
     CI.getPreprocessor().EndSourceFile();
 
+  // Record the include guards of the headers of this file for later
+  // compilations. Errors may have stopped lexing in the middle of a header,
+  // so only do this for successful compilations.
+  const HeaderSearchOptions &HSOpts = CI.getHeaderSearchOpts();
+  if (CI.hasPreprocessor() && HSOpts.RecordIncludeGuardDatabase &&
+      !HSOpts.IncludeGuardDatabasePath.empty() &&
+      !CI.getDiagnostics().hasErrorOccurred()) {
+    std::string ErrorMsg;
+    if (CI.getPreprocessor().getHeaderSearchInfo().writeIncludeGuardDatabase(
+            HSOpts.IncludeGuardDatabasePath, ErrorMsg))
+      CI.getDiagnostics().Report(
+          diag::warn_fe_include_guard_database_write_failure)
+          << HSOpts.IncludeGuardDatabasePath << ErrorMsg;
+  }
+
+  if (PhaseProfile *Profile = CI.getPhaseProfile())
+    addStatsToProfile(CI, *Profile);
+
+  // The profile refers to the declarations of this file, so print it before
+  // they go away.
+  if (ConstexprProfile *Profile = CI.getConstexprProfile()) {
+    if (CI.hasASTContext())
+      Profile->print(llvm::errs(), CI.getASTContext().getPrintingPolicy());
+    Profile->clear();
+  }
+
   // Finalize the action.
   EndSourceFileAction();
 
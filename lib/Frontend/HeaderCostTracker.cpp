@@ -0,0 +1,50 @@
+//===--- HeaderCostTracker.cpp - Charge compile time to headers -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/Utils.h"
+#include "clang/Basic/CostReport.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Preprocessor.h"
+using namespace clang;
+
+namespace {
+/// Enters a header entity of the cost report for every file the preprocessor
+/// enters, so that the time until the file is left is charged to it.
+class HeaderCostCallback : public PPCallbacks {
+  SourceManager &SM;
+  CostReport &Report;
+  /// The number of files currently entered.
+  unsigned Depth;
+
+public:
+  HeaderCostCallback(const Preprocessor &PP, CostReport &Report)
+      : SM(PP.getSourceManager()), Report(Report), Depth(0) {}
+
+  void FileChanged(SourceLocation Loc, FileChangeReason Reason,
+                   SrcMgr::CharacteristicKind FileType,
+                   FileID PrevFID) override;
+};
+}
+
+void clang::AttachHeaderCostTracker(Preprocessor &PP, CostReport &Report) {
+  PP.addPPCallbacks(llvm::make_unique<HeaderCostCallback>(PP, Report));
+}
+
+void HeaderCostCallback::FileChanged(SourceLocation Loc,
+                                     FileChangeReason Reason,
+                                     SrcMgr::CharacteristicKind FileType,
+                                     FileID PrevFID) {
+  if (Reason == PPCallbacks::EnterFile) {
+    ++Depth;
+    Report.enter(CostReport::Header, SM.getBufferName(Loc));
+  } else if (Reason == PPCallbacks::ExitFile && Depth) {
+    --Depth;
+    Report.exit(CostReport::Header);
+  }
+}
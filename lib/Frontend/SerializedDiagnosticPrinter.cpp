@@ -22,8 +22,12 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <vector>
 
 using namespace clang;
@@ -52,6 +56,25 @@ public:
 typedef SmallVector<uint64_t, 64> RecordData;
 typedef SmallVectorImpl<uint64_t> RecordDataImpl;
 
+/// \brief The location, file, category and level of a top-level diagnostic,
+/// as listed in the index block.
+struct IndexEntry {
+  uint64_t BitOffset;
+  unsigned File;
+  unsigned Category;
+  unsigned Level;
+  explicit IndexEntry(uint64_t BitOffset)
+      : BitOffset(BitOffset), File(0), Category(0), Level(0) {}
+};
+
+/// \brief The number of buffered bytes above which the stream is written out
+/// after the next top-level diagnostic.
+static const unsigned StreamFlushThreshold = 64 * 1024;
+
+/// \brief The number of index entries above which they are written out in
+/// an INDEX block after the next top-level diagnostic.
+static const unsigned IndexChunkSize = 4096;
+
 class SDiagsWriter;
   
 class SDiagsRenderer : public DiagnosticNoteRenderer {
@@ -155,6 +178,7 @@ public:
         State(new SharedState(File, Diags)) {
     if (MergeChildRecords)
       RemoveOldDiagnostics();
+    OpenOutputFile();
     EmitPreamble();
   }
 
@@ -178,6 +202,17 @@ private:
   /// merge into our own.
   void RemoveOldDiagnostics();
 
+  /// \brief Open the temporary file the diagnostics are streamed to.
+  void OpenOutputFile();
+
+  /// \brief Write the buffered part of the stream to the temporary file.
+  void FlushBuffer();
+
+  /// \brief Return the bit offset of the end of the stream in the file.
+  uint64_t GetCurrentBitNo() const {
+    return State->FlushedBytes * 8 + State->Stream.GetCurrentBitNo();
+  }
+
   /// \brief Emit the preamble for the serialized diagnostics.
   void EmitPreamble();
   
@@ -187,6 +222,29 @@ private:
   /// \brief Emit the META data block.
   void EmitMetaBlock();
 
+  /// \brief Emit an INDEX block with the pending index entries, and return
+  /// its bit offset. The \p Last block, at the end of the stream, also lists
+  /// all files, categories and flags.
+  uint64_t EmitIndexBlock(bool Last);
+
+  /// \brief Emit the names of all files, categories and flags in the last
+  /// INDEX block.
+  void EmitIndexNames();
+
+  /// \brief Write the location of the last index block into the META block,
+  /// if the file has an index, and move the temporary file to the output
+  /// file.
+  void CommitOutputFile(uint64_t IndexBitNo);
+
+  /// \brief Whether the diagnostics are indexed.
+  bool IsIndexed() const {
+    return State->DiagOpts->SerializeDiagnosticsIndex;
+  }
+
+  /// \brief Describe the top-level diagnostic being emitted in the index, if
+  /// \p Level, \p File and \p Category are from its first DIAG record.
+  void AddDiagToIndex(unsigned Level, unsigned File, unsigned Category);
+
   /// \brief Start a DIAG block.
   void EnterDiagBlock();
 
@@ -255,12 +313,14 @@ private:
   struct SharedState : RefCountedBase<SharedState> {
     SharedState(StringRef File, DiagnosticOptions *Diags)
         : DiagOpts(Diags), Stream(Buffer), OutputFile(File.str()),
-          EmittedAnyDiagBlocks(false) {}
+          FlushedBytes(0), IndexLocationBitNo(0), PreviousIndexBitNo(0),
+          DiagDepth(0), PendingIndexEntry(false), EmittedAnyDiagBlocks(false) {}
 
     /// \brief Diagnostic options.
     IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts;
 
-    /// \brief The byte buffer for the serialized content.
+    /// \brief The byte buffer for the serialized content that has not been
+    /// written to the temporary file yet.
     SmallString<1024> Buffer;
 
     /// \brief The BitStreamWriter for the serialized diagnostics.
@@ -269,9 +329,42 @@ private:
     /// \brief The name of the diagnostics file.
     std::string OutputFile;
 
+    /// \brief The temporary file the stream is written to as it grows, which
+    /// replaces the diagnostics file once it is complete.
+    std::string TempFile;
+
+    /// \brief The stream for \c TempFile, or null if it could not be opened.
+    std::unique_ptr<llvm::raw_fd_ostream> OS;
+
+    /// \brief The number of bytes of the stream written to \c TempFile.
+    uint64_t FlushedBytes;
+
+    /// \brief The bit offset of the placeholder for the location of the index
+    /// block in the META block, and the bytes it spans.
+    uint64_t IndexLocationBitNo;
+    SmallString<16> IndexLocationBytes;
+
     /// \brief The set of constructed record abbreviations.
     AbbreviationMap Abbrevs;
 
+    /// \brief The record abbreviations of the INDEX block.
+    AbbreviationMap IndexAbbrevs;
+
+    /// \brief The top-level diagnostics emitted since the last INDEX block.
+    /// At most \c IndexChunkSize of them are kept in memory.
+    std::vector<IndexEntry> Index;
+
+    /// \brief The bit offset of the last INDEX block, or zero if none has
+    /// been emitted yet.
+    uint64_t PreviousIndexBitNo;
+
+    /// \brief The nesting depth of the DIAG block being emitted.
+    unsigned DiagDepth;
+
+    /// \brief Whether the last entry of \c Index still has to be described
+    /// by the first DIAG record of its block.
+    bool PendingIndexEntry;
+
     /// \brief A utility buffer for constructing record content.
     RecordData Record;
 
@@ -282,13 +375,10 @@ private:
     llvm::DenseSet<unsigned> Categories;
 
     /// \brief The collection of files used.
-    llvm::DenseMap<const char *, unsigned> Files;
-
-    typedef llvm::DenseMap<const void *, std::pair<unsigned, StringRef> >
-    DiagFlagsTy;
+    llvm::StringMap<unsigned> Files;
 
-    /// \brief Map for uniquing strings.
-    DiagFlagsTy DiagFlags;
+    /// \brief Map for uniquing diagnostic flags.
+    llvm::StringMap<unsigned> DiagFlags;
 
     /// \brief Whether we have already started emission of any DIAG blocks. Once
     /// this becomes \c true, we never close a DIAG block until we know that we're
@@ -387,7 +477,7 @@ unsigned SDiagsWriter::getEmitFile(const char *FileName){
   if (!FileName)
     return 0;
   
-  unsigned &entry = State->Files[FileName];
+  unsigned &entry = State->Files[StringRef(FileName)];
   if (entry)
     return entry;
   
@@ -440,6 +530,41 @@ static void AddRangeLocationAbbrev(llvm::BitCodeAbbrev *Abbrev) {
   AddSourceLocationAbbrev(Abbrev);  
 }
 
+/// \brief Create the abbreviation for RECORD_CATEGORY.
+static llvm::BitCodeAbbrev *CreateCategoryAbbrev() {
+  using namespace llvm;
+  BitCodeAbbrev *Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_CATEGORY));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Category ID.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 8));  // Text size.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob));      // Category text.
+  return Abbrev;
+}
+
+/// \brief Create the abbreviation for RECORD_DIAG_FLAG.
+static llvm::BitCodeAbbrev *CreateDiagFlagAbbrev() {
+  using namespace llvm;
+  BitCodeAbbrev *Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_DIAG_FLAG));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 10)); // Mapped Diag ID.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Text size.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // Flag name text.
+  return Abbrev;
+}
+
+/// \brief Create the abbreviation for RECORD_FILENAME.
+static llvm::BitCodeAbbrev *CreateFilenameAbbrev() {
+  using namespace llvm;
+  BitCodeAbbrev *Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_FILENAME));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 10)); // Mapped file ID.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Size.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Modifcation time.  
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Text size.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // File name text.
+  return Abbrev;
+}
+
 void SDiagsWriter::EmitBlockInfoBlock() {
   State->Stream.EnterBlockInfoBlock(3);
 
@@ -459,6 +584,14 @@ void SDiagsWriter::EmitBlockInfoBlock() {
   Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32));
   Abbrevs.set(RECORD_VERSION, Stream.EmitBlockInfoAbbrev(BLOCK_META, Abbrev));
 
+  EmitRecordID(RECORD_INDEX_LOCATION, "IndexLocation", Stream, Record);
+  Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_INDEX_LOCATION));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (low).
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (high).
+  Abbrevs.set(RECORD_INDEX_LOCATION,
+              Stream.EmitBlockInfoAbbrev(BLOCK_META, Abbrev));
+
   // ==---------------------------------------------------------------------==//
   // The subsequent records and Abbrevs are for the "Diagnostic" block.
   // ==---------------------------------------------------------------------==//
@@ -483,12 +616,8 @@ void SDiagsWriter::EmitBlockInfoBlock() {
   Abbrevs.set(RECORD_DIAG, Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, Abbrev));
   
   // Emit abbrevation for RECORD_CATEGORY.
-  Abbrev = new BitCodeAbbrev();
-  Abbrev->Add(BitCodeAbbrevOp(RECORD_CATEGORY));
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Category ID.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 8));  // Text size.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob));      // Category text.
-  Abbrevs.set(RECORD_CATEGORY, Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, Abbrev));
+  Abbrevs.set(RECORD_CATEGORY,
+              Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, CreateCategoryAbbrev()));
 
   // Emit abbrevation for RECORD_SOURCE_RANGE.
   Abbrev = new BitCodeAbbrev();
@@ -498,24 +627,12 @@ void SDiagsWriter::EmitBlockInfoBlock() {
               Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, Abbrev));
   
   // Emit the abbreviation for RECORD_DIAG_FLAG.
-  Abbrev = new BitCodeAbbrev();
-  Abbrev->Add(BitCodeAbbrevOp(RECORD_DIAG_FLAG));
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 10)); // Mapped Diag ID.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Text size.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // Flag name text.
-  Abbrevs.set(RECORD_DIAG_FLAG, Stream.EmitBlockInfoAbbrev(BLOCK_DIAG,
-                                                           Abbrev));
+  Abbrevs.set(RECORD_DIAG_FLAG,
+              Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, CreateDiagFlagAbbrev()));
   
   // Emit the abbreviation for RECORD_FILENAME.
-  Abbrev = new BitCodeAbbrev();
-  Abbrev->Add(BitCodeAbbrevOp(RECORD_FILENAME));
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 10)); // Mapped file ID.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Size.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Modifcation time.  
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Text size.
-  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // File name text.
-  Abbrevs.set(RECORD_FILENAME, Stream.EmitBlockInfoAbbrev(BLOCK_DIAG,
-                                                          Abbrev));
+  Abbrevs.set(RECORD_FILENAME,
+              Stream.EmitBlockInfoAbbrev(BLOCK_DIAG, CreateFilenameAbbrev()));
   
   // Emit the abbreviation for RECORD_FIXIT.
   Abbrev = new BitCodeAbbrev();
@@ -526,6 +643,44 @@ void SDiagsWriter::EmitBlockInfoBlock() {
   Abbrevs.set(RECORD_FIXIT, Stream.EmitBlockInfoAbbrev(BLOCK_DIAG,
                                                        Abbrev));
 
+  // ==---------------------------------------------------------------------==//
+  // The subsequent records and Abbrevs are for the "Index" block.
+  // ==---------------------------------------------------------------------==//
+
+  EmitBlockID(BLOCK_INDEX, "Index", Stream, Record);
+  EmitRecordID(RECORD_CATEGORY, "CatName", Stream, Record);
+  EmitRecordID(RECORD_DIAG_FLAG, "DiagFlag", Stream, Record);
+  EmitRecordID(RECORD_FILENAME, "FileName", Stream, Record);
+  EmitRecordID(RECORD_INDEX_ENTRY, "IndexEntry", Stream, Record);
+  EmitRecordID(RECORD_INDEX_PREVIOUS, "IndexPrevious", Stream, Record);
+
+  AbbreviationMap &IndexAbbrevs = State->IndexAbbrevs;
+  IndexAbbrevs.set(RECORD_CATEGORY, Stream.EmitBlockInfoAbbrev(
+                                        BLOCK_INDEX, CreateCategoryAbbrev()));
+  IndexAbbrevs.set(RECORD_DIAG_FLAG, Stream.EmitBlockInfoAbbrev(
+                                         BLOCK_INDEX, CreateDiagFlagAbbrev()));
+  IndexAbbrevs.set(RECORD_FILENAME, Stream.EmitBlockInfoAbbrev(
+                                        BLOCK_INDEX, CreateFilenameAbbrev()));
+
+  // Emit the abbreviation for RECORD_INDEX_ENTRY.
+  Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_INDEX_ENTRY));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (low).
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (high).
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 10)); // File ID.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 16)); // Category.
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 3));  // Diag level.
+  IndexAbbrevs.set(RECORD_INDEX_ENTRY,
+                   Stream.EmitBlockInfoAbbrev(BLOCK_INDEX, Abbrev));
+
+  // Emit the abbreviation for RECORD_INDEX_PREVIOUS.
+  Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_INDEX_PREVIOUS));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (low).
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Offset (high).
+  IndexAbbrevs.set(RECORD_INDEX_PREVIOUS,
+                   Stream.EmitBlockInfoAbbrev(BLOCK_INDEX, Abbrev));
+
   Stream.ExitBlock();
 }
 
@@ -537,9 +692,132 @@ void SDiagsWriter::EmitMetaBlock() {
   Stream.EnterSubblock(BLOCK_META, 3);
   Record.clear();
   Record.push_back(RECORD_VERSION);
-  Record.push_back(VersionNumber);
+  Record.push_back(IsIndexed() ? VersionNumber : UnindexedVersionNumber);
   Stream.EmitRecordWithAbbrev(Abbrevs.get(RECORD_VERSION), Record);  
+  if (!IsIndexed()) {
+    Stream.ExitBlock();
+    return;
+  }
+
+  // Leave a placeholder for the location of the index block, which is known
+  // once the file is complete. Its fields follow the 3-bit abbreviation ID.
+  Record.clear();
+  Record.push_back(RECORD_INDEX_LOCATION);
+  Record.push_back(0);
+  Record.push_back(0);
+  State->IndexLocationBitNo = GetCurrentBitNo() + 3;
+  Stream.EmitRecordWithAbbrev(Abbrevs.get(RECORD_INDEX_LOCATION), Record);
+  Stream.ExitBlock();
+
+  // Nothing has been written out yet, so the placeholder is still buffered.
+  assert(State->FlushedBytes == 0 && "Stream flushed before the META block");
+  unsigned Begin = State->IndexLocationBitNo / 8;
+  unsigned End = (State->IndexLocationBitNo + 64 + 7) / 8;
+  State->IndexLocationBytes.assign(State->Buffer.begin() + Begin,
+                                   State->Buffer.begin() + End);
+}
+
+uint64_t SDiagsWriter::EmitIndexBlock(bool Last) {
+  llvm::BitstreamWriter &Stream = State->Stream;
+  AbbreviationMap &Abbrevs = State->IndexAbbrevs;
+  RecordData Record;
+
+  uint64_t IndexBitNo = GetCurrentBitNo();
+  Stream.EnterSubblock(BLOCK_INDEX, 3);
+
+  // The INDEX blocks form a chain, which readers follow back from the last.
+  if (State->PreviousIndexBitNo) {
+    Record.push_back(RECORD_INDEX_PREVIOUS);
+    Record.push_back(State->PreviousIndexBitNo & 0xffffffff);
+    Record.push_back(State->PreviousIndexBitNo >> 32);
+    Stream.EmitRecordWithAbbrev(Abbrevs.get(RECORD_INDEX_PREVIOUS), Record);
+  }
+
+  if (Last)
+    EmitIndexNames();
+
+  // The entries are grouped by file, so that the diagnostics of each file
+  // form one contiguous shard, ordered by location in the stream.
+  std::stable_sort(State->Index.begin(), State->Index.end(),
+                   [](const IndexEntry &A, const IndexEntry &B) {
+    return A.File < B.File;
+  });
+  for (const IndexEntry &Entry : State->Index) {
+    Record.clear();
+    Record.push_back(RECORD_INDEX_ENTRY);
+    Record.push_back(Entry.BitOffset & 0xffffffff);
+    Record.push_back(Entry.BitOffset >> 32);
+    Record.push_back(Entry.File);
+    Record.push_back(Entry.Category);
+    Record.push_back(Entry.Level);
+    Stream.EmitRecordWithAbbrev(Abbrevs.get(RECORD_INDEX_ENTRY), Record);
+  }
+
   Stream.ExitBlock();
+  State->Index.clear();
+  State->PreviousIndexBitNo = IndexBitNo;
+  return IndexBitNo;
+}
+
+void SDiagsWriter::EmitIndexNames() {
+  llvm::BitstreamWriter &Stream = State->Stream;
+  AbbreviationMap &Abbrevs = State->IndexAbbrevs;
+  RecordData Record;
+
+  // The names of all files, categories and flags, as their records are only
+  // emitted in the first diagnostic that uses them.
+  SmallVector<std::pair<unsigned, StringRef>, 16> Names;
+  for (const auto &File : State->Files)
+    Names.push_back(std::make_pair(File.second, File.first()));
+  std::sort(Names.begin(), Names.end());
+  for (const auto &Name : Names) {
+    Record.clear();
+    Record.push_back(RECORD_FILENAME);
+    Record.push_back(Name.first);
+    Record.push_back(0); // For legacy.
+    Record.push_back(0); // For legacy.
+    Record.push_back(Name.second.size());
+    Stream.EmitRecordWithBlob(Abbrevs.get(RECORD_FILENAME), Record,
+                              Name.second);
+  }
+
+  SmallVector<unsigned, 16> Categories(State->Categories.begin(),
+                                       State->Categories.end());
+  std::sort(Categories.begin(), Categories.end());
+  for (unsigned Category : Categories) {
+    StringRef Name = DiagnosticIDs::getCategoryNameFromID(Category);
+    Record.clear();
+    Record.push_back(RECORD_CATEGORY);
+    Record.push_back(Category);
+    Record.push_back(Name.size());
+    Stream.EmitRecordWithBlob(Abbrevs.get(RECORD_CATEGORY), Record, Name);
+  }
+
+  Names.clear();
+  for (const auto &Flag : State->DiagFlags)
+    Names.push_back(std::make_pair(Flag.second, Flag.first()));
+  std::sort(Names.begin(), Names.end());
+  for (const auto &Name : Names) {
+    Record.clear();
+    Record.push_back(RECORD_DIAG_FLAG);
+    Record.push_back(Name.first);
+    Record.push_back(Name.second.size());
+    Stream.EmitRecordWithBlob(Abbrevs.get(RECORD_DIAG_FLAG), Record,
+                              Name.second);
+  }
+}
+
+void SDiagsWriter::AddDiagToIndex(unsigned Level, unsigned File,
+                                  unsigned Category) {
+  // Only the first record of a top-level block describes it; notes are
+  // nested blocks.
+  if (State->DiagDepth != 1 || !State->PendingIndexEntry)
+    return;
+  IndexEntry &Entry = State->Index.back();
+  Entry.Level = Level;
+  Entry.File = File;
+  Entry.Category = Category;
+  State->PendingIndexEntry = false;
 }
 
 unsigned SDiagsWriter::getEmitCategory(unsigned int category) {
@@ -572,24 +850,20 @@ unsigned SDiagsWriter::getEmitDiagnosticFlag(StringRef FlagName) {
   if (FlagName.empty())
     return 0;
 
-  // Here we assume that FlagName points to static data whose pointer
-  // value is fixed.  This allows us to unique by diagnostic groups.
-  const void *data = FlagName.data();
-  std::pair<unsigned, StringRef> &entry = State->DiagFlags[data];
-  if (entry.first == 0) {
-    entry.first = State->DiagFlags.size();
-    entry.second = FlagName;
-    
+  unsigned &entry = State->DiagFlags[FlagName];
+  if (entry == 0) {
+    entry = State->DiagFlags.size();
+
     // Lazily emit the string in a separate record.
     RecordData Record;
     Record.push_back(RECORD_DIAG_FLAG);
-    Record.push_back(entry.first);
+    Record.push_back(entry);
     Record.push_back(FlagName.size());
     State->Stream.EmitRecordWithBlob(State->Abbrevs.get(RECORD_DIAG_FLAG),
                                      Record, FlagName);
   }
 
-  return entry.first;
+  return entry;
 }
 
 void SDiagsWriter::HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
@@ -683,6 +957,7 @@ void SDiagsWriter::EmitDiagnosticMessage(SourceLocation Loc,
 
   Record.push_back(Message.size());
   Stream.EmitRecordWithBlob(Abbrevs.get(RECORD_DIAG), Record, Message);
+  AddDiagToIndex(Record[1], Record[2], Record[6]);
 }
 
 void
@@ -697,11 +972,26 @@ SDiagsRenderer::emitDiagnosticMessage(SourceLocation Loc,
 }
 
 void SDiagsWriter::EnterDiagBlock() {
+  // Every top-level diagnostic gets an entry in the index.
+  if (State->DiagDepth++ == 0 && IsIndexed()) {
+    State->Index.push_back(IndexEntry(GetCurrentBitNo()));
+    State->PendingIndexEntry = true;
+  }
   State->Stream.EnterSubblock(BLOCK_DIAG, 4);
 }
 
 void SDiagsWriter::ExitDiagBlock() {
   State->Stream.ExitBlock();
+
+  // The sizes of open blocks are patched into the buffer when they are
+  // exited, so the stream can only be written out, and index entries can
+  // only be emitted, between top-level blocks.
+  if (--State->DiagDepth != 0)
+    return;
+  if (State->Index.size() >= IndexChunkSize)
+    EmitIndexBlock(/*Last=*/false);
+  if (State->Buffer.size() >= StreamFlushThreshold)
+    FlushBuffer();
 }
 
 void SDiagsRenderer::beginDiagnostic(DiagOrStoredDiag D,
@@ -797,6 +1087,61 @@ void SDiagsWriter::RemoveOldDiagnostics() {
   MergeChildRecords = false;
 }
 
+void SDiagsWriter::OpenOutputFile() {
+  int FD;
+  SmallString<128> TempFile;
+  std::error_code EC = llvm::sys::fs::createUniqueFile(
+      State->OutputFile + "-%%%%%%%%", FD, TempFile);
+  if (EC) {
+    getMetaDiags()->Report(diag::warn_fe_serialized_diag_failure)
+        << State->OutputFile << EC.message();
+    return;
+  }
+
+  State->TempFile = TempFile.str();
+  llvm::sys::RemoveFileOnSignal(State->TempFile);
+  State->OS = llvm::make_unique<llvm::raw_fd_ostream>(FD, /*shouldClose=*/true);
+}
+
+void SDiagsWriter::FlushBuffer() {
+  if (State->OS)
+    State->OS->write(State->Buffer.data(), State->Buffer.size());
+  State->FlushedBytes += State->Buffer.size();
+  State->Buffer.clear();
+}
+
+void SDiagsWriter::CommitOutputFile(uint64_t IndexBitNo) {
+  if (!State->OS)
+    return;
+
+  // Fill in the placeholder in the META block, which has already been written
+  // out. The stream stores the bits of each byte starting with the lowest.
+  if (IsIndexed()) {
+    SmallString<16> &Bytes = State->IndexLocationBytes;
+    unsigned Shift = State->IndexLocationBitNo % 8;
+    for (unsigned I = 0; I != 64; ++I)
+      if ((IndexBitNo >> I) & 1)
+        Bytes[(Shift + I) / 8] |= 1 << ((Shift + I) % 8);
+    State->OS->pwrite(Bytes.data(), Bytes.size(),
+                      State->IndexLocationBitNo / 8);
+  }
+
+  State->OS->close();
+  std::error_code EC;
+  if (State->OS->has_error()) {
+    EC = std::make_error_code(std::errc::io_error);
+    State->OS->clear_error();
+  } else {
+    EC = llvm::sys::fs::rename(State->TempFile, State->OutputFile);
+  }
+  if (EC) {
+    getMetaDiags()->Report(diag::warn_fe_serialized_diag_failure)
+        << State->OutputFile << EC.message();
+    llvm::sys::fs::remove(State->TempFile);
+  }
+  llvm::sys::DontRemoveFileOnSignal(State->TempFile);
+}
+
 void SDiagsWriter::finish() {
   // The original instance is responsible for writing the file.
   if (!OriginalInstance)
@@ -807,28 +1152,25 @@ void SDiagsWriter::finish() {
     ExitDiagBlock();
 
   if (MergeChildRecords) {
-    if (!State->EmittedAnyDiagBlocks)
+    if (!State->EmittedAnyDiagBlocks) {
       // We have no diagnostics of our own, so we can just leave the child
       // process' output alone
+      if (State->OS) {
+        State->OS.reset();
+        llvm::sys::fs::remove(State->TempFile);
+        llvm::sys::DontRemoveFileOnSignal(State->TempFile);
+      }
       return;
+    }
 
     if (llvm::sys::fs::exists(State->OutputFile))
       if (SDiagsMerger(*this).mergeRecordsFromFile(State->OutputFile.c_str()))
         getMetaDiags()->Report(diag::warn_fe_serialized_diag_merge_failure);
   }
 
-  std::error_code EC;
-  auto OS = llvm::make_unique<llvm::raw_fd_ostream>(State->OutputFile.c_str(),
-                                                    EC, llvm::sys::fs::F_None);
-  if (EC) {
-    getMetaDiags()->Report(diag::warn_fe_serialized_diag_failure)
-        << State->OutputFile << EC.message();
-    return;
-  }
-
-  // Write the generated bitstream to "Out".
-  OS->write((char *)&State->Buffer.front(), State->Buffer.size());
-  OS->flush();
+  uint64_t IndexBitNo = IsIndexed() ? EmitIndexBlock(/*Last=*/true) : 0;
+  FlushBuffer();
+  CommitOutputFile(IndexBitNo);
 }
 
 std::error_code SDiagsMerger::visitStartOfDiagnostic() {
@@ -876,6 +1218,7 @@ std::error_code SDiagsMerger::visitDiagnosticRecord(
 
   Writer.State->Stream.EmitRecordWithBlob(
       Writer.State->Abbrevs.get(RECORD_DIAG), MergedRecord, Message);
+  Writer.AddDiagToIndex(Severity, MergedRecord[2], MergedRecord[6]);
   return std::error_code();
 }
 
@@ -12,10 +12,19 @@
 #include "clang/Frontend/SerializedDiagnostics.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include <algorithm>
 
 using namespace clang;
 using namespace clang::serialized_diags;
 
+/// \brief Sniff for the signature of a diagnostics file.
+static bool readSignature(llvm::BitstreamCursor &Stream) {
+  return Stream.Read(8) == 'D' &&
+         Stream.Read(8) == 'I' &&
+         Stream.Read(8) == 'A' &&
+         Stream.Read(8) == 'G';
+}
+
 std::error_code SerializedDiagnosticReader::readDiagnostics(StringRef File) {
   // Open the diagnostics file.
   FileSystemOptions FO;
@@ -31,11 +40,7 @@ std::error_code SerializedDiagnosticReader::readDiagnostics(StringRef File) {
 
   llvm::BitstreamCursor Stream(StreamFile);
 
-  // Sniff for the signature.
-  if (Stream.Read(8) != 'D' ||
-      Stream.Read(8) != 'I' ||
-      Stream.Read(8) != 'A' ||
-      Stream.Read(8) != 'G')
+  if (!readSignature(Stream))
     return SDError::InvalidSignature;
 
   // Read the top level blocks.
@@ -58,7 +63,7 @@ std::error_code SerializedDiagnosticReader::readDiagnostics(StringRef File) {
         return EC;
       continue;
     default:
-      if (!Stream.SkipBlock())
+      if (Stream.SkipBlock())
         return SDError::MalformedTopLevelBlock;
       continue;
     }
@@ -66,6 +71,173 @@ std::error_code SerializedDiagnosticReader::readDiagnostics(StringRef File) {
   return std::error_code();
 }
 
+std::error_code
+SerializedDiagnosticReader::readDiagnosticsInFile(StringRef File,
+                                                  StringRef SourceFile) {
+  return readIndexedDiagnostics(File, IndexKey::File, SourceFile);
+}
+
+std::error_code
+SerializedDiagnosticReader::readDiagnosticsInCategory(StringRef File,
+                                                      StringRef Category) {
+  return readIndexedDiagnostics(File, IndexKey::Category, Category);
+}
+
+std::error_code SerializedDiagnosticReader::readIndexedDiagnostics(
+    StringRef File, IndexKey Key, StringRef Name) {
+  // Open the diagnostics file. Large files are mapped rather than read, so
+  // only the pages of the selected diagnostics are loaded.
+  FileSystemOptions FO;
+  FileManager FileMgr(FO);
+
+  auto Buffer = FileMgr.getBufferForFile(File);
+  if (!Buffer)
+    return SDError::CouldNotLoad;
+
+  llvm::BitstreamReader StreamFile;
+  StreamFile.init((const unsigned char *)(*Buffer)->getBufferStart(),
+                  (const unsigned char *)(*Buffer)->getBufferEnd());
+
+  llvm::BitstreamCursor Stream(StreamFile);
+
+  if (!readSignature(Stream))
+    return SDError::InvalidSignature;
+
+  // The BLOCKINFO block and the META block, which locates the index, come
+  // first.
+  IndexLocation = 0;
+  std::error_code EC;
+  bool ReadMetaBlock = false;
+  while (!ReadMetaBlock) {
+    if (Stream.AtEndOfStream() ||
+        Stream.ReadCode() != llvm::bitc::ENTER_SUBBLOCK)
+      return SDError::InvalidDiagnostics;
+
+    switch (Stream.ReadSubBlockID()) {
+    case llvm::bitc::BLOCKINFO_BLOCK_ID:
+      if (Stream.ReadBlockInfoBlock())
+        return SDError::MalformedBlockInfoBlock;
+      continue;
+    case BLOCK_META:
+      if ((EC = readMetaBlock(Stream)))
+        return EC;
+      ReadMetaBlock = true;
+      continue;
+    default:
+      return SDError::MissingIndex;
+    }
+  }
+  if (!IndexLocation)
+    return SDError::MissingIndex;
+
+  // Read the index blocks, from the last one, which has the names, back to
+  // the first one. Each block points to the one before it.
+  SmallVector<uint64_t, 4> IDs;
+  SmallVector<uint64_t, 64> Offsets;
+  uint64_t IndexBitNo = IndexLocation;
+  while (IndexBitNo) {
+    if (!Stream.canSkipToPos(IndexBitNo / 8))
+      return SDError::MalformedIndexBlock;
+    Stream.JumpToBit(IndexBitNo);
+    if (Stream.ReadCode() != llvm::bitc::ENTER_SUBBLOCK ||
+        Stream.ReadSubBlockID() != BLOCK_INDEX)
+      return SDError::MalformedIndexBlock;
+
+    uint64_t PreviousBitNo = 0;
+    if ((EC = readIndexBlock(Stream, Key, Name, IDs, Offsets, PreviousBitNo)))
+      return EC;
+    // The blocks are written in order, so the chain can only go backwards.
+    if (PreviousBitNo >= IndexBitNo)
+      return SDError::MalformedIndexBlock;
+    IndexBitNo = PreviousBitNo;
+  }
+  std::sort(Offsets.begin(), Offsets.end());
+
+  // Then only the diagnostic blocks they select, in the order of the file.
+  for (uint64_t Offset : Offsets) {
+    if (!Stream.canSkipToPos(Offset / 8))
+      return SDError::MalformedIndexBlock;
+    Stream.JumpToBit(Offset);
+    if (Stream.ReadCode() != llvm::bitc::ENTER_SUBBLOCK ||
+        Stream.ReadSubBlockID() != BLOCK_DIAG)
+      return SDError::MalformedIndexBlock;
+    if ((EC = readDiagnosticBlock(Stream)))
+      return EC;
+  }
+  return std::error_code();
+}
+
+std::error_code SerializedDiagnosticReader::readIndexBlock(
+    llvm::BitstreamCursor &Stream, IndexKey Key, StringRef Name,
+    SmallVectorImpl<uint64_t> &IDs, SmallVectorImpl<uint64_t> &Offsets,
+    uint64_t &PreviousBitNo) {
+  if (Stream.EnterSubBlock(BLOCK_INDEX))
+    return SDError::MalformedIndexBlock;
+
+  std::error_code EC;
+  SmallVector<uint64_t, 8> Record;
+  while (true) {
+    unsigned BlockOrCode = 0;
+    llvm::ErrorOr<Cursor> Res = skipUntilRecordOrBlock(Stream, BlockOrCode);
+    if (!Res)
+      return Res.getError();
+
+    switch (Res.get()) {
+    case Cursor::BlockBegin:
+      if (Stream.SkipBlock())
+        return SDError::MalformedIndexBlock;
+      continue;
+    case Cursor::BlockEnd:
+      return std::error_code();
+    case Cursor::Record:
+      break;
+    }
+
+    Record.clear();
+    StringRef Blob;
+    switch (Stream.readRecord(BlockOrCode, Record, &Blob)) {
+    case RECORD_FILENAME:
+      if (Record.size() != 4)
+        return SDError::MalformedIndexBlock;
+      if ((EC = visitFilenameRecord(Record[0], Record[1], Record[2], Blob)))
+        return EC;
+      if (Key == IndexKey::File && Blob == Name)
+        IDs.push_back(Record[0]);
+      continue;
+    case RECORD_CATEGORY:
+      if (Record.size() != 2)
+        return SDError::MalformedIndexBlock;
+      if ((EC = visitCategoryRecord(Record[0], Blob)))
+        return EC;
+      if (Key == IndexKey::Category && Blob == Name)
+        IDs.push_back(Record[0]);
+      continue;
+    case RECORD_DIAG_FLAG:
+      if (Record.size() != 2)
+        return SDError::MalformedIndexBlock;
+      if ((EC = visitDiagFlagRecord(Record[0], Blob)))
+        return EC;
+      continue;
+    case RECORD_INDEX_ENTRY: {
+      // An entry has an offset (2), file, category and level.
+      if (Record.size() != 5)
+        return SDError::MalformedIndexBlock;
+      uint64_t ID = Key == IndexKey::File ? Record[2] : Record[3];
+      if (std::find(IDs.begin(), IDs.end(), ID) != IDs.end())
+        Offsets.push_back(Record[0] | (Record[1] << 32));
+      continue;
+    }
+    case RECORD_INDEX_PREVIOUS:
+      if (Record.size() != 2)
+        return SDError::MalformedIndexBlock;
+      PreviousBitNo = Record[0] | (Record[1] << 32);
+      continue;
+    default:
+      continue;
+    }
+  }
+}
+
 enum class SerializedDiagnosticReader::Cursor {
   Record = 1,
   BlockEnd,
@@ -141,6 +313,8 @@ SerializedDiagnosticReader::readMetaBlock(llvm::BitstreamCursor &Stream) {
       if (Record[0] > VersionNumber)
         return SDError::VersionMismatch;
       VersionChecked = true;
+    } else if (RecordID == RECORD_INDEX_LOCATION && Record.size() == 2) {
+      IndexLocation = Record[0] | (Record[1] << 32);
     }
   }
 }
@@ -167,7 +341,7 @@ SerializedDiagnosticReader::readDiagnosticBlock(llvm::BitstreamCursor &Stream) {
       if (BlockOrCode == serialized_diags::BLOCK_DIAG) {
         if ((EC = readDiagnosticBlock(Stream)))
           return EC;
-      } else if (!Stream.SkipBlock())
+      } else if (Stream.SkipBlock())
         return SDError::MalformedSubBlock;
       continue;
     case Cursor::BlockEnd:
@@ -283,6 +457,10 @@ class SDErrorCategoryType final : public std::error_category {
       return "Bitcode constructs that are not supported in diagnostics appear";
     case SDError::HandlerFailed:
       return "Generic error occurred while handling a record";
+    case SDError::MissingIndex:
+      return "No index in diagnostics";
+    case SDError::MalformedIndexBlock:
+      return "Malformed Index block";
     }
     llvm_unreachable("Unknown error type!");
   }
@@ -18,6 +18,7 @@
 #include "clang/Lex/ExternalPreprocessorSource.h"
 #include "clang/Lex/HeaderMap.h"
 #include "clang/Lex/HeaderSearchOptions.h"
+#include "clang/Lex/IncludeGuardDatabase.h"
 #include "clang/Lex/LexDiagnostic.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/Lex/Preprocessor.h"
@@ -67,6 +68,7 @@ HeaderSearch::HeaderSearch(IntrusiveRefCntPtr<HeaderSearchOptions> HSOpts,
   ExternalSource = nullptr;
   NumIncluded = 0;
   NumMultiIncludeFileOptzn = 0;
+  NumGuardDatabaseOptzn = 0;
   NumFrameworkLookups = NumSubFrameworkLookups = 0;
 }
 
@@ -93,9 +95,15 @@ void HeaderSearch::PrintStats() {
   fprintf(stderr, "  %d #include/#include_next/#import.\n", NumIncluded);
   fprintf(stderr, "    %d #includes skipped due to"
           " the multi-include optimization.\n", NumMultiIncludeFileOptzn);
+  if (GuardDatabase)
+    fprintf(stderr, "      %d of them using the include guard database.\n",
+            NumGuardDatabaseOptzn);
 
   fprintf(stderr, "%d framework lookups.\n", NumFrameworkLookups);
   fprintf(stderr, "%d subframework lookups.\n", NumSubFrameworkLookups);
+
+  if (GuardDatabase)
+    GuardDatabase->PrintStats();
 }
 
 /// CreateHeaderMap - This method returns a HeaderMap for the specified
@@ -1059,6 +1067,21 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
       return false;
   }
 
+  // If we know nothing about a header that is not part of a module yet, an
+  // earlier compilation may have recorded its include guard.
+  bool FromGuardDatabase = false;
+  if (GuardDatabase && !M && !FileInfo.NumIncludes && !FileInfo.isPragmaOnce &&
+      !FileInfo.ControllingMacro && !FileInfo.ControllingMacroID) {
+    SmallString<256> Path;
+    IncludeGuardDatabase::HeaderGuard Guard;
+    if (getIncludeGuardDatabaseKey(File, Path) &&
+        GuardDatabase->lookup(Path, File, Guard) &&
+        !Guard.ControllingMacro.empty()) {
+      FileInfo.ControllingMacro = PP.getIdentifierInfo(Guard.ControllingMacro);
+      FromGuardDatabase = true;
+    }
+  }
+
   // Next, check to see if the file is wrapped with #ifndef guards.  If so, and
   // if the macro that guards it is defined, we know the #include has no effect.
   if (const IdentifierInfo *ControllingMacro
@@ -1069,6 +1092,8 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
     if (M ? PP.isMacroDefinedInLocalModule(ControllingMacro, M)
           : PP.isMacroDefined(ControllingMacro)) {
       ++NumMultiIncludeFileOptzn;
+      if (FromGuardDatabase)
+        ++NumGuardDatabaseOptzn;
       return false;
     }
   }
@@ -1079,6 +1104,67 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
   return true;
 }
 
+void HeaderSearch::setIncludeGuardDatabase(
+    std::unique_ptr<IncludeGuardDatabase> DB) {
+  GuardDatabase = std::move(DB);
+}
+
+bool HeaderSearch::getIncludeGuardDatabaseKey(const FileEntry *File,
+                                              SmallVectorImpl<char> &Path) {
+  StringRef Name = File->getName();
+  Path.assign(Name.begin(), Name.end());
+  FileMgr.FixupRelativePath(Path);
+  if (llvm::sys::path::is_absolute(Path))
+    return true;
+
+  // Only ask for the working directory once rather than for every header.
+  if (!GuardDatabaseWorkingDir) {
+    SmallString<128> WorkingDir;
+    if (llvm::sys::fs::current_path(WorkingDir))
+      WorkingDir.clear();
+    GuardDatabaseWorkingDir = WorkingDir.str().str();
+  }
+  if (GuardDatabaseWorkingDir->empty())
+    return false;
+
+  SmallString<256> Absolute(*GuardDatabaseWorkingDir);
+  llvm::sys::path::append(Absolute, StringRef(Path.data(), Path.size()));
+  Path.assign(Absolute.begin(), Absolute.end());
+  return true;
+}
+
+bool HeaderSearch::writeIncludeGuardDatabase(StringRef Path,
+                                             std::string &ErrorMsg) {
+  if (!GuardDatabase)
+    GuardDatabase = IncludeGuardDatabase::load(Path);
+
+  SmallVector<const FileEntry *, 16> FilesByUID;
+  FileMgr.GetUniqueIDMapping(FilesByUID);
+  for (unsigned UID = 0, E = std::min(FileInfo.size(), FilesByUID.size());
+       UID != E; ++UID) {
+    const FileEntry *File = FilesByUID[UID];
+    HeaderFileInfo &HFI = FileInfo[UID];
+    // Only record headers that were actually entered, so that the guard was
+    // computed from their current contents.
+    if (!File || !HFI.IsValid || !HFI.NumIncludes || HFI.isModuleHeader)
+      continue;
+
+    // A header that only uses #pragma once has to be entered once anyway,
+    // and isn't skipped on its first #include, so there is nothing to record.
+    const IdentifierInfo *ControllingMacro =
+        HFI.getControllingMacro(ExternalLookup);
+    if (!ControllingMacro)
+      continue;
+
+    SmallString<256> Key;
+    if (getIncludeGuardDatabaseKey(File, Key))
+      GuardDatabase->record(Key, File, ControllingMacro->getName());
+  }
+
+  return GuardDatabase->writeToFile(Path, *FileMgr.getVirtualFileSystem(),
+                                    ErrorMsg);
+}
+
 size_t HeaderSearch::getTotalMemory() const {
   return SearchDirs.capacity()
     + llvm::capacity_in_bytes(FileInfo)
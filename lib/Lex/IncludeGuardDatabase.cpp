@@ -0,0 +1,226 @@
+//===--- IncludeGuardDatabase.cpp - Persistent include guards -------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the IncludeGuardDatabase class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/IncludeGuardDatabase.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/OnDiskTableFile.h"
+#include "clang/Basic/VirtualFileSystem.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/OnDiskHashTable.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdio>
+#include <ctime>
+
+using namespace clang;
+
+/// \brief The magic number at the start of an include guard database.
+static const char GuardDatabaseMagic[] = "CIGD";
+
+/// \brief The version of the database format. Bump this whenever the format
+/// changes; files of other versions are ignored.
+static const unsigned GuardDatabaseVersion = 2;
+
+/// \brief Size of the fixed part of the data stored for each header; the
+/// name of the controlling macro follows it.
+static const unsigned GuardDataFixedSize = 8 + 8 + 8 + 8;
+
+bool IncludeGuardDatabase::HeaderGuard::matches(const FileEntry *File) const {
+  return UniqueID == File->getUniqueID() && Size == (uint64_t)File->getSize() &&
+         ModTime == (uint64_t)File->getModificationTime();
+}
+
+namespace {
+class IncludeGuardDatabaseTrait {
+public:
+  typedef StringRef external_key_type;
+  typedef StringRef internal_key_type;
+  typedef IncludeGuardDatabase::HeaderGuard data_type;
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+
+  static bool EqualKey(const internal_key_type &a, const internal_key_type &b) {
+    return a == b;
+  }
+
+  static hash_value_type ComputeHash(const internal_key_type &a) {
+    return llvm::HashString(a);
+  }
+
+  static const internal_key_type &
+  GetInternalKey(const external_key_type &x) { return x; }
+
+  static const external_key_type &
+  GetExternalKey(const internal_key_type &x) { return x; }
+
+  static std::pair<unsigned, unsigned>
+  ReadKeyDataLength(const unsigned char *&d) {
+    using namespace llvm::support;
+    unsigned KeyLen = endian::readNext<uint16_t, little, unaligned>(d);
+    unsigned DataLen = endian::readNext<uint16_t, little, unaligned>(d);
+    return std::make_pair(KeyLen, DataLen);
+  }
+
+  static internal_key_type ReadKey(const unsigned char *d, unsigned n) {
+    return StringRef((const char *)d, n);
+  }
+
+  static data_type ReadData(const internal_key_type &k, const unsigned char *d,
+                            unsigned DataLen) {
+    using namespace llvm::support;
+    data_type Guard;
+    if (DataLen < GuardDataFixedSize)
+      return Guard;
+    uint64_t File = endian::readNext<uint64_t, little, unaligned>(d);
+    uint64_t Device = endian::readNext<uint64_t, little, unaligned>(d);
+    Guard.UniqueID = llvm::sys::fs::UniqueID(Device, File);
+    Guard.Size = endian::readNext<uint64_t, little, unaligned>(d);
+    Guard.ModTime = endian::readNext<uint64_t, little, unaligned>(d);
+    Guard.ControllingMacro =
+        StringRef((const char *)d, DataLen - GuardDataFixedSize);
+    return Guard;
+  }
+
+  // Writer interface.
+  typedef StringRef key_type;
+  typedef StringRef key_type_ref;
+  typedef const data_type &data_type_ref;
+
+  std::pair<unsigned, unsigned>
+  EmitKeyDataLength(raw_ostream &Out, key_type_ref Key, data_type_ref Data) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    unsigned DataLen = GuardDataFixedSize + Data.ControllingMacro.size();
+    LE.write<uint16_t>(Key.size());
+    LE.write<uint16_t>(DataLen);
+    return std::make_pair(Key.size(), DataLen);
+  }
+
+  void EmitKey(raw_ostream &Out, key_type_ref Key, unsigned KeyLen) {
+    Out.write(Key.data(), KeyLen);
+  }
+
+  void EmitData(raw_ostream &Out, key_type_ref Key, data_type_ref Data,
+                unsigned DataLen) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    LE.write<uint64_t>(Data.UniqueID.getFile());
+    LE.write<uint64_t>(Data.UniqueID.getDevice());
+    LE.write<uint64_t>(Data.Size);
+    LE.write<uint64_t>(Data.ModTime);
+    Out << Data.ControllingMacro;
+  }
+};
+
+typedef llvm::OnDiskIterableChainedHashTable<IncludeGuardDatabaseTrait>
+    GuardDatabaseTable;
+} // end anonymous namespace
+
+IncludeGuardDatabase::IncludeGuardDatabase(
+    std::unique_ptr<llvm::MemoryBuffer> Buffer, uint32_t BucketOffset)
+    : Buffer(std::move(Buffer)), Table(nullptr), NumLookups(0), NumHits(0),
+      NumStaleHits(0) {
+  if (!this->Buffer)
+    return;
+
+  const unsigned char *Start =
+      (const unsigned char *)this->Buffer->getBufferStart();
+  Table = GuardDatabaseTable::Create(Start + BucketOffset,
+                                     Start + OnDiskTableFileHeaderSize, Start);
+}
+
+IncludeGuardDatabase::~IncludeGuardDatabase() {
+  delete static_cast<GuardDatabaseTable *>(Table);
+}
+
+std::unique_ptr<IncludeGuardDatabase>
+IncludeGuardDatabase::load(StringRef Path) {
+  uint32_t BucketOffset = 0;
+  std::unique_ptr<llvm::MemoryBuffer> Buffer = mapOnDiskTableFile(
+      Path, GuardDatabaseMagic, GuardDatabaseVersion, BucketOffset);
+  return std::unique_ptr<IncludeGuardDatabase>(
+      new IncludeGuardDatabase(std::move(Buffer), BucketOffset));
+}
+
+bool IncludeGuardDatabase::lookup(StringRef Path, const FileEntry *File,
+                                  HeaderGuard &Guard) {
+  GuardDatabaseTable *T = static_cast<GuardDatabaseTable *>(Table);
+  if (!T)
+    return false;
+
+  ++NumLookups;
+  GuardDatabaseTable::iterator Pos = T->find(Path);
+  if (Pos == T->end())
+    return false;
+
+  HeaderGuard Found = *Pos;
+  if (!Found.matches(File)) {
+    ++NumStaleHits;
+    return false;
+  }
+  ++NumHits;
+  Guard = Found;
+  return true;
+}
+
+void IncludeGuardDatabase::record(StringRef Path, const FileEntry *File,
+                                  StringRef ControllingMacro) {
+  // A header modified within the last couple of seconds may be modified again
+  // without its modification time changing, so don't trust it yet.
+  if ((uint64_t)File->getModificationTime() + 2 >= (uint64_t)::time(nullptr))
+    return;
+
+  HeaderGuard &Guard = Recorded[Path];
+  Guard.UniqueID = File->getUniqueID();
+  Guard.Size = File->getSize();
+  Guard.ModTime = File->getModificationTime();
+  Guard.ControllingMacro = ControllingMacro;
+}
+
+bool IncludeGuardDatabase::writeToFile(StringRef Path, vfs::FileSystem &FS,
+                                       std::string &ErrorMsg) {
+  llvm::OnDiskChainedHashTableGenerator<IncludeGuardDatabaseTrait> Generator;
+  IncludeGuardDatabaseTrait Trait;
+
+  // Keep the entries of the loaded database whose header is unchanged, unless
+  // this process recorded a newer state for them.
+  if (GuardDatabaseTable *T = static_cast<GuardDatabaseTable *>(Table)) {
+    for (GuardDatabaseTable::key_iterator K = T->key_begin(),
+                                          KEnd = T->key_end();
+         K != KEnd; ++K) {
+      StringRef Key = *K;
+      if (Recorded.count(Key))
+        continue;
+      HeaderGuard Guard = *T->find(Key);
+      llvm::ErrorOr<vfs::Status> Status = FS.status(Key);
+      if (Status && Status->getUniqueID() == Guard.UniqueID &&
+          Status->getSize() == Guard.Size &&
+          (uint64_t)Status->getLastModificationTime().toEpochTime() ==
+              Guard.ModTime)
+        Generator.insert(Key, Guard, Trait);
+    }
+  }
+  for (const auto &Entry : Recorded)
+    Generator.insert(Entry.first(), Entry.second, Trait);
+
+  return writeOnDiskTableFile(
+      Path, GuardDatabaseMagic, GuardDatabaseVersion,
+      [&](raw_ostream &Out) { return Generator.Emit(Out, Trait); }, ErrorMsg);
+}
+
+void IncludeGuardDatabase::PrintStats() const {
+  fprintf(stderr, "\n*** Include Guard Database Stats:\n");
+  fprintf(stderr, "%d lookups, %d answered from the database, %d stale.\n",
+          NumLookups, NumHits, NumStaleHits);
+  fprintf(stderr, "%d headers recorded.\n", (int)Recorded.size());
+}
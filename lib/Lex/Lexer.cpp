@@ -24,8 +24,15 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -1468,9 +1475,106 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+//===----------------------------------------------------------------------===//
+// Vectorized scanning helpers
+//===----------------------------------------------------------------------===//
+//
+// Each of these skips a run of characters that need no special handling 16
+// bytes at a time and returns a pointer to the first character that might.
+// They never read past BufferEnd and stop early when fewer than 16 bytes are
+// left, so the callers always finish the scan with their scalar loops.
+
+#ifdef __SSE2__
+/// Returns the mask of the bytes of \p Chunk that are equal to \p C.
+static inline unsigned matchByte(__m128i Chunk, char C) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8(C)));
+}
+
+/// Returns the mask of the bytes of \p Chunk in the ASCII range [Lo, Hi].
+/// Bytes of non-ASCII characters compare as negative and never match.
+static inline unsigned matchRange(__m128i Chunk, char Lo, char Hi) {
+  __m128i AboveLo = _mm_cmpgt_epi8(Chunk, _mm_set1_epi8(Lo - 1));
+  __m128i BelowHi = _mm_cmplt_epi8(Chunk, _mm_set1_epi8(Hi + 1));
+  return _mm_movemask_epi8(_mm_and_si128(AboveLo, BelowHi));
+}
+
+/// Advances \p CurPtr over whole chunks for which \p Stops returns an empty
+/// mask, then to the first byte in the stop mask.
+template <typename StopMaskFn>
+static inline const char *skipChunks(const char *CurPtr, const char *BufferEnd,
+                                     StopMaskFn Stops) {
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chunk = _mm_loadu_si128((const __m128i *)CurPtr);
+    if (unsigned Mask = Stops(Chunk))
+      return CurPtr + llvm::countTrailingZeros(Mask);
+    CurPtr += 16;
+  }
+  return CurPtr;
+}
+#endif
+
+/// Skips identifier body characters, [_A-Za-z0-9].
+static const char *skipIdentifierBody(const char *CurPtr,
+                                      const char *BufferEnd) {
+#ifdef __SSE2__
+  return skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    unsigned Body = matchRange(Chunk, 'a', 'z') | matchRange(Chunk, 'A', 'Z') |
+                    matchRange(Chunk, '0', '9') | matchByte(Chunk, '_');
+    return ~Body & 0xFFFF;
+  });
+#else
+  return CurPtr;
+#endif
+}
+
+/// Skips horizontal whitespace, [ \t\f\v].
+static const char *skipHorizontalWhitespace(const char *CurPtr,
+                                            const char *BufferEnd) {
+#ifdef __SSE2__
+  return skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    unsigned Space = matchByte(Chunk, ' ') | matchByte(Chunk, '\t') |
+                     matchByte(Chunk, '\f') | matchByte(Chunk, '\v');
+    return ~Space & 0xFFFF;
+  });
+#else
+  return CurPtr;
+#endif
+}
+
+/// Skips the body of a line comment up to a newline or a nul character.
+static const char *skipLineCommentBody(const char *CurPtr,
+                                       const char *BufferEnd) {
+#ifdef __SSE2__
+  return skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    return matchByte(Chunk, '\n') | matchByte(Chunk, '\r') |
+           matchByte(Chunk, '\0');
+  });
+#else
+  return CurPtr;
+#endif
+}
+
+/// Skips the characters of a string or character literal that
+/// getAndAdvanceChar would return unchanged: anything but the closing
+/// \p Quote, escapes, newlines, nul characters and '?', which might start a
+/// trigraph.
+static const char *skipQuotedLiteralBody(const char *CurPtr,
+                                         const char *BufferEnd, char Quote) {
+#ifdef __SSE2__
+  return skipChunks(CurPtr, BufferEnd, [Quote](__m128i Chunk) {
+    return matchByte(Chunk, Quote) | matchByte(Chunk, '\\') |
+           matchByte(Chunk, '\n') | matchByte(Chunk, '\r') |
+           matchByte(Chunk, '\0') | matchByte(Chunk, '?');
+  });
+#else
+  return CurPtr;
+#endif
+}
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
+  CurPtr = skipIdentifierBody(CurPtr, BufferEnd);
   unsigned char C = *CurPtr++;
   while (isIdentifierBody(C))
     C = *CurPtr++;
@@ -1722,6 +1826,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
            ? diag::warn_cxx98_compat_unicode_literal
            : diag::warn_c99_compat_unicode_literal);
 
+  CurPtr = skipQuotedLiteralBody(CurPtr, BufferEnd, '"');
   char C = getAndAdvanceChar(CurPtr, Result);
   while (C != '"') {
     // Skip escaped characters.  Escaped newlines will already be processed by
@@ -1747,6 +1852,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
 
       NulCharacter = CurPtr-1;
     }
+    CurPtr = skipQuotedLiteralBody(CurPtr, BufferEnd, '"');
     C = getAndAdvanceChar(CurPtr, Result);
   }
 
@@ -1929,6 +2035,7 @@ bool Lexer::LexCharConstant(Token &Result, const char *CurPtr,
 
       NulCharacter = CurPtr-1;
     }
+    CurPtr = skipQuotedLiteralBody(CurPtr, BufferEnd, '\'');
     C = getAndAdvanceChar(CurPtr, Result);
   }
 
@@ -1962,6 +2069,10 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (1) {
     // Skip horizontal whitespace very aggressively.
+    if (isHorizontalWhitespace(Char)) {
+      CurPtr = skipHorizontalWhitespace(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
     while (isHorizontalWhitespace(Char))
       Char = *++CurPtr;
 
@@ -2028,6 +2139,7 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
   // them.  As such, optimize for this case with the inner loop.
   char C;
   do {
+    CurPtr = skipLineCommentBody(CurPtr, BufferEnd);
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (C != 0 &&                // Potentially EOF.
@@ -2233,13 +2345,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
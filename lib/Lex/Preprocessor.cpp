@@ -28,6 +28,7 @@
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/FileSystemStatCache.h"
+#include "clang/Basic/PhaseProfile.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Lex/CodeCompletionHandler.h"
@@ -65,7 +66,7 @@ Preprocessor::Preprocessor(IntrusiveRefCntPtr<PreprocessorOptions> PPOpts,
       FileMgr(Headers.getFileMgr()), SourceMgr(SM),
       ScratchBuf(new ScratchBuffer(SourceMgr)),HeaderInfo(Headers),
       TheModuleLoader(TheModuleLoader), ExternalSource(nullptr),
-      Identifiers(opts, IILookup),
+      Profile(nullptr), Identifiers(opts, IILookup),
       PragmaHandlers(new PragmaNamespace(StringRef())),
       IncrementalProcessing(false), TUKind(TUKind),
       CodeComplete(nullptr), CodeCompletionFile(nullptr),
@@ -88,6 +89,7 @@ Preprocessor::Preprocessor(IntrusiveRefCntPtr<PreprocessorOptions> PPOpts,
   NumFastMacroExpanded = NumTokenPaste = NumFastTokenPaste = 0;
   MaxIncludeStackDepth = 0;
   NumSkipped = 0;
+  NumLexedTokens = 0;
   
   // Default to discarding comments.
   KeepComments = false;
@@ -293,6 +295,13 @@ Preprocessor::macro_begin(bool IncludeExternalMacros) const {
   return CurSubmoduleState->Macros.begin();
 }
 
+void Preprocessor::addStatsToProfile(PhaseProfile &Profile) const {
+  Profile.addCounter("tokens", NumLexedTokens);
+  Profile.addCounter("directives", NumDirectives);
+  Profile.addCounter("files-entered", NumEnteredSourceFiles);
+  Profile.addCounter("macros-expanded", NumMacroExpanded);
+}
+
 size_t Preprocessor::getTotalMemory() const {
   return BP.getTotalMemory()
     + llvm::capacity_in_bytes(MacroExpandedTokens)
@@ -736,6 +745,10 @@ void Preprocessor::Lex(Token &Result) {
     }
   } while (!ReturnedToken);
 
+  // Tokens are only counted for the profile; keep the common path to a
+  // single well-predicted branch.
+  if (Profile)
+    ++NumLexedTokens;
   LastTokenWasAt = Result.is(tok::at);
 }
 
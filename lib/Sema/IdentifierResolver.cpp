@@ -84,7 +84,7 @@ void IdentifierResolver::IdDeclInfo::RemoveDecl(NamedDecl *D) {
 
 IdentifierResolver::IdentifierResolver(Preprocessor &PP)
   : LangOpt(PP.getLangOpts()), PP(PP),
-    IdDeclInfos(new IdDeclInfoMap) {
+    IdDeclInfos(new IdDeclInfoMap), NumNonLocalChanges(0) {
 }
 
 IdentifierResolver::~IdentifierResolver() {
@@ -138,8 +138,14 @@ bool IdentifierResolver::isDeclInScope(Decl *D, DeclContext *Ctx, Scope *S,
                               : Ctx->Equals(DCtx);
 }
 
+void IdentifierResolver::noteChange(const NamedDecl *D) {
+  if (!D->getDeclContext()->isFunctionOrMethod())
+    ++NumNonLocalChanges;
+}
+
 /// AddDecl - Link the decl to its shadowed decl chain.
 void IdentifierResolver::AddDecl(NamedDecl *D) {
+  noteChange(D);
   DeclarationName Name = D->getDeclName();
   if (IdentifierInfo *II = Name.getAsIdentifierInfo())
     updatingIdentifier(*II);
@@ -165,6 +171,7 @@ void IdentifierResolver::AddDecl(NamedDecl *D) {
 }
 
 void IdentifierResolver::InsertDeclAfter(iterator Pos, NamedDecl *D) {
+  noteChange(D);
   DeclarationName Name = D->getDeclName();
   if (IdentifierInfo *II = Name.getAsIdentifierInfo())
     updatingIdentifier(*II);
@@ -206,6 +213,7 @@ void IdentifierResolver::InsertDeclAfter(iterator Pos, NamedDecl *D) {
 /// The decl must already be part of the decl chain.
 void IdentifierResolver::RemoveDecl(NamedDecl *D) {
   assert(D && "null param passed");
+  noteChange(D);
   DeclarationName Name = D->getDeclName();
   if (IdentifierInfo *II = Name.getAsIdentifierInfo())
     updatingIdentifier(*II);
@@ -296,6 +304,7 @@ static DeclMatchKind compareDeclarations(NamedDecl *Existing, NamedDecl *New) {
 }
 
 bool IdentifierResolver::tryAddTopLevelDecl(NamedDecl *D, DeclarationName Name){
+  noteChange(D);
   if (IdentifierInfo *II = Name.getAsIdentifierInfo())
     readingIdentifier(*II);
   
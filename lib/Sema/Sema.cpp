@@ -32,6 +32,7 @@
 #include "clang/Sema/ExternalSemaSource.h"
 #include "clang/Sema/MultiplexExternalSemaSource.h"
 #include "clang/Sema/ObjCMethodList.h"
+#include "clang/Sema/Overload.h"
 #include "clang/Sema/PrettyDeclStackTrace.h"
 #include "clang/Sema/Scope.h"
 #include "clang/Sema/ScopeInfo.h"
@@ -99,6 +100,7 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
     GlobalNewDeleteDeclared(false),
     TUKind(TUKind),
     NumSFINAEErrors(0),
+    NumSharedInstantiatedExprs(0), NumRebuiltInstantiatedExprs(0),
     CachedFakeTopLevelModule(nullptr),
     AccessCheckingSFINAE(false), InNonInstantiationSFINAEContext(false),
     NonInstantiationEntries(0), ArgumentPackSubstitutionIndex(-1),
@@ -331,6 +333,13 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumSharedInstantiatedExprs
+               << " template pattern expressions reused by instantiation, "
+               << NumRebuiltInstantiatedExprs << " transformed.\n";
+  if (OverloadCache)
+    OverloadCache->PrintStats();
+  if (UnqualifiedLookups)
+    UnqualifiedLookups->PrintStats();
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -889,6 +889,199 @@ struct FindLocalExternScope {
 };
 }
 
+void UnqualifiedLookupCache::Entry::Profile(llvm::FoldingSetNodeID &ID,
+                                            DeclarationName Name,
+                                            Sema::LookupNameKind Kind,
+                                            unsigned IDNS, Scope *S,
+                                            DeclContext *Entity) {
+  ID.AddPointer(Name.getAsOpaquePtr());
+  ID.AddInteger(Kind);
+  ID.AddInteger(IDNS);
+  ID.AddPointer(S);
+  ID.AddPointer(Entity);
+}
+
+void UnqualifiedLookupCache::validate(unsigned FileContextChanges,
+                                      unsigned ScopeChanges) {
+  if (FileContextChanges == FileContextGeneration &&
+      ScopeChanges == ScopeGeneration)
+    return;
+  FileContextGeneration = FileContextChanges;
+  ScopeGeneration = ScopeChanges;
+  if (Entries.empty())
+    return;
+  Entries.clear();
+  Allocator.Reset();
+  ++NumFlushes;
+}
+
+bool UnqualifiedLookupCache::lookup(LookupResult &R, Scope *S) {
+  llvm::FoldingSetNodeID ID;
+  Entry::Profile(ID, R.getLookupName(), R.getLookupKind(),
+                 R.getIdentifierNamespace(), S, S->getEntity());
+  void *InsertPos;
+  Entry *E = Entries.FindNodeOrInsertPos(ID, InsertPos);
+  if (!E) {
+    ++NumMisses;
+    return false;
+  }
+
+  ++NumHits;
+  for (NamedDecl *D : E->Decls)
+    R.addDecl(D);
+  R.resolveKind();
+  return true;
+}
+
+void UnqualifiedLookupCache::insert(const LookupResult &R, Scope *S) {
+  llvm::FoldingSetNodeID ID;
+  Entry::Profile(ID, R.getLookupName(), R.getLookupKind(),
+                 R.getIdentifierNamespace(), S, S->getEntity());
+  void *InsertPos;
+  if (Entries.FindNodeOrInsertPos(ID, InsertPos))
+    return;
+
+  unsigned NumDecls = R.asUnresolvedSet().size();
+  NamedDecl **Decls = Allocator.Allocate<NamedDecl *>(NumDecls);
+  std::copy(R.begin(), R.end(), Decls);
+  Entries.InsertNode(new (Allocator) Entry(R.getLookupName(),
+                                           R.getLookupKind(),
+                                           R.getIdentifierNamespace(), S,
+                                           S->getEntity(),
+                                           llvm::makeArrayRef(Decls, NumDecls)),
+                     InsertPos);
+}
+
+void UnqualifiedLookupCache::PrintStats() const {
+  llvm::errs() << NumHits << " unqualified lookups answered from the cache, "
+               << NumMisses << " performed, " << NumFlushes
+               << " cache flushes.\n";
+}
+
+/// \brief Perform the part of C++ unqualified lookup that searches the
+/// namespace scope \p S and its enclosing scopes, continuing from the
+/// declaration \p I of the name in the identifier chain.
+static bool
+LookupInNamespaceScopes(Sema &SemaRef, LookupResult &R, Scope *S,
+                        IdentifierResolver::iterator I,
+                        DeclContext *OutsideOfTemplateParamDC,
+                        UnqualUsingDirectiveSet &UDirs) {
+  IdentifierResolver::iterator IEnd = SemaRef.IdResolver.end();
+  for (; S; S = S->getParent()) {
+    // Check whether the IdResolver has anything in this scope.
+    bool Found = false;
+    for (; I != IEnd && S->isDeclScope(*I); ++I) {
+      if (NamedDecl *ND = R.getAcceptableDecl(*I)) {
+        // We found something.  Look for anything else in our scope
+        // with this same name and in an acceptable identifier
+        // namespace, so that we can construct an overload set if we
+        // need to.
+        Found = true;
+        R.addDecl(ND);
+      }
+    }
+
+    if (Found && S->isTemplateParamScope()) {
+      R.resolveKind();
+      return true;
+    }
+
+    DeclContext *Ctx = S->getEntity();
+    if (!Ctx && S->isTemplateParamScope() && OutsideOfTemplateParamDC &&
+        S->getParent() && !S->getParent()->isTemplateParamScope()) {
+      // We've just searched the last template parameter scope and
+      // found nothing, so look into the contexts between the
+      // lexical and semantic declaration contexts returned by
+      // findOuterContext(). This implements the name lookup behavior
+      // of C++ [temp.local]p8.
+      Ctx = OutsideOfTemplateParamDC;
+      OutsideOfTemplateParamDC = nullptr;
+    }
+
+    if (Ctx) {
+      DeclContext *OuterCtx;
+      bool SearchAfterTemplateScope;
+      std::tie(OuterCtx, SearchAfterTemplateScope) = findOuterContext(S);
+      if (SearchAfterTemplateScope)
+        OutsideOfTemplateParamDC = OuterCtx;
+
+      for (; Ctx && !Ctx->Equals(OuterCtx); Ctx = Ctx->getLookupParent()) {
+        // We do not directly look into transparent contexts, since
+        // those entities will be found in the nearest enclosing
+        // non-transparent context.
+        if (Ctx->isTransparentContext())
+          continue;
+
+        // If we have a context, and it's not a context stashed in the
+        // template parameter scope for an out-of-line definition, also
+        // look into that context.
+        if (!(Found && S && S->isTemplateParamScope())) {
+          assert(Ctx->isFileContext() &&
+              "We should have been looking only at file context here already.");
+
+          // Look into context considering using-directives.
+          if (CppNamespaceLookup(SemaRef, R, SemaRef.Context, Ctx, UDirs))
+            Found = true;
+        }
+
+        if (Found) {
+          R.resolveKind();
+          return true;
+        }
+
+        if (R.isForRedeclaration() && !Ctx->isTransparentContext())
+          return false;
+      }
+    }
+
+    if (R.isForRedeclaration() && Ctx && !Ctx->isTransparentContext())
+      return false;
+  }
+
+  return !R.empty();
+}
+
+/// \brief Determine whether the rest of the unqualified lookup \p R, which
+/// started in the scope \p Initial and has reached the namespace scope \p S,
+/// can be answered from the cache.
+static bool isCacheableNamespaceLookup(Sema &SemaRef, const LookupResult &R,
+                                       Scope *Initial, Scope *S) {
+  const LangOptions &LangOpts = SemaRef.getLangOpts();
+  // Module visibility can change without any declaration being added.
+  if (!LangOpts.CacheUnqualifiedLookup || LangOpts.Modules ||
+      LangOpts.ModulesLocalVisibility)
+    return false;
+
+  if (R.isForRedeclaration() ||
+      R.getResultKind() != LookupResult::NotFound)
+    return false;
+
+  switch (R.getLookupKind()) {
+  case Sema::LookupOrdinaryName:
+  case Sema::LookupTagName:
+  case Sema::LookupNestedNameSpecifierName:
+  case Sema::LookupNamespaceName:
+  case Sema::LookupOperatorName:
+    break;
+  default:
+    return false;
+  }
+
+  // Lookup of a conversion function name deduces template arguments.
+  DeclarationName Name = R.getLookupName();
+  if (!Name.getAsIdentifierInfo() &&
+      Name.getNameKind() != DeclarationName::CXXOperatorName)
+    return false;
+
+  // Using-directives in block scope are not part of any namespace.
+  for (Scope *Local = Initial; Local != S; Local = Local->getParent()) {
+    Scope::using_directives_range UDirs = Local->using_directives();
+    if (UDirs.begin() != UDirs.end())
+      return false;
+  }
+  return true;
+}
+
 bool Sema::CppLookupName(LookupResult &R, Scope *S) {
   assert(getLangOpts().CPlusPlus && "Can perform only C++ lookup");
 
@@ -1085,6 +1278,25 @@ bool Sema::CppLookupName(LookupResult &R, Scope *S) {
   if (NameKind == LookupMemberName)
     return false;
 
+  // If we're not performing redeclaration lookup, do not look for local
+  // extern declarations outside of a function scope.
+  if (!R.isForRedeclaration())
+    FindLocals.restore();
+
+  // The rest of the lookup only depends on the namespace scope we reached,
+  // unless we came from an out-of-line definition, so reuse the results of
+  // an earlier lookup of the same name from the same scope.
+  bool Cacheable = !VisitedUsingDirectives && !OutsideOfTemplateParamDC &&
+                   isCacheableNamespaceLookup(*this, R, Initial, S);
+  if (Cacheable) {
+    if (!UnqualifiedLookups)
+      UnqualifiedLookups.reset(new UnqualifiedLookupCache());
+    UnqualifiedLookups->validate(Context.getNumFileContextChanges(),
+                                 IdResolver.getNumNonLocalChanges());
+    if (UnqualifiedLookups->lookup(R, S))
+      return !R.empty();
+  }
+
   // Collect UsingDirectiveDecls in all scopes, and recursively all
   // nominated namespaces by those using-directives.
   //
@@ -1095,87 +1307,20 @@ bool Sema::CppLookupName(LookupResult &R, Scope *S) {
     UDirs.done();
   }
 
-  // If we're not performing redeclaration lookup, do not look for local
-  // extern declarations outside of a function scope.
-  if (!R.isForRedeclaration())
-    FindLocals.restore();
-
   // Lookup namespace scope, and global scope.
   // Unqualified name lookup in C++ requires looking into scopes
   // that aren't strictly lexical, and therefore we walk through the
   // context as well as walking through the scopes.
-  for (; S; S = S->getParent()) {
-    // Check whether the IdResolver has anything in this scope.
-    bool Found = false;
-    for (; I != IEnd && S->isDeclScope(*I); ++I) {
-      if (NamedDecl *ND = R.getAcceptableDecl(*I)) {
-        // We found something.  Look for anything else in our scope
-        // with this same name and in an acceptable identifier
-        // namespace, so that we can construct an overload set if we
-        // need to.
-        Found = true;
-        R.addDecl(ND);
-      }
-    }
-
-    if (Found && S->isTemplateParamScope()) {
-      R.resolveKind();
-      return true;
-    }
-
-    DeclContext *Ctx = S->getEntity();
-    if (!Ctx && S->isTemplateParamScope() && OutsideOfTemplateParamDC &&
-        S->getParent() && !S->getParent()->isTemplateParamScope()) {
-      // We've just searched the last template parameter scope and
-      // found nothing, so look into the contexts between the
-      // lexical and semantic declaration contexts returned by
-      // findOuterContext(). This implements the name lookup behavior
-      // of C++ [temp.local]p8.
-      Ctx = OutsideOfTemplateParamDC;
-      OutsideOfTemplateParamDC = nullptr;
-    }
-
-    if (Ctx) {
-      DeclContext *OuterCtx;
-      bool SearchAfterTemplateScope;
-      std::tie(OuterCtx, SearchAfterTemplateScope) = findOuterContext(S);
-      if (SearchAfterTemplateScope)
-        OutsideOfTemplateParamDC = OuterCtx;
-
-      for (; Ctx && !Ctx->Equals(OuterCtx); Ctx = Ctx->getLookupParent()) {
-        // We do not directly look into transparent contexts, since
-        // those entities will be found in the nearest enclosing
-        // non-transparent context.
-        if (Ctx->isTransparentContext())
-          continue;
-
-        // If we have a context, and it's not a context stashed in the
-        // template parameter scope for an out-of-line definition, also
-        // look into that context.
-        if (!(Found && S && S->isTemplateParamScope())) {
-          assert(Ctx->isFileContext() &&
-              "We should have been looking only at file context here already.");
-
-          // Look into context considering using-directives.
-          if (CppNamespaceLookup(*this, R, Context, Ctx, UDirs))
-            Found = true;
-        }
-
-        if (Found) {
-          R.resolveKind();
-          return true;
-        }
-
-        if (R.isForRedeclaration() && !Ctx->isTransparentContext())
-          return false;
-      }
-    }
-
-    if (R.isForRedeclaration() && Ctx && !Ctx->isTransparentContext())
-      return false;
+  bool Found = LookupInNamespaceScopes(*this, R, S, I, OutsideOfTemplateParamDC,
+                                       UDirs);
+
+  if (Cacheable) {
+    // Declaring a builtin during the lookup adds it to the translation unit.
+    UnqualifiedLookups->validate(Context.getNumFileContextChanges(),
+                                 IdResolver.getNumNonLocalChanges());
+    UnqualifiedLookups->insert(R, S);
   }
-
-  return !R.empty();
+  return Found;
 }
 
 /// \brief Find the declaration that a class temploid member specialization was
@@ -772,6 +772,46 @@ void OverloadCandidateSet::clear() {
   Functions.clear();
 }
 
+void OverloadResolutionCache::validate(unsigned RecordDefinitions,
+                                       unsigned Visibility) {
+  if (RecordDefinitions == RecordDefinitionGeneration &&
+      Visibility == VisibilityGeneration)
+    return;
+  RecordDefinitionGeneration = RecordDefinitions;
+  VisibilityGeneration = Visibility;
+  if (Entries.empty())
+    return;
+  Entries.clear();
+  Allocator.DestroyAll();
+  ++NumFlushes;
+}
+
+const OverloadResolutionCache::Result *
+OverloadResolutionCache::lookup(const llvm::FoldingSetNodeID &ID) {
+  void *InsertPos;
+  if (Entry *E = Entries.FindNodeOrInsertPos(ID, InsertPos)) {
+    ++NumHits;
+    return &E->Resolution;
+  }
+  ++NumMisses;
+  return nullptr;
+}
+
+void OverloadResolutionCache::insert(const llvm::FoldingSetNodeID &ID,
+                                     const Result &Resolution) {
+  void *InsertPos;
+  if (Entries.FindNodeOrInsertPos(ID, InsertPos))
+    return;
+  Entries.InsertNode(new (Allocator.Allocate()) Entry(ID, Resolution),
+                     InsertPos);
+}
+
+void OverloadResolutionCache::PrintStats() const {
+  llvm::errs() << NumHits << " overloaded operators resolved from the cache, "
+               << NumMisses << " resolved, " << NumFlushes
+               << " cache flushes.\n";
+}
+
 namespace {
   class UnbridgedCastsSet {
     struct Entry {
@@ -11057,6 +11097,148 @@ Sema::CreateOverloadedUnaryOp(SourceLocation OpLoc, unsigned OpcIn,
   return CreateBuiltinUnaryOp(OpLoc, Opc, Input);
 }
 
+namespace {
+/// \brief The candidate functions of an overloaded binary operator that are
+/// found by name lookup. They are looked up once, both for the key of the
+/// overload resolution cache and to build the candidate set on a miss.
+struct BinOpLookupResults {
+  /// \brief The member operators of the class of the left operand.
+  LookupResult MemberOperators;
+  /// \brief The functions found by argument-dependent lookup.
+  ADLResult ADLFns;
+
+  BinOpLookupResults(Sema &S, DeclarationName OpName, SourceLocation OpLoc)
+      : MemberOperators(S, OpName, OpLoc, Sema::LookupOrdinaryName) {
+    MemberOperators.suppressDiagnostics();
+  }
+};
+}
+
+/// \brief Compute the key under which the resolution of the binary operator
+/// \p Opc applied to \p Args is kept in the overload resolution cache.
+///
+/// The key is made of the operand types, value kinds and object kinds, and
+/// of every function that can be a candidate: the non-member functions
+/// \p Fns, the member operators of the class of the left operand and the
+/// functions found by argument-dependent lookup, which are stored in
+/// \p Lookups. A declaration of the operator that becomes visible later
+/// changes the key.
+///
+/// \returns false if the resolution depends on more than its key, such as
+/// the value of an operand that could be a null pointer constant, in which
+/// case \p Lookups may be incomplete.
+static bool profileOverloadedBinOp(Sema &S, BinaryOperatorKind Opc,
+                                   const UnresolvedSetImpl &Fns,
+                                   ArrayRef<Expr *> Args,
+                                   BinOpLookupResults &Lookups,
+                                   llvm::FoldingSetNodeID &ID) {
+  // Assignment may declare implicit members of the class, and CUDA target
+  // checks depend on the calling function.
+  if (Opc == BO_Assign || S.getLangOpts().CUDA || S.isSFINAEContext())
+    return false;
+
+  ID.AddInteger(Opc);
+  for (Expr *Arg : Args) {
+    QualType T = Arg->getType();
+    if (Arg->hasPlaceholderType() || Arg->refersToBitField() ||
+        isa<InitListExpr>(Arg) || isa<StringLiteral>(Arg->IgnoreParens()))
+      return false;
+    if (T->isIntegerType() &&
+        Arg->isNullPointerConstant(S.Context,
+                                   Expr::NPC_ValueDependentIsNotNull))
+      return false;
+    if (const RecordType *RT = T->getAs<RecordType>())
+      if (!RT->getDecl()->isCompleteDefinition())
+        return false;
+    ID.AddPointer(S.Context.getCanonicalType(T).getAsOpaquePtr());
+    ID.AddInteger(Arg->getValueKind());
+    ID.AddInteger(Arg->getObjectKind());
+  }
+
+  ID.AddInteger(Fns.size());
+  for (UnresolvedSetIterator I = Fns.begin(), E = Fns.end(); I != E; ++I) {
+    ID.AddPointer(I.getDecl());
+    ID.AddInteger(I.getAccess());
+  }
+
+  LookupResult &Operators = Lookups.MemberOperators;
+  if (const RecordType *RT = Args[0]->getType()->getAs<RecordType>()) {
+    S.LookupQualifiedName(Operators, RT->getDecl());
+    ID.AddInteger(Operators.end() - Operators.begin());
+    for (LookupResult::iterator I = Operators.begin(), E = Operators.end();
+         I != E; ++I) {
+      ID.AddPointer(*I);
+      ID.AddInteger(I.getAccess());
+    }
+  }
+
+  // The order in which argument-dependent lookup returns the functions is
+  // not meaningful, so sort them.
+  S.ArgumentDependentLookup(Operators.getLookupName(), Operators.getNameLoc(),
+                            Args, Lookups.ADLFns);
+  SmallVector<NamedDecl *, 8> Found(Lookups.ADLFns.begin(),
+                                    Lookups.ADLFns.end());
+  std::sort(Found.begin(), Found.end());
+  ID.AddInteger(Found.size());
+  for (NamedDecl *D : Found)
+    ID.AddPointer(D);
+  return true;
+}
+
+/// \brief Add the member operators and the functions found by
+/// argument-dependent lookup in \p Lookups to \p CandidateSet, as
+/// AddMemberOperatorCandidates and AddArgumentDependentLookupCandidates
+/// would.
+static void addLookedUpBinOpCandidates(Sema &S, BinOpLookupResults &Lookups,
+                                       ArrayRef<Expr *> Args,
+                                       OverloadCandidateSet &CandidateSet) {
+  LookupResult &Operators = Lookups.MemberOperators;
+  for (LookupResult::iterator I = Operators.begin(), E = Operators.end();
+       I != E; ++I)
+    S.AddMethodCandidate(I.getPair(), Args[0]->getType(),
+                         Args[0]->Classify(S.Context), Args.slice(1),
+                         CandidateSet, /*SuppressUserConversions=*/false);
+
+  // Functions that are already candidates, or whose template is, are
+  // skipped by the Add*Candidate functions.
+  for (ADLResult::iterator I = Lookups.ADLFns.begin(),
+                           E = Lookups.ADLFns.end();
+       I != E; ++I) {
+    DeclAccessPair FoundDecl = DeclAccessPair::make(*I, AS_none);
+    if (FunctionDecl *FD = dyn_cast<FunctionDecl>(*I))
+      S.AddOverloadCandidate(FD, FoundDecl, Args, CandidateSet);
+    else
+      S.AddTemplateOverloadCandidate(cast<FunctionTemplateDecl>(*I), FoundDecl,
+                                     /*ExplicitTemplateArgs=*/nullptr, Args,
+                                     CandidateSet);
+  }
+}
+
+/// \brief Determine whether the outcome for \p Cand may depend on
+/// declarations that are not part of the key of the overload resolution
+/// cache.
+///
+/// Substituting the deduced arguments into a function template, for example
+/// into a trailing 'decltype(f(T()))', performs argument-dependent lookups
+/// of its own, and a substitution failure is not remembered anywhere. A
+/// later declaration can make the substitution succeed. Successful
+/// substitutions are fine: they produce a specialization, and a later
+/// declaration that changes its meaning makes the program ill-formed
+/// ([temp.point]p8).
+static bool dependsOnLookupOutsideKey(const OverloadCandidate &Cand) {
+  if (Cand.Viable || Cand.FailureKind != ovl_fail_bad_deduction)
+    return false;
+  switch (static_cast<Sema::TemplateDeductionResult>(
+      Cand.DeductionFailure.Result)) {
+  case Sema::TDK_SubstitutionFailure:
+  case Sema::TDK_FailedOverloadResolution:
+  case Sema::TDK_MiscellaneousDeductionFailure:
+    return true;
+  default:
+    return false;
+  }
+}
+
 /// \brief Create a binary operation that may resolve to an overloaded
 /// operator.
 ///
@@ -11144,28 +11326,99 @@ Sema::CreateOverloadedBinOp(SourceLocation OpLoc,
   // Build an empty overload set.
   OverloadCandidateSet CandidateSet(OpLoc, OverloadCandidateSet::CSK_Operator);
 
-  // Add the candidates from the given function set.
-  AddFunctionCandidates(Fns, Args, CandidateSet);
-
-  // Add operator candidates that are member functions.
-  AddMemberOperatorCandidates(Op, OpLoc, Args, CandidateSet);
+  // If this operator was resolved before for operands of the same types and
+  // with the same candidate functions, only the function that won then needs
+  // to be considered.
+  llvm::FoldingSetNodeID CacheID;
+  BinOpLookupResults Lookups(*this, OpName, OpLoc);
+  bool Cacheable = getLangOpts().CacheOverloadResolution &&
+                   profileOverloadedBinOp(*this, Opc, Fns, Args, Lookups,
+                                          CacheID);
+
+  auto AddAllCandidates = [&] {
+    // Add the candidates from the given function set.
+    AddFunctionCandidates(Fns, Args, CandidateSet);
+
+    if (Cacheable) {
+      // The member operators and ADL were already looked up for the key.
+      addLookedUpBinOpCandidates(*this, Lookups, Args, CandidateSet);
+    } else {
+      // Add operator candidates that are member functions.
+      AddMemberOperatorCandidates(Op, OpLoc, Args, CandidateSet);
 
-  // Add candidates from ADL. Per [over.match.oper]p2, this lookup is not
-  // performed for an assignment operator (nor for operator[] nor operator->,
-  // which don't get here).
-  if (Opc != BO_Assign)
-    AddArgumentDependentLookupCandidates(OpName, OpLoc, Args,
-                                         /*ExplicitTemplateArgs*/ nullptr,
-                                         CandidateSet);
+      // Add candidates from ADL. Per [over.match.oper]p2, this lookup is not
+      // performed for an assignment operator (nor for operator[] nor
+      // operator->, which don't get here).
+      if (Opc != BO_Assign)
+        AddArgumentDependentLookupCandidates(OpName, OpLoc, Args,
+                                             /*ExplicitTemplateArgs*/ nullptr,
+                                             CandidateSet);
+    }
 
-  // Add builtin operator candidates.
-  AddBuiltinOperatorCandidates(Op, OpLoc, Args, CandidateSet);
+    // Add builtin operator candidates.
+    AddBuiltinOperatorCandidates(Op, OpLoc, Args, CandidateSet);
+  };
 
-  bool HadMultipleCandidates = (CandidateSet.size() > 1);
+  const OverloadResolutionCache::Result *Cached = nullptr;
+  if (Cacheable) {
+    if (!OverloadCache)
+      OverloadCache.reset(new OverloadResolutionCache());
+    OverloadCache->validate(Context.getNumRecordDefinitionsCompleted(),
+                            VisibleModules.getGeneration());
+    Cached = OverloadCache->lookup(CacheID);
+  }
+
+  bool HadMultipleCandidates;
+  if (Cached) {
+    if (CXXMethodDecl *Method = dyn_cast<CXXMethodDecl>(Cached->Function))
+      AddMethodCandidate(Method, Cached->FoundDecl,
+                         cast<CXXRecordDecl>(
+                             Cached->FoundDecl.getDecl()->getDeclContext()),
+                         Args[0]->getType(), Args[0]->Classify(Context),
+                         llvm::makeArrayRef(Args).slice(1), CandidateSet,
+                         /*SuppressUserConversions=*/false);
+    else
+      AddOverloadCandidate(Cached->Function, Cached->FoundDecl, Args,
+                           CandidateSet);
+    HadMultipleCandidates = Cached->HadMultipleCandidates;
+  } else {
+    AddAllCandidates();
+    HadMultipleCandidates = (CandidateSet.size() > 1);
+  }
 
   // Perform overload resolution.
   OverloadCandidateSet::iterator Best;
-  switch (CandidateSet.BestViableFunction(*this, OpLoc, Best)) {
+  OverloadingResult Ovl = CandidateSet.BestViableFunction(*this, OpLoc, Best);
+  if (Cached && Ovl != OR_Success) {
+    // The cached function is not viable after all; start over so that any
+    // diagnostic lists every candidate.
+    CandidateSet.clear();
+    AddAllCandidates();
+    HadMultipleCandidates = (CandidateSet.size() > 1);
+    Ovl = CandidateSet.BestViableFunction(*this, OpLoc, Best);
+    Cached = nullptr;
+  }
+
+  // Remember the function that won. Results that depend on the values of
+  // the operands through enable_if or on lookups made while substituting
+  // into a template, or that were computed while errors may have left
+  // declarations invalid, are not remembered.
+  if (Cacheable && !Cached && Ovl == OR_Success && Best->Function &&
+      !getDiagnostics().hasErrorOccurred() &&
+      std::none_of(CandidateSet.begin(), CandidateSet.end(),
+                   [](const OverloadCandidate &Cand) {
+                     return (Cand.Function &&
+                             Cand.Function->hasAttr<EnableIfAttr>()) ||
+                            dependsOnLookupOutsideKey(Cand);
+                   })) {
+    OverloadResolutionCache::Result Resolution = {
+        Best->Function, Best->FoundDecl, HadMultipleCandidates};
+    OverloadCache->validate(Context.getNumRecordDefinitionsCompleted(),
+                            VisibleModules.getGeneration());
+    OverloadCache->insert(CacheID, Resolution);
+  }
+
+  switch (Ovl) {
     case OR_Success: {
       // We found a built-in operator or an overloaded operator.
       FunctionDecl *FnDecl = Best->Function;
@@ -17,7 +17,10 @@
 #include "clang/AST/ASTLambda.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Expr.h"
+#include "clang/Basic/CostReport.h"
 #include "clang/Basic/LangOptions.h"
+#include "clang/Basic/PhaseProfile.h"
+#include "clang/Lex/Preprocessor.h"
 #include "clang/Sema/DeclSpec.h"
 #include "clang/Sema/Initialization.h"
 #include "clang/Sema/Lookup.h"
@@ -200,6 +203,21 @@ bool Sema::ActiveTemplateInstantiation::isInstantiationRecord() const {
   llvm_unreachable("Invalid InstantiationKind!");
 }
 
+/// \brief Returns the name \p Entity is charged to in the cost report.
+static std::string getCostReportName(Sema &S, Decl *Entity) {
+  // Default arguments are charged to the function they belong to.
+  if (ParmVarDecl *Param = dyn_cast_or_null<ParmVarDecl>(Entity))
+    Entity = Decl::castFromDeclContext(Param->getDeclContext());
+
+  std::string Name;
+  llvm::raw_string_ostream OS(Name);
+  if (NamedDecl *ND = dyn_cast_or_null<NamedDecl>(Entity))
+    ND->getNameForDiagnostic(OS, S.getPrintingPolicy(), /*Qualified=*/true);
+  else
+    OS << "<unnamed>";
+  return OS.str();
+}
+
 Sema::InstantiatingTemplate::InstantiatingTemplate(
     Sema &SemaRef, ActiveTemplateInstantiation::InstantiationKind Kind,
     SourceLocation PointOfInstantiation, SourceRange InstantiationRange,
@@ -228,6 +246,9 @@ Sema::InstantiatingTemplate::InstantiatingTemplate(
     SemaRef.ActiveTemplateInstantiations.push_back(Inst);
     if (!Inst.isInstantiationRecord())
       ++SemaRef.NonInstantiationEntries;
+    else if (CostReport *Costs = SemaRef.Context.getCostReport())
+      Costs->enter(CostReport::TemplateInstantiation,
+                   getCostReportName(SemaRef, Entity));
   }
 }
 
@@ -329,6 +350,8 @@ void Sema::InstantiatingTemplate::Clear() {
     if (!SemaRef.ActiveTemplateInstantiations.back().isInstantiationRecord()) {
       assert(SemaRef.NonInstantiationEntries > 0);
       --SemaRef.NonInstantiationEntries;
+    } else if (CostReport *Costs = SemaRef.Context.getCostReport()) {
+      Costs->exit(CostReport::TemplateInstantiation);
     }
     SemaRef.InNonInstantiationSFINAEContext
       = SavedInNonInstantiationSFINAEContext;
@@ -618,6 +641,102 @@ getDepthAndIndex(NamedDecl *ND) {
   return std::make_pair(TTP->getDepth(), TTP->getIndex());
 }
 
+/// \brief Determine whether the expression \p E of a template pattern can be
+/// reused as is by every instantiation of the pattern.
+///
+/// TreeTransform drops implicit conversions and rebuilds every operator above
+/// them through Sema, even when nothing in the tree depends on the template
+/// arguments. Expressions that refer to declarations still have to be
+/// transformed, since local declarations are remapped and uses are marked
+/// per instantiation, so only trees built from literals, enumerators and
+/// value-preserving conversions are shared.
+///
+/// A shared node must not be changed by a later step of Sema, since the
+/// change would show through in the pattern and in every other
+/// specialization. String literals are excluded for that reason: the
+/// initialization of a character array retypes the literal, and the
+/// parentheses around it, to the type of the array.
+static bool isShareableInstantiationExpr(Sema &S, const Expr *E) {
+  llvm::DenseMap<const Expr *, bool>::iterator Known
+    = S.ShareableInstantiationExprs.find(E);
+  if (Known != S.ShareableInstantiationExprs.end())
+    return Known->second;
+
+  bool Shareable = !E->isInstantiationDependent() &&
+                   !E->containsUnexpandedParameterPack() &&
+                   !E->getType()->isVariablyModifiedType();
+  if (Shareable) {
+    switch (E->getStmtClass()) {
+    case Stmt::IntegerLiteralClass:
+    case Stmt::FloatingLiteralClass:
+    case Stmt::ImaginaryLiteralClass:
+    case Stmt::CharacterLiteralClass:
+    case Stmt::CXXBoolLiteralExprClass:
+    case Stmt::CXXNullPtrLiteralExprClass:
+    case Stmt::ParenExprClass:
+    case Stmt::UnaryOperatorClass:
+    case Stmt::BinaryOperatorClass:
+    case Stmt::ConditionalOperatorClass:
+      break;
+
+    case Stmt::UnaryExprOrTypeTraitExprClass: {
+      const UnaryExprOrTypeTraitExpr *Trait
+        = cast<UnaryExprOrTypeTraitExpr>(E);
+      Shareable = !Trait->isArgumentType() ||
+                  !Trait->getArgumentType()->isVariablyModifiedType();
+      break;
+    }
+
+    case Stmt::ImplicitCastExprClass:
+    case Stmt::CStyleCastExprClass:
+    case Stmt::CXXStaticCastExprClass:
+      switch (cast<CastExpr>(E)->getCastKind()) {
+      case CK_NoOp:
+      case CK_IntegralCast:
+      case CK_IntegralToBoolean:
+      case CK_IntegralToFloating:
+      case CK_FloatingToIntegral:
+      case CK_FloatingCast:
+      case CK_FloatingToBoolean:
+      case CK_ArrayToPointerDecay:
+      case CK_NullToPointer:
+        break;
+      default:
+        Shareable = false;
+        break;
+      }
+      break;
+
+    case Stmt::DeclRefExprClass: {
+      const DeclRefExpr *DRE = cast<DeclRefExpr>(E);
+      const EnumConstantDecl *Enumerator
+        = dyn_cast<EnumConstantDecl>(DRE->getDecl());
+      Shareable = Enumerator && !DRE->hasExplicitTemplateArgs() &&
+                  !Enumerator->getDeclContext()->isDependentContext();
+      break;
+    }
+
+    default:
+      Shareable = false;
+      break;
+    }
+  }
+
+  if (Shareable) {
+    for (const Stmt *Child : E->children()) {
+      const Expr *ChildExpr = dyn_cast_or_null<Expr>(Child);
+      if (!ChildExpr || !isShareableInstantiationExpr(S, ChildExpr)) {
+        Shareable = false;
+        break;
+      }
+    }
+  }
+
+  // The recursion above may have grown the map, so insert afresh.
+  S.ShareableInstantiationExprs[E] = Shareable;
+  return Shareable;
+}
+
 //===----------------------------------------------------------------------===/
 // Template Instantiation for Types
 //===----------------------------------------------------------------------===/
@@ -767,6 +886,18 @@ namespace {
 
     const LoopHintAttr *TransformLoopHintAttr(const LoopHintAttr *LH);
 
+    /// \brief Reuse the pattern's expression when no instantiation of it
+    /// could differ from it; transform it otherwise.
+    ExprResult TransformExpr(Expr *E) {
+      if (E && !AlwaysRebuild() && !isa<ImplicitCastExpr>(E) &&
+          isShareableInstantiationExpr(getSema(), E)) {
+        ++getSema().NumSharedInstantiatedExprs;
+        return E;
+      }
+      ++getSema().NumRebuiltInstantiatedExprs;
+      return inherited::TransformExpr(E);
+    }
+
     ExprResult TransformPredefinedExpr(PredefinedExpr *E);
     ExprResult TransformDeclRefExpr(DeclRefExpr *E);
     ExprResult TransformCXXDefaultArgExpr(CXXDefaultArgExpr *E);
@@ -1940,6 +2071,9 @@ Sema::InstantiateClass(SourceLocation PointOfInstantiation,
     return true;
   Pattern = PatternDef;
 
+  PhaseProfile::Region ProfileRegion(PP.getPhaseProfile(),
+                                     PhaseProfile::TemplateInstantiation);
+
   // \brief Record the point of instantiation.
   if (MemberSpecializationInfo *MSInfo 
         = Instantiation->getMemberSpecializationInfo()) {
@@ -2157,6 +2291,9 @@ bool Sema::InstantiateEnum(SourceLocation PointOfInstantiation,
     return true;
   Pattern = PatternDef;
 
+  PhaseProfile::Region ProfileRegion(PP.getPhaseProfile(),
+                                     PhaseProfile::TemplateInstantiation);
+
   // Record the point of instantiation.
   if (MemberSpecializationInfo *MSInfo
         = Instantiation->getMemberSpecializationInfo()) {
@@ -25,6 +25,7 @@
 #include "clang/AST/TypeLocVisitor.h"
 #include "clang/Basic/DiagnosticOptions.h"
 #include "clang/Basic/FileManager.h"
+#include "clang/Basic/PhaseProfile.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/SourceManagerInternals.h"
 #include "clang/Basic/TargetInfo.h"
@@ -2157,6 +2158,25 @@ ASTReader::ReadControlBlock(ModuleFile &F,
       break;
 
     case IMPORTS: {
+      // Read the imported files concurrently, so that loading them below
+      // does not wait for each of them in turn.
+      if (ModuleFilePrefetchThreads > 1) {
+        std::vector<ModuleManager::PrefetchedModuleFile> ImportedFiles;
+        for (unsigned Idx = 0, N = Record.size(); Idx < N;) {
+          ModuleManager::PrefetchedModuleFile File;
+          File.Type = (ModuleKind)Record[Idx++];
+          ++Idx; // ImportLoc
+          File.ExpectedSize = (off_t)Record[Idx++];
+          File.ExpectedModTime = (time_t)Record[Idx++];
+          ++Idx; // Signature
+          File.FileName = ReadPath(F, Record, Idx);
+          ImportedFiles.push_back(std::move(File));
+        }
+        llvm::TimeRegion TimePrefetch(PrefetchTimer.get());
+        NumModuleFileBytesPrefetched += ModuleMgr.prefetchModuleFiles(
+            ImportedFiles, ModuleFilePrefetchThreads);
+      }
+
       // Load each of the imported PCH files. 
       unsigned Idx = 0, N = Record.size();
       while (Idx < N) {
@@ -3347,6 +3367,9 @@ ASTReader::ASTReadResult ASTReader::ReadAST(const std::string &FileName,
   llvm::SaveAndRestore<SourceLocation>
     SetCurImportLocRAII(CurrentImportLoc, ImportLoc);
 
+  PhaseProfile::Region ProfileRegion(PP.getPhaseProfile(),
+                                     PhaseProfile::ModuleLoading);
+
   // Defer any pending actions until we get to the end of reading the AST file.
   Deserializing AnASTFile(this);
 
@@ -3355,10 +3378,16 @@ ASTReader::ASTReadResult ASTReader::ReadAST(const std::string &FileName,
 
   unsigned NumModules = ModuleMgr.size();
   SmallVector<ImportedModule, 4> Loaded;
-  switch(ASTReadResult ReadResult = ReadASTCore(FileName, Type, ImportLoc,
-                                                /*ImportedBy=*/nullptr, Loaded,
-                                                0, 0, 0,
-                                                ClientLoadCapabilities)) {
+  ASTReadResult ReadResult = ReadASTCore(FileName, Type, ImportLoc,
+                                         /*ImportedBy=*/nullptr, Loaded,
+                                         0, 0, 0,
+                                         ClientLoadCapabilities);
+
+  // Module files that were read ahead of time but not loaded may be rebuilt
+  // before they are loaded again.
+  ModuleMgr.clearPrefetchedModuleFiles();
+
+  switch (ReadResult) {
   case Failure:
   case Missing:
   case OutOfDate:
@@ -6647,6 +6676,9 @@ void ASTReader::PrintStats() {
                                           SelectorsLoaded.end(),
                                           Selector());
 
+  if (NumModuleFileBytesPrefetched)
+    std::fprintf(stderr, "  %llu bytes of module files read ahead of time\n",
+                 (unsigned long long)NumModuleFileBytesPrefetched);
   if (unsigned TotalNumSLocEntries = getTotalNumSLocs())
     std::fprintf(stderr, "  %u/%u source location entries read (%f%%)\n",
                  NumSLocEntriesRead, TotalNumSLocEntries,
@@ -8499,8 +8531,9 @@ ASTReader::ASTReader(Preprocessor &PP, ASTContext &Context,
       FileMgr(PP.getFileManager()), PCHContainerRdr(PCHContainerRdr),
       Diags(PP.getDiagnostics()), SemaObj(nullptr), PP(PP), Context(Context),
       Consumer(nullptr), ModuleMgr(PP.getFileManager(), PCHContainerRdr),
-      ReadTimer(std::move(ReadTimer)),
-      isysroot(isysroot), DisableValidation(DisableValidation),
+      ReadTimer(std::move(ReadTimer)), ModuleFilePrefetchThreads(0),
+      NumModuleFileBytesPrefetched(0), isysroot(isysroot),
+      DisableValidation(DisableValidation),
       AllowASTWithCompilerErrors(AllowASTWithCompilerErrors),
       AllowConfigurationMismatch(AllowConfigurationMismatch),
       ValidateSystemInputs(ValidateSystemInputs),
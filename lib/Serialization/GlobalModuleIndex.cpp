@@ -239,8 +239,12 @@ GlobalModuleIndex::readIndex(StringRef Path) {
   IndexPath += Path;
   llvm::sys::path::append(IndexPath, IndexFileName);
 
+  // The bitstream reader doesn't need a null terminator. Not requiring one
+  // lets MemoryBuffer map the file whenever it is large enough for mapping to
+  // pay off; smaller files are still read.
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> BufferOrErr =
-      llvm::MemoryBuffer::getFile(IndexPath.c_str());
+      llvm::MemoryBuffer::getFile(IndexPath.c_str(), /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
   if (!BufferOrErr)
     return std::make_pair(nullptr, EC_NotFound);
   std::unique_ptr<llvm::MemoryBuffer> Buffer = std::move(BufferOrErr.get());
@@ -381,7 +385,9 @@ namespace {
     /// a module ID.
     SmallVector<unsigned, 4> Dependencies;
   };
+}
 
+namespace clang {
   /// \brief Builder that generates the global module index file.
   class GlobalModuleIndexBuilder {
     FileManager &FileMgr;
@@ -400,6 +406,17 @@ namespace {
     /// \brief A mapping from all interesting identifiers to the set of module
     /// files in which those identifiers are considered interesting.
     InterestingIdentifierMap InterestingIdentifiers;
+
+    /// \brief The previously written index, if any.
+    GlobalModuleIndex *PreviousIndex;
+
+    /// \brief The module files of the previous index that have not changed
+    /// since it was written, mapped to their ID in that index.
+    llvm::DenseMap<const FileEntry *, unsigned> UnchangedModuleFiles;
+
+    /// \brief Mapping from the IDs of the reused module files in the previous
+    /// index to their IDs in the new index.
+    llvm::DenseMap<unsigned, unsigned> ReusedModuleIDs;
     
     /// \brief Write the block-info block for the global module index file.
     void emitBlockInfoBlock(llvm::BitstreamWriter &Stream);
@@ -420,13 +437,29 @@ namespace {
   public:
     explicit GlobalModuleIndexBuilder(
         FileManager &FileMgr, const PCHContainerReader &PCHContainerRdr)
-        : FileMgr(FileMgr), PCHContainerRdr(PCHContainerRdr) {}
+        : FileMgr(FileMgr), PCHContainerRdr(PCHContainerRdr),
+          PreviousIndex(nullptr) {}
 
     /// \brief Load the contents of the given module file into the builder.
     ///
     /// \returns true if an error occurred, false otherwise.
     bool loadModuleFile(const FileEntry *File);
 
+    /// \brief Use the information in \p Index for the module files that have
+    /// not changed since it was written.
+    void setPreviousIndex(GlobalModuleIndex &Index);
+
+    /// \brief Add the given module file using the information of the previous
+    /// index, without reading it.
+    ///
+    /// \returns true if the previous index has no up-to-date information about
+    /// this module file or one of its dependencies, false otherwise.
+    bool reuseModuleFile(const FileEntry *File);
+
+    /// \brief Add the identifiers of the module files added by
+    /// \c reuseModuleFile. The previous index isn't used after this.
+    void addReusedIdentifiers();
+
     /// \brief Write the index to the given bitstream.
     void writeIndex(llvm::BitstreamWriter &Stream);
   };
@@ -644,6 +677,75 @@ bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
   return false;
 }
 
+void GlobalModuleIndexBuilder::setPreviousIndex(GlobalModuleIndex &Index) {
+  PreviousIndex = &Index;
+  for (unsigned ID = 0, N = Index.Modules.size(); ID != N; ++ID) {
+    const GlobalModuleIndex::ModuleInfo &Info = Index.Modules[ID];
+    if (Info.FileName.empty())
+      continue;
+
+    const FileEntry *File = FileMgr.getFile(Info.FileName, /*openFile=*/false,
+                                            /*cacheFailure=*/false);
+    if (File && File->getSize() == Info.Size &&
+        File->getModificationTime() == Info.ModTime)
+      UnchangedModuleFiles[File] = ID;
+  }
+}
+
+bool GlobalModuleIndexBuilder::reuseModuleFile(const FileEntry *File) {
+  auto Known = UnchangedModuleFiles.find(File);
+  if (Known == UnchangedModuleFiles.end())
+    return true;
+
+  // A module file whose dependencies changed is out of date, so don't add it
+  // unless all of its dependencies are unchanged too.
+  const GlobalModuleIndex::ModuleInfo &Info =
+      PreviousIndex->Modules[Known->second];
+  SmallVector<const FileEntry *, 4> Dependencies;
+  for (unsigned DependsOnID : Info.Dependencies) {
+    if (DependsOnID >= PreviousIndex->Modules.size())
+      return true;
+    const FileEntry *DependsOnFile = FileMgr.getFile(
+        PreviousIndex->Modules[DependsOnID].FileName, /*openFile=*/false,
+        /*cacheFailure=*/false);
+    if (!DependsOnFile || !UnchangedModuleFiles.count(DependsOnFile))
+      return true;
+    Dependencies.push_back(DependsOnFile);
+  }
+
+  unsigned ID = getModuleFileInfo(File).ID;
+  for (const FileEntry *DependsOnFile : Dependencies) {
+    unsigned DependsOnID = getModuleFileInfo(DependsOnFile).ID;
+    getModuleFileInfo(File).Dependencies.push_back(DependsOnID);
+  }
+  ReusedModuleIDs[Known->second] = ID;
+  return false;
+}
+
+void GlobalModuleIndexBuilder::addReusedIdentifiers() {
+  if (!PreviousIndex || !PreviousIndex->IdentifierIndex ||
+      ReusedModuleIDs.empty()) {
+    PreviousIndex = nullptr;
+    return;
+  }
+
+  IdentifierIndexTable &Table =
+      *static_cast<IdentifierIndexTable *>(PreviousIndex->IdentifierIndex);
+  for (IdentifierIndexTable::key_iterator K = Table.key_begin(),
+                                          KEnd = Table.key_end();
+       K != KEnd; ++K) {
+    StringRef Name = *K;
+    SmallVector<unsigned, 2> PreviousIDs = *Table.find(Name);
+    SmallVector<unsigned, 2> &IDs = InterestingIdentifiers[Name];
+    for (unsigned PreviousID : PreviousIDs) {
+      auto Reused = ReusedModuleIDs.find(PreviousID);
+      if (Reused != ReusedModuleIDs.end())
+        IDs.push_back(Reused->second);
+    }
+  }
+  PreviousIndex = nullptr;
+}
+
 namespace {
 
 /// \brief Trait used to generate the identifier index as an on-disk hash
@@ -769,7 +871,8 @@ void GlobalModuleIndexBuilder::writeIndex(llvm::BitstreamWriter &Stream) {
 GlobalModuleIndex::ErrorCode
 GlobalModuleIndex::writeIndex(FileManager &FileMgr,
                               const PCHContainerReader &PCHContainerRdr,
-                              StringRef Path) {
+                              StringRef Path, unsigned *NumModuleFilesRead,
+                              unsigned *NumModuleFilesReused) {
   llvm::SmallString<128> IndexPath;
   IndexPath += Path;
   llvm::sys::path::append(IndexPath, IndexFileName);
@@ -794,7 +897,15 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
   // The module index builder.
   GlobalModuleIndexBuilder Builder(FileMgr, PCHContainerRdr);
 
+  // Reuse what the existing index knows about the module files that have not
+  // changed since it was written, so that only new and rebuilt module files
+  // have to be read.
+  std::unique_ptr<GlobalModuleIndex> PreviousIndex(readIndex(Path).first);
+  if (PreviousIndex)
+    Builder.setPreviousIndex(*PreviousIndex);
+
   // Load each of the module files.
+  unsigned NumRead = 0, NumReused = 0;
   std::error_code EC;
   for (llvm::sys::fs::directory_iterator D(Path, EC), DEnd;
        D != DEnd && !EC;
@@ -815,10 +926,23 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
     if (!ModuleFile)
       continue;
 
-    // Load this module file.
+    // Load this module file, unless the existing index is up to date for it.
+    if (!Builder.reuseModuleFile(ModuleFile)) {
+      ++NumReused;
+      continue;
+    }
     if (Builder.loadModuleFile(ModuleFile))
       return EC_IOError;
+    ++NumRead;
   }
+  if (NumModuleFilesRead)
+    *NumModuleFilesRead = NumRead;
+  if (NumModuleFilesReused)
+    *NumModuleFilesReused = NumReused;
+
+  // Release the existing index before it is replaced.
+  Builder.addReusedIdentifiers();
+  PreviousIndex.reset();
 
   // The output buffer, into which the global index will be written.
   SmallVector<char, 16> OutputBuffer;
@@ -16,10 +16,13 @@
 #include "clang/Lex/ModuleMap.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
 #include "clang/Serialization/ModuleManager.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
 #include <system_error>
+#include <thread>
 
 #ifndef NDEBUG
 #include "llvm/Support/GraphWriter.h"
@@ -116,6 +119,10 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
     if (std::unique_ptr<llvm::MemoryBuffer> Buffer = lookupBuffer(FileName)) {
       // The buffer was already provided for us.
       New->Buffer = std::move(Buffer);
+    } else if (PrefetchedBuffers.count(Entry)) {
+      // The file was read ahead of time by prefetchModuleFiles.
+      New->Buffer = std::move(PrefetchedBuffers[Entry]);
+      PrefetchedBuffers.erase(Entry);
     } else {
       // Open the AST file.
       llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf(
@@ -249,6 +256,69 @@ ModuleManager::addInMemoryBuffer(StringRef FileName,
   InMemoryBuffers[Entry] = std::move(Buffer);
 }
 
+uint64_t ModuleManager::prefetchModuleFiles(
+    ArrayRef<PrefetchedModuleFile> FilesToRead, unsigned NumThreads) {
+#if LLVM_ENABLE_THREADS
+  struct PrefetchedFile {
+    const FileEntry *Entry;
+    std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  };
+  std::vector<PrefetchedFile> Files;
+  for (const PrefetchedModuleFile &File : FilesToRead) {
+    // Open and check the file like addModule does, so that the buffer is
+    // read from the same underlying file that addModule would read.
+    time_t ExpectedModTime =
+        File.Type == MK_ExplicitModule ? 0 : File.ExpectedModTime;
+    const FileEntry *Entry;
+    if (lookupModuleFile(File.FileName, File.ExpectedSize, ExpectedModTime,
+                         Entry) ||
+        !Entry || Modules.count(Entry) || InMemoryBuffers.count(Entry) ||
+        PrefetchedBuffers.count(Entry))
+      continue;
+    Files.push_back({Entry, nullptr});
+  }
+  if (Files.size() < 2 || NumThreads < 2)
+    return 0;
+
+  // The workers only read the files left open by lookupModuleFile, which
+  // doesn't modify the file manager. Treat the files as volatile so that
+  // they are read rather than mapped, and the I/O actually happens on the
+  // worker threads.
+  std::atomic<unsigned> NextFile(0);
+  auto ReadFiles = [&] {
+    for (unsigned I = NextFile++; I < Files.size(); I = NextFile++) {
+      llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+          FileMgr.getBufferForFile(Files[I].Entry, /*isVolatile=*/true,
+                                   /*ShouldCloseOpenFile=*/false);
+      // If the file changed since it was looked up, let addModule deal with
+      // it.
+      if (Buffer &&
+          (*Buffer)->getBufferSize() == (uint64_t)Files[I].Entry->getSize())
+        Files[I].Buffer = std::move(*Buffer);
+    }
+  };
+
+  std::vector<std::thread> Workers;
+  for (unsigned I = 1, E = std::min<size_t>(NumThreads, Files.size()); I != E;
+       ++I)
+    Workers.emplace_back(ReadFiles);
+  ReadFiles();
+  for (std::thread &Worker : Workers)
+    Worker.join();
+
+  uint64_t BytesRead = 0;
+  for (PrefetchedFile &File : Files) {
+    if (!File.Buffer)
+      continue;
+    BytesRead += File.Buffer->getBufferSize();
+    PrefetchedBuffers[File.Entry] = std::move(File.Buffer);
+  }
+  return BytesRead;
+#else
+  return 0;
+#endif
+}
+
 bool ModuleManager::addKnownModuleFile(StringRef FileName) {
   const FileEntry *File;
   if (lookupModuleFile(FileName, 0, 0, File))
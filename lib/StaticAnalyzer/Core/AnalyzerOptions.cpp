@@ -69,6 +69,23 @@ IPAKind AnalyzerOptions::getIPAMode() {
   return IPAMode;
 }
 
+ExplorationStrategyKind AnalyzerOptions::getExplorationStrategy() {
+  if (ExplorationStrategy == ESK_NotSet) {
+    StringRef StratStr =
+        Config.insert(std::make_pair("exploration_strategy", "dfs"))
+            .first->second;
+    ExplorationStrategy = llvm::StringSwitch<ExplorationStrategyKind>(StratStr)
+      .Case("dfs", ESK_DFS)
+      .Case("bfs", ESK_BFS)
+      .Case("bfs_block_dfs_contents", ESK_BFSBlockDFSContents)
+      .Case("unexplored_first", ESK_UnexploredFirst)
+      .Default(ESK_NotSet);
+    assert(ExplorationStrategy != ESK_NotSet &&
+           "Exploration strategy is invalid.");
+  }
+  return ExplorationStrategy;
+}
+
 bool
 AnalyzerOptions::mayInlineCXXMemberFunction(CXXInlineableMemberKind K) {
   if (getIPAMode() < IPAK_Inlining)
@@ -289,6 +306,18 @@ unsigned AnalyzerOptions::getGraphTrimInterval() {
   return GraphTrimInterval.getValue();
 }
 
+bool AnalyzerOptions::shouldReclaimGraphGenerations() {
+  return getBooleanOption(ReclaimGraphGenerations,
+                          "graph-generational-reclaim",
+                          /* Default = */ false);
+}
+
+bool AnalyzerOptions::shouldMergeStatesAtJoins() {
+  return getBooleanOption(MergeStatesAtJoins,
+                          "state-merging",
+                          /* Default = */ false);
+}
+
 unsigned AnalyzerOptions::getMaxTimesInlineLarge() {
   if (!MaxTimesInlineLarge.hasValue())
     MaxTimesInlineLarge = getOptionAsInteger("max-times-inline-large", 32);
@@ -314,6 +343,12 @@ unsigned AnalyzerOptions::getMaxNodesPerTopLevelFunction() {
   return MaxNodesPerTopLevelFunction.getValue();
 }
 
+unsigned AnalyzerOptions::getWorkerProcesses() {
+  if (!WorkerProcesses.hasValue())
+    WorkerProcesses = getOptionAsInteger("worker-processes", 0);
+  return WorkerProcesses.getValue();
+}
+
 bool AnalyzerOptions::shouldSynthesizeBodies() {
   return getBooleanOption("faux-bodies", true);
 }
@@ -21,6 +21,9 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <algorithm>
+#include <vector>
 
 using namespace clang;
 using namespace ento;
@@ -157,10 +160,101 @@ WorkList* WorkList::makeBFSBlockDFSContents() {
   return new BFSBlockDFSContents();
 }
 
+namespace {
+  class UnexploredFirst : public WorkList {
+    /// A unit with the number of times its CFG block had been entered in its
+    /// stack frame when it was enqueued, and the order of enqueueing.
+    struct PrioritizedUnit {
+      WorkListUnit U;
+      unsigned Entered;
+      unsigned Order;
+
+      /// Prefer units entering less explored blocks, then the most recently
+      /// enqueued ones, as with DFS.
+      bool operator<(const PrioritizedUnit &Other) const {
+        if (Entered != Other.Entered)
+          return Entered > Other.Entered;
+        return Order < Other.Order;
+      }
+    };
+
+    typedef std::pair<const CFGBlock *, const StackFrameContext *> BlockKey;
+
+    /// The number of times each CFG block was entered in each stack frame.
+    llvm::DenseMap<BlockKey, unsigned> TimesEntered;
+
+    /// A max-heap of the queued units.
+    std::vector<PrioritizedUnit> Heap;
+    unsigned NextOrder;
+
+  public:
+    UnexploredFirst() : NextOrder(0) {}
+
+    bool hasWork() const override {
+      return !Heap.empty();
+    }
+
+    void enqueue(const WorkListUnit& U) override {
+      // Keep working on the contents of a block once it has been entered.
+      unsigned Entered = 0;
+      const ExplodedNode *N = U.getNode();
+      if (Optional<BlockEntrance> BE = N->getLocation().getAs<BlockEntrance>())
+        Entered = TimesEntered[BlockKey(BE->getBlock(),
+                                        N->getStackFrame())]++;
+
+      PrioritizedUnit PU = { U, Entered, NextOrder++ };
+      Heap.push_back(PU);
+      std::push_heap(Heap.begin(), Heap.end());
+    }
+
+    WorkListUnit dequeue() override {
+      assert(!Heap.empty());
+      std::pop_heap(Heap.begin(), Heap.end());
+      WorkListUnit U = Heap.back().U;
+      Heap.pop_back();
+      return U;
+    }
+
+    bool visitItemsInWorkList(Visitor &V) override {
+      for (std::vector<PrioritizedUnit>::iterator
+           I = Heap.begin(), E = Heap.end(); I != E; ++I) {
+        if (V.visit(I->U))
+          return true;
+      }
+      return false;
+    }
+  };
+} // end anonymous namespace
+
+WorkList *WorkList::makeUnexploredFirst() {
+  return new UnexploredFirst();
+}
+
+static WorkList *generateWorkList(AnalyzerOptions &Opts) {
+  switch (Opts.getExplorationStrategy()) {
+  case ESK_DFS:
+    return WorkList::makeDFS();
+  case ESK_BFS:
+    return WorkList::makeBFS();
+  case ESK_BFSBlockDFSContents:
+    return WorkList::makeBFSBlockDFSContents();
+  case ESK_UnexploredFirst:
+    return WorkList::makeUnexploredFirst();
+  case ESK_NotSet:
+    break;
+  }
+  llvm_unreachable("Unknown AnalyzerOptions::ExplorationStrategyKind");
+}
+
 //===----------------------------------------------------------------------===//
 // Core analysis engine.
 //===----------------------------------------------------------------------===//
 
+CoreEngine::CoreEngine(SubEngine &subengine, FunctionSummariesTy *FS,
+                       AnalyzerOptions &Opts)
+    : SubEng(subengine), WList(generateWorkList(Opts)),
+      BCounterFactory(G.getAllocator()), FunctionSummaries(FS) {}
+
 /// ExecuteWorkList - Run the worklist algorithm for a maximum number of steps.
 bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
                                    ProgramStateRef InitState) {
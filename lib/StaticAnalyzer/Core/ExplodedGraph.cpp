@@ -19,13 +19,20 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramState.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include <algorithm>
 #include <vector>
 
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ExplodedGraph"
+
+STATISTIC(NumNodesReclaimed,
+          "The # of exploded nodes freed by generational reclamation.");
+
 //===----------------------------------------------------------------------===//
 // Node auditing.
 //===----------------------------------------------------------------------===//
@@ -48,7 +55,7 @@ void ExplodedNode::SetAuditor(ExplodedNode::Auditor* A) {
 //===----------------------------------------------------------------------===//
 
 ExplodedGraph::ExplodedGraph()
-  : NumNodes(0), ReclaimNodeInterval(0) {}
+  : NumNodes(0), ReclaimNodeInterval(0), NextGeneration(0), PeakNumNodes(0) {}
 
 ExplodedGraph::~ExplodedGraph() {}
 
@@ -198,6 +205,93 @@ void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
   ChangedNodes.clear();
 }
 
+// The size of the graph at which the first generation is reclaimed. Smaller
+// graphs are not worth walking.
+static const unsigned FirstGenerationSize = 4096;
+
+void ExplodedGraph::enableGenerationalReclamation() {
+  NextGeneration = FirstGenerationSize;
+}
+
+bool ExplodedGraph::shouldKeepWithoutEdges(
+    const ExplodedNode *node,
+    const llvm::SmallPtrSetImpl<const ExplodedNode *> &EndNodeSet) const {
+  if (node->pred_empty() || EndNodeSet.count(node))
+    return true;
+
+  // The coverage checkers look for the blocks entered in the top frame. The
+  // kept block entrance also lets a path which reaches it again merge into
+  // it rather than exploring the freed subgraph again.
+  return node->getLocation().getAs<BlockEntrance>() &&
+         node->getLocationContext()->inTopFrame();
+}
+
+void
+ExplodedGraph::reclaimGeneration(ArrayRef<const ExplodedNode *> LiveNodes) {
+  // Find the nodes from which a live node can be reached.
+  llvm::DenseSet<const ExplodedNode *> Reaching;
+  SmallVector<const ExplodedNode *, 32> WL(LiveNodes.begin(), LiveNodes.end());
+  while (!WL.empty()) {
+    const ExplodedNode *N = WL.pop_back_val();
+    if (!Reaching.insert(N).second)
+      continue;
+    WL.append(N->Preds.begin(), N->Preds.end());
+  }
+
+  if (Reaching.size() == NumNodes) {
+    NextGeneration = std::max(FirstGenerationSize, 2 * NumNodes);
+    return;
+  }
+
+  // Every other node is either freed, or kept without its edges.
+  llvm::SmallPtrSet<const ExplodedNode *, 32> EndNodeSet(EndNodes.begin(),
+                                                         EndNodes.end());
+  NodeVector Dead;
+  for (node_iterator I = nodes_begin(), E = nodes_end(); I != E; ++I) {
+    ExplodedNode *N = &*I;
+    if (Reaching.count(N))
+      continue;
+    if (shouldKeepWithoutEdges(N, EndNodeSet)) {
+      N->Preds = ExplodedNode::NodeGroup();
+      N->Succs = ExplodedNode::NodeGroup(N->isSink());
+      continue;
+    }
+    Dead.push_back(N);
+  }
+
+  // The predecessors of the reaching nodes are reaching as well, but some of
+  // their successors are not.
+  SmallVector<ExplodedNode *, 4> Succs;
+  for (const ExplodedNode *N : Reaching) {
+    ExplodedNode *RN = const_cast<ExplodedNode *>(N);
+    if (RN->succ_empty())
+      continue;
+
+    Succs.clear();
+    for (ExplodedNode *Succ : RN->Succs)
+      if (Reaching.count(Succ))
+        Succs.push_back(Succ);
+    if (Succs.size() == RN->succ_size())
+      continue;
+
+    RN->Succs = ExplodedNode::NodeGroup();
+    for (ExplodedNode *Succ : Succs)
+      RN->Succs.addNode(Succ, *this);
+  }
+
+  for (ExplodedNode *N : Dead) {
+    Nodes.RemoveNode(N);
+    N->~ExplodedNode();
+    FreeNodes.push_back(N);
+  }
+  NumNodes -= Dead.size();
+  NumNodesReclaimed += Dead.size();
+  NextGeneration = std::max(FirstGenerationSize, 2 * NumNodes);
+
+  // Some of the recently allocated nodes may have been freed.
+  ChangedNodes.clear();
+}
+
 //===----------------------------------------------------------------------===//
 // ExplodedNode.
 //===----------------------------------------------------------------------===//
@@ -327,6 +421,7 @@ ExplodedNode *ExplodedGraph::getNode(const ProgramPoint &L,
     // Insert the node into the node set and return it.
     Nodes.InsertNode(V, InsertPos);
     ++NumNodes;
+    PeakNumNodes = std::max(PeakNumNodes, NumNodes);
 
     if (IsNew) *IsNew = true;
   }
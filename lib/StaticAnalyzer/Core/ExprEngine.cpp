@@ -26,6 +26,7 @@
 #include "clang/StaticAnalyzer/Core/CheckerManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/AnalysisManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/CallEvent.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/ImmutableList.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
@@ -50,6 +51,15 @@ STATISTIC(NumMaxBlockCountReachedInInlined,
             "an inlined function");
 STATISTIC(NumTimesRetriedWithoutInlining,
             "The # of times we re-evaluated a call without inlining");
+STATISTIC(NumPathsMerged,
+            "The # of paths dropped at a join point because a state covering "
+            "theirs was already explored");
+STATISTIC(NumStatesWidened,
+            "The # of times local variables were widened to merge two paths "
+            "at a join point");
+STATISTIC(NumNodesSavedAtJoins,
+            "The # of nodes explored from the join points at which paths were "
+            "dropped, which those paths did not explore again");
 
 typedef std::pair<const CXXBindTemporaryExpr *, const StackFrameContext *>
     CXXBindTemporaryContext;
@@ -72,7 +82,7 @@ ExprEngine::ExprEngine(AnalysisManager &mgr, bool gcEnabled,
                        InliningModes HowToInlineIn)
   : AMgr(mgr),
     AnalysisDeclContexts(mgr.getAnalysisDeclContextManager()),
-    Engine(*this, FS),
+    Engine(*this, FS, mgr.getAnalyzerOptions()),
     G(Engine.getGraph()),
     StateMgr(getContext(), mgr.getStoreManagerCreator(),
              mgr.getConstraintManagerCreator(), G.getAllocator(),
@@ -83,13 +93,17 @@ ExprEngine::ExprEngine(AnalysisManager &mgr, bool gcEnabled,
     ObjCNoRet(mgr.getASTContext()),
     ObjCGCEnabled(gcEnabled), BR(mgr, *this),
     VisitedCallees(VisitedCalleesIn),
-    HowToInline(HowToInlineIn)
+    HowToInline(HowToInlineIn),
+    MergeStatesAtJoins(mgr.options.shouldMergeStatesAtJoins())
 {
   unsigned TrimInterval = mgr.options.getGraphTrimInterval();
   if (TrimInterval != 0) {
     // Enable eager node reclaimation when constructing the ExplodedGraph.
     G.enableNodeReclamation(TrimInterval);
   }
+
+  if (mgr.options.shouldReclaimGraphGenerations())
+    G.enableGenerationalReclamation();
 }
 
 ExprEngine::~ExprEngine() {
@@ -420,10 +434,272 @@ void ExprEngine::removeDead(ExplodedNode *Pred, ExplodedNodeSet &Out,
   }
 }
 
+namespace {
+/// Collects the nodes waiting in the worklist.
+class CollectWorkListNodes : public WorkList::Visitor {
+  SmallVectorImpl<const ExplodedNode *> &Nodes;
+
+public:
+  CollectWorkListNodes(SmallVectorImpl<const ExplodedNode *> &Nodes)
+    : Nodes(Nodes) {}
+
+  bool visit(const WorkListUnit &U) override {
+    Nodes.push_back(U.getNode());
+    return false;
+  }
+};
+} // end anonymous namespace
+
+void ExprEngine::reclaimGraphGeneration(ExplodedNode *Pred) {
+  SmallVector<const ExplodedNode *, 128> LiveNodes;
+  LiveNodes.push_back(Pred);
+
+  CollectWorkListNodes Collector(LiveNodes);
+  Engine.getWorkList()->visitItemsInWorkList(Collector);
+
+  // Paths are generated for the reports once the exploration is over.
+  for (BugReporter::EQClasses_iterator I = BR.EQClasses_begin(),
+                                       E = BR.EQClasses_end(); I != E; ++I)
+    for (BugReportEquivClass::iterator R = I->begin(), RE = I->end();
+         R != RE; ++R)
+      if (const ExplodedNode *N = R->getErrorNode())
+        LiveNodes.push_back(N);
+
+  // Clients such as the debug.Stats checker look at these nodes at the end.
+  for (CoreEngine::BlocksExhausted::const_iterator
+         I = Engine.blocks_exhausted_begin(),
+         E = Engine.blocks_exhausted_end(); I != E; ++I)
+    LiveNodes.push_back(I->second);
+  for (CoreEngine::BlocksAborted::const_iterator
+         I = Engine.blocks_aborted_begin(),
+         E = Engine.blocks_aborted_end(); I != E; ++I)
+    LiveNodes.push_back(I->second);
+
+  G.reclaimGeneration(LiveNodes);
+}
+
+namespace {
+/// Collects the direct bindings of a store.
+class CollectDirectBindings : public StoreManager::BindingsHandler {
+  llvm::DenseMap<const MemRegion *, SVal> &Bindings;
+
+public:
+  CollectDirectBindings(llvm::DenseMap<const MemRegion *, SVal> &Bindings)
+    : Bindings(Bindings) {}
+
+  bool HandleBinding(StoreManager &SMgr, Store St, const MemRegion *R,
+                     SVal V) override {
+    Bindings[R] = V;
+    return true;
+  }
+};
+} // end anonymous namespace
+
+/// Returns the local scalar variable of the current stack frame bound at
+/// \p R, if any. Only such variables are widened when joining states.
+static const VarRegion *getWidenableVarRegion(const MemRegion *R,
+                                              const StackFrameContext *SFC) {
+  const VarRegion *VR = dyn_cast<VarRegion>(R);
+  if (!VR || VR->getStackFrame() != SFC ||
+      !isa<StackLocalsSpaceRegion>(VR->getMemorySpace()))
+    return nullptr;
+
+  QualType T = VR->getValueType();
+  if (!(Loc::isLocType(T) || T->isIntegralOrEnumerationType()) ||
+      !SymbolManager::canSymbolicate(T))
+    return nullptr;
+
+  return VR;
+}
+
+ProgramStateRef ExprEngine::joinStates(ProgramStateRef Joined,
+                                       ProgramStateRef State,
+                                       const Stmt *S,
+                                       const LocationContext *LC) {
+  if (Joined == State)
+    return Joined;
+
+  // Constraints and checker data must agree exactly, as must the values of
+  // the expressions.
+  if (Joined->getGDM() != State->getGDM() ||
+      !StateMgr.haveEqualEnvironments(Joined, State))
+    return nullptr;
+
+  StoreManager &StoreMgr = getStoreManager();
+  llvm::DenseMap<const MemRegion *, SVal> JoinedBindings, StateBindings;
+  CollectDirectBindings JoinedCollector(JoinedBindings);
+  CollectDirectBindings StateCollector(StateBindings);
+  StoreMgr.iterBindings(Joined->getStore(), JoinedCollector);
+  StoreMgr.iterBindings(State->getStore(), StateCollector);
+  if (JoinedBindings.size() != StateBindings.size())
+    return nullptr;
+
+  const StackFrameContext *SFC = LC->getCurrentStackFrame();
+  SmallVector<const VarRegion *, 8> Widened;
+  for (llvm::DenseMap<const MemRegion *, SVal>::iterator
+         I = JoinedBindings.begin(), E = JoinedBindings.end(); I != E; ++I) {
+    llvm::DenseMap<const MemRegion *, SVal>::iterator
+      Other = StateBindings.find(I->first);
+    if (Other == StateBindings.end())
+      return nullptr;
+    if (Other->second == I->second)
+      continue;
+
+    const VarRegion *VR = getWidenableVarRegion(I->first, SFC);
+    if (!VR)
+      return nullptr;
+    Widened.push_back(VR);
+  }
+
+  if (Widened.empty())
+    return StateMgr.haveEqualStores(Joined, State) ? Joined : nullptr;
+
+  ProgramStateRef NewJoined = Joined;
+  for (SmallVectorImpl<const VarRegion *>::iterator I = Widened.begin(),
+                                                    E = Widened.end();
+       I != E; ++I) {
+    const VarRegion *VR = *I;
+    SVal V = JoinedBindings[VR];
+
+    // Once a variable has been widened at this join point, its symbol
+    // already stands for any value it may take here.
+    const SymbolConjured *Sym =
+      dyn_cast_or_null<SymbolConjured>(V.getAsSymbol());
+    if (!Sym || Sym->getTag() != VR) {
+      QualType T = VR->getValueType();
+      Sym = SymMgr.conjureSymbol(S, LC, T, currBldrCtx->blockCount(), VR);
+      if (Loc::isLocType(T))
+        V = loc::MemRegionVal(
+              svalBuilder.getRegionManager().getSymbolicRegion(Sym));
+      else
+        V = nonloc::SymbolVal(Sym);
+    }
+
+    // Checkers are not told about these bindings: the variables are not
+    // changed by the program, only forgotten by the analyzer.
+    NewJoined = NewJoined->bindLoc(loc::MemRegionVal(VR), V,
+                                   /*notifyChanges=*/false);
+    State = State->bindLoc(loc::MemRegionVal(VR), V,
+                           /*notifyChanges=*/false);
+  }
+
+  // The stores may still differ in their default bindings.
+  if (NewJoined != State)
+    return nullptr;
+
+  return NewJoined;
+}
+
+/// Returns the number of nodes which can be reached from \p N.
+static unsigned countReachableNodes(const ExplodedNode *N) {
+  llvm::DenseSet<const ExplodedNode *> Visited;
+  SmallVector<const ExplodedNode *, 32> WL;
+  WL.push_back(N);
+  while (!WL.empty()) {
+    const ExplodedNode *Cur = WL.pop_back_val();
+    if (!Visited.insert(Cur).second)
+      continue;
+    WL.append(Cur->succ_begin(), Cur->succ_end());
+  }
+  return Visited.size();
+}
+
+/// Returns true if \p B is entered again through the back edge of a loop.
+static bool isLoopHead(const CFGBlock *B) {
+  for (CFGBlock::const_pred_iterator I = B->pred_begin(), E = B->pred_end();
+       I != E; ++I)
+    if (const CFGBlock *Pred = *I)
+      if (Pred->getLoopTarget())
+        return true;
+  return false;
+}
+
+void ExprEngine::mergeStatesAtLoopHead(const Stmt *S, ExplodedNodeSet &Src,
+                                       ExplodedNodeSet &Dst) {
+  // Bound the number of states kept per loop head, which are compared
+  // against each incoming path.
+  const unsigned MaxJoinedStates = 8;
+  static SimpleProgramPointTag MergeTag(TagProviderName,
+                                        "Merge States At Join");
+
+  const CFGBlock *Block = currBldrCtx->getBlock();
+  unsigned BlockCount = currBldrCtx->blockCount();
+
+  // The paths entering the loop are those the later ones are widened to.
+  if (BlockCount == 1) {
+    for (ExplodedNodeSet::iterator I = Src.begin(), E = Src.end(); I != E;
+         ++I) {
+      const LocationContext *LC = (*I)->getLocationContext();
+      SmallVectorImpl<ProgramStateRef> &Reached =
+        JoinedStates[JoinPoint(Block, LC->getCurrentStackFrame())];
+      if (Reached.size() < MaxJoinedStates)
+        Reached.push_back((*I)->getState());
+    }
+    Dst.insert(Src);
+    return;
+  }
+
+  // Until then, the paths keep the values they could still use after the
+  // loop, and the bugs those values lead to.
+  if (BlockCount < AMgr.options.maxBlockVisitOnPath) {
+    Dst.insert(Src);
+    return;
+  }
+
+  StmtNodeBuilder Bldr(Src, Dst, *currBldrCtx);
+  for (ExplodedNodeSet::iterator I = Src.begin(), E = Src.end(); I != E; ++I) {
+    ExplodedNode *N = *I;
+    const LocationContext *LC = N->getLocationContext();
+    SmallVectorImpl<ProgramStateRef> &Reached =
+      JoinedStates[JoinPoint(Block, LC->getCurrentStackFrame())];
+
+    ProgramStateRef State = N->getState();
+    ProgramStateRef Joined;
+    for (SmallVectorImpl<ProgramStateRef>::iterator RI = Reached.begin(),
+                                                    RE = Reached.end();
+         RI != RE; ++RI) {
+      Joined = joinStates(*RI, State, S, LC);
+      if (!Joined)
+        continue;
+
+      if (Joined == *RI) {
+        ++NumPathsMerged;
+      } else {
+        ++NumStatesWidened;
+        *RI = Joined;
+      }
+      break;
+    }
+
+    if (!Joined) {
+      Joined = State;
+      if (Reached.size() < MaxJoinedStates)
+        Reached.push_back(State);
+    }
+
+    // If a node with the joined state already exists here, the path ends:
+    // the node builder does not put it back on the frontier.
+    if (Bldr.generateNode(S, N, Joined, &MergeTag,
+                          ProgramPoint::PreStmtPurgeDeadSymbolsKind) ||
+        !llvm::AreStatisticsEnabled())
+      continue;
+
+    // The path would have explored a subgraph like the one already
+    // explored from the existing node.
+    for (ExplodedNode::succ_iterator SI = N->succ_begin(), SE = N->succ_end();
+         SI != SE; ++SI)
+      if ((*SI)->getState() == Joined &&
+          (*SI)->getLocation().getTag() == &MergeTag)
+        NumNodesSavedAtJoins += countReachableNodes(*SI);
+  }
+}
+
 void ExprEngine::ProcessStmt(const CFGStmt S,
                              ExplodedNode *Pred) {
   // Reclaim any unnecessary nodes in the ExplodedGraph.
   G.reclaimRecentlyAllocatedNodes();
+  if (G.shouldReclaimGeneration())
+    reclaimGraphGeneration(Pred);
 
   const Stmt *currStmt = S.getStmt();
   PrettyStackTraceLoc CrashInfo(getContext().getSourceManager(),
@@ -437,6 +713,15 @@ void ExprEngine::ProcessStmt(const CFGStmt S,
   } else
     CleanedStates.Add(Pred);
 
+  // Widen the paths which enter a loop head for the last time the maximum
+  // block count allows, so that they can still leave the loop.
+  if (MergeStatesAtJoins && Pred->getLocation().getAs<BlockEntrance>() &&
+      isLoopHead(currBldrCtx->getBlock())) {
+    ExplodedNodeSet MergedStates;
+    mergeStatesAtLoopHead(currStmt, CleanedStates, MergedStates);
+    CleanedStates = MergedStates;
+  }
+
   // Visit the statement.
   ExplodedNodeSet Dst;
   for (ExplodedNodeSet::iterator I = CleanedStates.begin(),
@@ -37,6 +37,10 @@ STATISTIC(NumInlinedCalls,
 STATISTIC(NumReachedInlineCountMax,
   "The # of times we reached inline count maximum");
 
+STATISTIC(NumPreviouslyReachedMaxBlockCount,
+  "The # of functions not inlined because a previous analysis reached the "
+  "maximum block count when inlining them");
+
 void ExprEngine::processCallEnter(CallEnter CE, ExplodedNode *Pred) {
   // Get the entry block in the CFG of the callee.
   const StackFrameContext *calleeCtx = CE.getCalleeContext();
@@ -834,6 +838,14 @@ bool ExprEngine::shouldInlineCall(const CallEvent &Call, const Decl *D,
     // We haven't actually checked the static properties of this function yet.
     // Do that now, and record our decision in the function summaries.
     if (mayInlineDecl(CalleeADC, Opts)) {
+      // Don't spend the block budget again on a function that exhausted it
+      // in a previous analysis, unless its body has changed shape.
+      if (Engine.FunctionSummaries->previouslyReachedMaxBlockCount(
+              D, CalleeADC->getCFG()->getNumBlockIDs())) {
+        NumPreviouslyReachedMaxBlockCount++;
+        Engine.FunctionSummaries->markReachedMaxBlockCount(D);
+        return false;
+      }
       Engine.FunctionSummaries->markMayInline(D);
     } else {
       Engine.FunctionSummaries->markShouldNotInline(D);
@@ -865,10 +877,13 @@ bool ExprEngine::shouldInlineCall(const CallEvent &Call, const Decl *D,
        || IsRecursive))
     return false;
 
-  // Do not inline large functions too many times.
+  // Do not inline large functions too many times, unless a previous analysis
+  // found them cheap to inline.
   if ((Engine.FunctionSummaries->getNumTimesInlined(D) >
        Opts.getMaxTimesInlineLarge()) &&
-      CalleeCFG->getNumBlockIDs() > 13) {
+      CalleeCFG->getNumBlockIDs() > 13 &&
+      !Engine.FunctionSummaries->previouslyCheapToInline(
+          D, CalleeCFG->getNumBlockIDs())) {
     NumReachedInlineCountMax++;
     return false;
   }
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/FunctionSummary.h"
+#include <algorithm>
 using namespace clang;
 using namespace ento;
 
@@ -30,3 +31,77 @@ unsigned FunctionSummariesTy::getTotalNumVisitedBasicBlocks() {
   }
   return Total;
 }
+
+std::vector<FunctionSummariesTy::Change> FunctionSummariesTy::takeChanges() {
+  std::vector<Change> Changes;
+  if (!Recorded)
+    return Changes;
+
+  for (RecordedMapTy::iterator I = Recorded->begin(), E = Recorded->end();
+       I != E; ++I) {
+    const FunctionSummary &Original = I->second.Original;
+    MapTy::const_iterator NewI = Map.find(I->first);
+    const FunctionSummary &New = NewI != Map.end() ? NewI->second : Original;
+    Change C;
+    C.D = I->first;
+    C.TimesInlined = New.TimesInlined - Original.TimesInlined;
+    C.InlineChecked = New.InlineChecked;
+    C.MayInline = New.MayInline;
+    C.ReachedMaxBlockCount = New.ReachedMaxBlockCount;
+    C.TotalBasicBlocks = New.TotalBasicBlocks;
+    const llvm::SmallBitVector &Visited = I->second.VisitedBasicBlocks;
+    for (int B = Visited.find_first(); B != -1; B = Visited.find_next(B))
+      C.VisitedBasicBlocks.push_back(B);
+    C.ReadTimesInlined = Original.TimesInlined;
+    C.ReadInlineChecked = Original.InlineChecked;
+    C.ReadMayInline = Original.MayInline;
+    C.ReadReachedMaxBlockCount = Original.ReachedMaxBlockCount;
+    Changes.push_back(std::move(C));
+  }
+  Recorded.reset();
+  return Changes;
+}
+
+void FunctionSummariesTy::mergeChange(const Change &C) {
+  FunctionSummary &S = findOrInsertSummary(C.D)->second;
+  S.TimesInlined += C.TimesInlined;
+
+  // A function that must not be inlined stays that way.
+  if (C.InlineChecked && (!S.InlineChecked || !C.MayInline)) {
+    S.InlineChecked = 1;
+    S.MayInline = C.MayInline;
+  }
+  if (C.ReachedMaxBlockCount)
+    S.ReachedMaxBlockCount = 1;
+
+  if (C.TotalBasicBlocks > S.VisitedBasicBlocks.size()) {
+    S.VisitedBasicBlocks.resize(C.TotalBasicBlocks);
+    S.TotalBasicBlocks = C.TotalBasicBlocks;
+  }
+  for (unsigned B : C.VisitedBasicBlocks)
+    if (B < S.VisitedBasicBlocks.size())
+      S.VisitedBasicBlocks.set(B);
+}
+
+bool FunctionSummariesTy::isConsistentWith(const Change &C,
+                                           unsigned MaxTimesInlineLarge) {
+  FunctionSummary Empty;
+  MapTy::const_iterator I = Map.find(C.D);
+  const FunctionSummary &S = I != Map.end() ? I->second : Empty;
+
+  // Whether the function may be inlined at all. An analysis which had not
+  // checked the static rules yet comes to the same answer when it does.
+  if (S.ReachedMaxBlockCount != C.ReadReachedMaxBlockCount)
+    return false;
+  if (S.InlineChecked && C.ReadInlineChecked &&
+      S.MayInline != C.ReadMayInline)
+    return false;
+
+  // Large functions are not inlined once they were inlined more than
+  // MaxTimesInlineLarge times. The calls inlined by the other analysis would
+  // all have been inlined here as well if neither count passes the limit.
+  if (S.TimesInlined == C.ReadTimesInlined)
+    return true;
+  return std::max(S.TimesInlined, C.ReadTimesInlined) + C.TimesInlined <=
+         MaxTimesInlineLarge;
+}
@@ -17,11 +17,21 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/SubEngine.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/TaintManager.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ProgramState"
+
+STATISTIC(NumStatesCreated,
+          "The # of distinct program states created");
+STATISTIC(NumStatesShared,
+          "The # of times an already existing program state was reused");
+STATISTIC(NumStatesRecycled,
+          "The # of program states allocated from the free list");
+
 namespace clang { namespace  ento {
 /// Increments the number of times this state is referenced.
 
@@ -384,17 +394,21 @@ ProgramStateRef ProgramStateManager::getPersistentState(ProgramState &State) {
   State.Profile(ID);
   void *InsertPos;
 
-  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos))
+  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos)) {
+    ++NumStatesShared;
     return I;
+  }
 
   ProgramState *newState = nullptr;
   if (!freeStates.empty()) {
     newState = freeStates.back();
     freeStates.pop_back();    
+    ++NumStatesRecycled;
   }
   else {
     newState = (ProgramState*) Alloc.Allocate<ProgramState>();
   }
+  ++NumStatesCreated;
   new (newState) ProgramState(State);
   StateSet.InsertNode(newState, InsertPos);
   return newState;
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/StaticAnalyzer/Frontend/AnalysisConsumer.h"
+#include "FunctionSummaryCache.h"
 #include "ModelInjector.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/DataRecursiveASTVisitor.h"
@@ -40,14 +41,22 @@
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstring>
 #include <memory>
 #include <queue>
 
+#ifdef LLVM_ON_UNIX
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace clang;
 using namespace ento;
 using llvm::SmallPtrSet;
@@ -64,6 +73,18 @@ STATISTIC(NumBlocksInAnalyzedFunctions,
                       "The # of basic blocks in the analyzed functions.");
 STATISTIC(PercentReachableBlocks, "The % of reachable basic blocks.");
 STATISTIC(MaxCFGSize, "The maximum number of basic blocks in a function.");
+STATISTIC(MaxExplodedGraphMemory,
+                      "The maximum memory, in KB, used by the exploded graph "
+                      "of a function.");
+STATISTIC(MaxExplodedGraphNodes,
+                      "The maximum number of nodes the exploded graph of a "
+                      "function had at any time.");
+STATISTIC(NumWorkerResultsDiscarded,
+                      "The # of top level functions explored again because "
+                      "a worker read different function summaries.");
+STATISTIC(NumFunctionsExploredInWorkers,
+                      "The # of top level functions explored without reports "
+                      "by worker processes.");
 
 //===----------------------------------------------------------------------===//
 // Special PathDiagnosticConsumers.
@@ -140,6 +161,24 @@ public:
 
 namespace {
 
+/// \brief What a worker process learned from exploring a top level function.
+struct WorkerResult {
+  /// Whether a worker explored the function at all.
+  bool Explored;
+  /// The inlining mode the function was explored with.
+  ExprEngine::InliningModes IMode;
+  /// Whether exploring the function produced any bug reports.
+  bool FoundBugs;
+  /// The indices of the other top level functions that were inlined.
+  std::vector<unsigned> InlinedRoots;
+  /// What exploring the function taught the worker about the top level
+  /// functions, to be merged into the summaries of this process.
+  std::vector<FunctionSummariesTy::Change> Summaries;
+
+  WorkerResult()
+    : Explored(false), IMode(ExprEngine::Inline_Regular), FoundBugs(false) {}
+};
+
 class AnalysisConsumer : public AnalysisASTConsumer,
                          public DataRecursiveASTVisitor<AnalysisConsumer> {
   enum {
@@ -185,13 +224,21 @@ public:
   /// translation unit.
   FunctionSummariesTy FunctionSummaries;
 
+  /// Whether this is a worker process, which explores top level functions
+  /// for the compiler process but does not emit any reports.
+  bool InWorkerProcess;
+
+  /// Set by a worker process when exploring a function produced a report.
+  bool WorkerFoundBugs;
+
   AnalysisConsumer(const Preprocessor& pp,
                    const std::string& outdir,
                    AnalyzerOptionsRef opts,
                    ArrayRef<std::string> plugins,
                    CodeInjector *injector)
     : RecVisitorMode(0), RecVisitorBR(nullptr), Ctx(nullptr), PP(pp),
-      OutDir(outdir), Opts(opts), Plugins(plugins), Injector(injector) {
+      OutDir(outdir), Opts(opts), Plugins(plugins), Injector(injector),
+      InWorkerProcess(false), WorkerFoundBugs(false) {
     DigestAnalyzerOptions();
     if (Opts->PrintStats) {
       llvm::EnableStatistics();
@@ -314,6 +361,29 @@ public:
   /// use it to define the order in which the functions should be visited.
   void HandleDeclsCallGraph(const unsigned LocalTUDeclsSize);
 
+  /// \brief Explore the given top level functions in worker processes, as
+  /// requested by the 'worker-processes' option.
+  /// \param Results - The output parameter, which is populated with what the
+  /// workers learned about each function.
+  /// \returns False if no worker process was started.
+  bool RunWorkerProcesses(ArrayRef<Decl *> Roots,
+                          std::vector<WorkerResult> &Results);
+
+  /// \brief In a worker process, explore every \p NumWorkers'th function of
+  /// \p Roots, starting with the \p Worker'th one, and encode the results.
+  /// \param SummaryIndices - Maps the declarations the summaries of \p Roots
+  /// are kept under to their encoding, see \c getSummaryDecl.
+  /// \brief Returns true if the result of a worker for a top level function
+  /// can be used instead of exploring the function with \p IMode here.
+  bool isWorkerResultUsable(const WorkerResult &R,
+                            ExprEngine::InliningModes IMode);
+
+  void RunWorker(ArrayRef<Decl *> Roots,
+                 const llvm::DenseMap<const Decl *, unsigned> &RootIndices,
+                 const llvm::DenseMap<const Decl *, unsigned> &SummaryIndices,
+                 unsigned Worker, unsigned NumWorkers,
+                 SmallVectorImpl<uint32_t> &Out);
+
   /// \brief Run analyzes(syntax or path sensitive) on the given function.
   /// \param Mode - determines if we are requesting syntax only or path
   /// sensitive only analysis.
@@ -466,8 +536,7 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
   // inlined functions. The topological order allows the "do not reanalyze
   // previously inlined function" performance heuristic to be triggered more
   // often.
-  SetOfConstDecls Visited;
-  SetOfConstDecls VisitedAsTopLevel;
+  SmallVector<Decl *, 64> Roots;
   llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
   for (llvm::ReversePostOrderTraversal<clang::CallGraph*>::rpo_iterator
          I = RPOT.begin(), E = RPOT.end(); I != E; ++I) {
@@ -480,6 +549,33 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     if (!D)
       continue;
 
+    Roots.push_back(D);
+  }
+
+  // Start from what previous analyses learned about inlining these functions.
+  std::unique_ptr<FunctionSummaryCache> SummaryCache;
+  if (Opts->Config.count("summary-cache")) {
+    // A function is only cheap to inline after it was inlined as many times
+    // as large functions may be.
+    SummaryCache.reset(new FunctionSummaryCache(
+        Opts->Config["summary-cache"], Opts->getMaxTimesInlineLarge()));
+    SummaryCache->load();
+    SummaryCache->seed(Roots, FunctionSummaries);
+  }
+
+  // Worker processes explore the functions in parallel. The loop below still
+  // decides in order which functions to analyze. It analyzes again every
+  // function for which a worker found a bug, so that the reports are emitted
+  // by this process in the same order as without workers, and every function
+  // for which the worker read summaries different from those here.
+  std::vector<WorkerResult> Results;
+  bool HaveResults = RunWorkerProcesses(Roots, Results);
+
+  SetOfConstDecls Visited;
+  SetOfConstDecls VisitedAsTopLevel;
+  for (unsigned I = 0, E = Roots.size(); I != E; ++I) {
+    Decl *D = Roots[I];
+
     // Skip the functions which have been processed already or previously
     // inlined.
     if (shouldSkipFunction(D, Visited, VisitedAsTopLevel))
@@ -487,9 +583,21 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
 
     // Analyze the function.
     SetOfConstDecls VisitedCallees;
-
-    HandleCode(D, AM_Path, getInliningModeForFunction(D, Visited),
-               (Mgr->options.InliningMode == All ? nullptr : &VisitedCallees));
+    ExprEngine::InliningModes IMode = getInliningModeForFunction(D, Visited);
+
+    const WorkerResult *R = HaveResults ? &Results[I] : nullptr;
+    if (R && isWorkerResultUsable(*R, IMode)) {
+      for (unsigned Callee : R->InlinedRoots)
+        VisitedCallees.insert(Roots[Callee]);
+      for (const FunctionSummariesTy::Change &C : R->Summaries)
+        FunctionSummaries.mergeChange(C);
+      NumFunctionsExploredInWorkers++;
+    } else {
+      if (R && R->Explored)
+        NumWorkerResultsDiscarded++;
+      HandleCode(D, AM_Path, IMode, (Mgr->options.InliningMode == All
+                                         ? nullptr : &VisitedCallees));
+    }
 
     // Add the visited callees to the global visited set.
     for (SetOfConstDecls::iterator I = VisitedCallees.begin(),
@@ -498,6 +606,282 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     }
     VisitedAsTopLevel.insert(D);
   }
+
+  // The cache only saves work; failing to update it is not an error.
+  if (SummaryCache) {
+    SummaryCache->update(Roots, FunctionSummaries);
+    SummaryCache->save();
+  }
+}
+
+bool AnalysisConsumer::isWorkerResultUsable(const WorkerResult &R,
+                                            ExprEngine::InliningModes IMode) {
+  if (!R.Explored || R.IMode != IMode || R.FoundBugs)
+    return false;
+
+  // The worker only saw what was learned about the functions it explored
+  // itself. Its inlining decisions, and so the absence of reports, only hold
+  // if the summaries it read are those this process has now.
+  unsigned MaxTimesInlineLarge = Opts->getMaxTimesInlineLarge();
+  for (const FunctionSummariesTy::Change &C : R.Summaries)
+    if (!FunctionSummaries.isConsistentWith(C, MaxTimesInlineLarge))
+      return false;
+  return true;
+}
+
+/// \brief Returns the declaration the summary of the top level function
+/// \p Roots[Index / 2] is kept under: the function itself, which is explored
+/// at the top level, or for odd indices its definition, which is inlined.
+static const Decl *getSummaryDecl(ArrayRef<Decl *> Roots, unsigned Index) {
+  const Decl *D = Roots[Index / 2];
+  if (Index % 2 == 0)
+    return D;
+  if (const FunctionDecl *FD = dyn_cast<FunctionDecl>(D)) {
+    const FunctionDecl *Def;
+    if (FD->hasBody(Def))
+      return Def;
+  }
+  return D;
+}
+
+void AnalysisConsumer::RunWorker(
+    ArrayRef<Decl *> Roots,
+    const llvm::DenseMap<const Decl *, unsigned> &RootIndices,
+    const llvm::DenseMap<const Decl *, unsigned> &SummaryIndices,
+    unsigned Worker, unsigned NumWorkers, SmallVectorImpl<uint32_t> &Out) {
+  // Follow the same order and skipping heuristics as HandleDeclsCallGraph,
+  // restricted to the functions of this worker.
+  SetOfConstDecls Visited;
+  SetOfConstDecls VisitedAsTopLevel;
+  for (unsigned I = Worker, E = Roots.size(); I < E; I += NumWorkers) {
+    Decl *D = Roots[I];
+    if (shouldSkipFunction(D, Visited, VisitedAsTopLevel))
+      continue;
+
+    SetOfConstDecls VisitedCallees;
+    ExprEngine::InliningModes IMode = getInliningModeForFunction(D, Visited);
+    WorkerFoundBugs = false;
+    FunctionSummaries.startRecordingChanges();
+    HandleCode(D, AM_Path, IMode,
+               (Mgr->options.InliningMode == All ? nullptr : &VisitedCallees));
+
+    // Each result is encoded as the index of the function, the inlining mode,
+    // whether there were reports, the indices of the inlined functions, and
+    // the summaries of top level functions which were read or changed.
+    Out.push_back(I);
+    Out.push_back(IMode);
+    Out.push_back(WorkerFoundBugs);
+    unsigned NumInlinedPos = Out.size();
+    Out.push_back(0);
+    for (const Decl *Callee : VisitedCallees) {
+      Visited.insert(Callee);
+      llvm::DenseMap<const Decl *, unsigned>::const_iterator It =
+          RootIndices.find(Callee);
+      if (It != RootIndices.end()) {
+        Out.push_back(It->second);
+        ++Out[NumInlinedPos];
+      }
+    }
+
+    // Functions outside the call graph, like those with synthesized bodies,
+    // have no index; what was learned about them is not merged.
+    unsigned NumSummariesPos = Out.size();
+    Out.push_back(0);
+    for (const FunctionSummariesTy::Change &C :
+         FunctionSummaries.takeChanges()) {
+      llvm::DenseMap<const Decl *, unsigned>::const_iterator It =
+          SummaryIndices.find(C.D);
+      if (It == SummaryIndices.end())
+        continue;
+      Out.push_back(It->second);
+      Out.push_back(C.TimesInlined);
+      Out.push_back(C.ReadTimesInlined);
+      Out.push_back(C.InlineChecked | C.MayInline << 1 |
+                    C.ReachedMaxBlockCount << 2 | C.ReadInlineChecked << 3 |
+                    C.ReadMayInline << 4 | C.ReadReachedMaxBlockCount << 5);
+      Out.push_back(C.TotalBasicBlocks);
+      Out.push_back(C.VisitedBasicBlocks.size());
+      Out.append(C.VisitedBasicBlocks.begin(), C.VisitedBasicBlocks.end());
+      ++Out[NumSummariesPos];
+    }
+    VisitedAsTopLevel.insert(D);
+  }
+}
+
+#ifdef LLVM_ON_UNIX
+/// \brief Returns true if this process is known to run a single thread.
+///
+/// A child forked from a process with other threads could deadlock on a lock
+/// that one of them held, e.g. in malloc. Only Linux lets us count the
+/// threads, so workers are not used on other hosts.
+static bool isSingleThreaded() {
+#if defined(__linux__)
+  std::error_code EC;
+  unsigned NumThreads = 0;
+  for (llvm::sys::fs::directory_iterator Task("/proc/self/task", EC), End;
+       Task != End && !EC; Task.increment(EC))
+    ++NumThreads;
+  return !EC && NumThreads == 1;
+#else
+  return false;
+#endif
+}
+
+static bool decodeWorkerResults(ArrayRef<uint32_t> In, ArrayRef<Decl *> Roots,
+                                std::vector<WorkerResult> &Results) {
+  while (!In.empty()) {
+    if (In.size() < 5 || In[0] >= Results.size() || In.size() - 5 < In[3])
+      return false;
+    WorkerResult &R = Results[In[0]];
+    R.Explored = true;
+    R.IMode = static_cast<ExprEngine::InliningModes>(In[1]);
+    R.FoundBugs = In[2];
+    for (uint32_t Callee : In.slice(4, In[3])) {
+      if (Callee >= Results.size())
+        return false;
+      R.InlinedRoots.push_back(Callee);
+    }
+    In = In.slice(4 + In[3]);
+
+    unsigned NumSummaries = In[0];
+    In = In.slice(1);
+    for (unsigned S = 0; S != NumSummaries; ++S) {
+      if (In.size() < 6 || In[0] / 2 >= Roots.size() ||
+          In.size() - 6 < In[5])
+        return false;
+      FunctionSummariesTy::Change C;
+      C.D = getSummaryDecl(Roots, In[0]);
+      C.TimesInlined = In[1];
+      C.ReadTimesInlined = In[2];
+      C.InlineChecked = In[3] & 1;
+      C.MayInline = In[3] & 2;
+      C.ReachedMaxBlockCount = In[3] & 4;
+      C.ReadInlineChecked = In[3] & 8;
+      C.ReadMayInline = In[3] & 16;
+      C.ReadReachedMaxBlockCount = In[3] & 32;
+      C.TotalBasicBlocks = In[4];
+      C.VisitedBasicBlocks.assign(In.begin() + 6, In.begin() + 6 + In[5]);
+      R.Summaries.push_back(std::move(C));
+      In = In.slice(6 + In[5]);
+    }
+  }
+  return true;
+}
+#endif
+
+bool AnalysisConsumer::RunWorkerProcesses(ArrayRef<Decl *> Roots,
+                                          std::vector<WorkerResult> &Results) {
+  unsigned NumWorkers = Opts->getWorkerProcesses();
+#ifdef LLVM_ON_UNIX
+  if (NumWorkers > Roots.size())
+    NumWorkers = Roots.size();
+
+  // The output of the workers would not be ordered.
+  if (NumWorkers < 2 || Opts->AnalyzerDisplayProgress ||
+      Opts->visualizeExplodedGraphWithGraphViz ||
+      Opts->visualizeExplodedGraphWithUbiGraph)
+    return false;
+
+  // Hosts that parse on several threads, like libclang and ClangTool running
+  // in parallel, explore the functions themselves.
+  if (!isSingleThreaded())
+    return false;
+
+  llvm::DenseMap<const Decl *, unsigned> RootIndices;
+  llvm::DenseMap<const Decl *, unsigned> SummaryIndices;
+  for (unsigned I = 0, E = Roots.size(); I != E; ++I) {
+    RootIndices[Roots[I]] = I;
+    SummaryIndices.insert(std::make_pair(getSummaryDecl(Roots, 2 * I), 2 * I));
+    SummaryIndices.insert(
+        std::make_pair(getSummaryDecl(Roots, 2 * I + 1), 2 * I + 1));
+  }
+
+  // Don't let the workers inherit pending output.
+  llvm::outs().flush();
+  llvm::errs().flush();
+
+  SmallVector<std::pair<pid_t, int>, 8> Workers;
+  for (unsigned W = 0; W != NumWorkers; ++W) {
+    int FDs[2];
+    if (::pipe(FDs) != 0)
+      break;
+    pid_t Pid = ::fork();
+    if (Pid < 0) {
+      ::close(FDs[0]);
+      ::close(FDs[1]);
+      break;
+    }
+
+    if (Pid == 0) {
+      ::close(FDs[0]);
+      InWorkerProcess = true;
+      SmallVector<uint32_t, 256> Out;
+      RunWorker(Roots, RootIndices, SummaryIndices, W, NumWorkers, Out);
+
+      const char *Data = reinterpret_cast<const char *>(Out.data());
+      size_t Size = Out.size() * sizeof(uint32_t);
+      while (Size) {
+        ssize_t Written = ::write(FDs[1], Data, Size);
+        if (Written < 0) {
+          if (errno == EINTR)
+            continue;
+          ::_exit(1);
+        }
+        Data += Written;
+        Size -= Written;
+      }
+      // Skip the destructors, which would flush the reports collected by the
+      // path diagnostic consumers.
+      ::_exit(0);
+    }
+
+    ::close(FDs[1]);
+    Workers.push_back(std::make_pair(Pid, FDs[0]));
+  }
+
+  if (Workers.empty())
+    return false;
+
+  // The functions of a worker that could not be started, or that failed, are
+  // left to this process.
+  Results.assign(Roots.size(), WorkerResult());
+  for (const auto &W : Workers) {
+    std::string Buffer;
+    char Chunk[4096];
+    for (;;) {
+      ssize_t Read = ::read(W.second, Chunk, sizeof(Chunk));
+      if (Read < 0 && errno == EINTR)
+        continue;
+      if (Read <= 0)
+        break;
+      Buffer.append(Chunk, Read);
+    }
+    ::close(W.second);
+
+    int Status;
+    pid_t Waited;
+    do
+      Waited = ::waitpid(W.first, &Status, 0);
+    while (Waited < 0 && errno == EINTR);
+    if (Waited != W.first || !WIFEXITED(Status) || WEXITSTATUS(Status) != 0 ||
+        Buffer.size() % sizeof(uint32_t) != 0)
+      continue;
+
+    std::vector<uint32_t> In(Buffer.size() / sizeof(uint32_t));
+    if (!In.empty())
+      std::memcpy(In.data(), Buffer.data(), Buffer.size());
+    std::vector<WorkerResult> WorkerResults(Roots.size());
+    if (!decodeWorkerResults(In, Roots, WorkerResults))
+      continue;
+    for (unsigned I = 0, E = Roots.size(); I != E; ++I)
+      if (WorkerResults[I].Explored)
+        Results[I] = std::move(WorkerResults[I]);
+  }
+  return true;
+#else
+  (void)NumWorkers;
+  return false;
+#endif
 }
 
 void AnalysisConsumer::HandleTranslationUnit(ASTContext &C) {
@@ -659,6 +1043,19 @@ void AnalysisConsumer::ActionExprEngine(Decl *D, bool ObjCGCEnabled,
   Eng.ExecuteWorkList(Mgr->getAnalysisDeclContextManager().getStackFrame(D),
                       Mgr->options.getMaxNodesPerTopLevelFunction());
 
+  if (Opts->PrintStats) {
+    ExplodedGraph &G = Eng.getGraph();
+    unsigned MemoryKB = G.getAllocatedMemory() / 1024;
+    MaxExplodedGraphMemory = MaxExplodedGraphMemory < MemoryKB
+                                 ? MemoryKB : MaxExplodedGraphMemory;
+    unsigned PeakNodes = G.getPeakNumNodes();
+    MaxExplodedGraphNodes = MaxExplodedGraphNodes < PeakNodes
+                                ? PeakNodes : MaxExplodedGraphNodes;
+    llvm::errs() << "Exploded graph of '" << getFunctionName(D)
+                 << "': peak memory " << MemoryKB << " KB, peak nodes "
+                 << PeakNodes << ", nodes " << G.size() << "\n";
+  }
+
   // Release the auditor (if any) so that it doesn't monitor the graph
   // created BugReporter.
   ExplodedNode::SetAuditor(nullptr);
@@ -669,6 +1066,12 @@ void AnalysisConsumer::ActionExprEngine(Decl *D, bool ObjCGCEnabled,
 
   // Display warnings.
   Eng.getBugReporter().FlushReports();
+
+  // A worker only tells the compiler process whether there were any reports;
+  // the compiler process then analyzes the function again to emit them.
+  BugReporter &BR = Eng.getBugReporter();
+  if (InWorkerProcess && BR.EQClasses_begin() != BR.EQClasses_end())
+    WorkerFoundBugs = true;
 }
 
 void AnalysisConsumer::RunPathSensitiveChecks(Decl *D,
@@ -0,0 +1,223 @@
+//===-- FunctionSummaryCache.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "FunctionSummaryCache.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/Index/USRGeneration.h"
+#include "clang/Lex/Lexer.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/FunctionSummary.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LockFileManager.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+using namespace clang;
+using namespace ento;
+
+/// The first line of a cache file; bump the version when the format changes.
+static const char CacheSignature[] = "clang-analyzer-function-summaries 2";
+
+/// Returns the declaration the analyzer keeps the summary of \p D under.
+static const Decl *getDefinition(const Decl *D) {
+  if (const FunctionDecl *FD = dyn_cast<FunctionDecl>(D)) {
+    const FunctionDecl *Def;
+    if (FD->hasBody(Def))
+      return Def;
+  }
+  return D;
+}
+
+/// Computes a hash of the source text of the definition \p D, so that its
+/// summary is dropped when the function is edited, even if the number of its
+/// blocks stays the same. Returns false if the text is not available, e.g.
+/// because the function is defined by a macro.
+static bool getTextHash(const Decl *D, std::string &Hash) {
+  const ASTContext &Ctx = D->getASTContext();
+  StringRef Text = Lexer::getSourceText(
+      CharSourceRange::getTokenRange(D->getSourceRange()),
+      Ctx.getSourceManager(), Ctx.getLangOpts());
+  if (Text.empty())
+    return false;
+
+  llvm::MD5 MD5;
+  MD5.update(Text);
+  llvm::MD5::MD5Result Result;
+  MD5.final(Result);
+  SmallString<32> Str;
+  llvm::MD5::stringifyResult(Result, Str);
+  Hash = Str.str();
+  return true;
+}
+
+// The cache file is a line of signature followed by a line per function:
+//   <number of blocks> <text hash> <R if the block count was reached,
+//   C if cheap> <USR>
+void FunctionSummaryCache::read(StringRef Path, SummaryMap &Summaries) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+      llvm::MemoryBuffer::getFile(Path);
+  if (!Buffer)
+    return;
+
+  StringRef Line, Rest = (*Buffer)->getBuffer();
+  std::tie(Line, Rest) = Rest.split('\n');
+  if (Line != CacheSignature)
+    return;
+
+  while (!Rest.empty()) {
+    std::tie(Line, Rest) = Rest.split('\n');
+    StringRef Blocks, TextHash, Flag, USR;
+    std::tie(Blocks, Line) = Line.split(' ');
+    std::tie(TextHash, Line) = Line.split(' ');
+    std::tie(Flag, USR) = Line.split(' ');
+
+    Summary S;
+    if (Blocks.getAsInteger(10, S.NumBlocks) || TextHash.empty() ||
+        USR.empty() || (Flag != "R" && Flag != "C"))
+      continue;
+    S.TextHash = TextHash;
+    S.ReachedMaxBlockCount = Flag == "R";
+    S.CheapToInline = Flag == "C";
+    Summaries[USR] = S;
+  }
+}
+
+void FunctionSummaryCache::load() {
+  read(Path, Loaded);
+}
+
+void FunctionSummaryCache::seed(ArrayRef<Decl *> Functions,
+                                FunctionSummariesTy &Summaries) {
+  if (Loaded.empty())
+    return;
+
+  SmallString<128> USR;
+  std::string TextHash;
+  for (const Decl *D : Functions) {
+    USR.clear();
+    if (index::generateUSRForDecl(D, USR))
+      continue;
+    SummaryMap::const_iterator I = Loaded.find(USR);
+    if (I == Loaded.end())
+      continue;
+    const Summary &S = I->second;
+    D = getDefinition(D);
+    if (!getTextHash(D, TextHash) || TextHash != S.TextHash)
+      continue;
+    Summaries.setPreviousSummary(D, S.NumBlocks, S.ReachedMaxBlockCount,
+                                 S.CheapToInline);
+  }
+}
+
+void FunctionSummaryCache::update(ArrayRef<Decl *> Functions,
+                                  FunctionSummariesTy &Summaries) {
+  SmallString<128> USR;
+  for (const Decl *D : Functions) {
+    D = getDefinition(D);
+
+    // Only inlined functions teach us anything, and a function that was not
+    // inlined because its summary said so keeps that summary.
+    unsigned NumBlocks = Summaries.getNumBasicBlocks(D);
+    unsigned TimesInlined = Summaries.getNumTimesInlined(D);
+    if (!TimesInlined || !NumBlocks)
+      continue;
+
+    // A few cheap calls say little about the others, so a function is only
+    // cheap once it has been inlined often enough.
+    Summary S;
+    S.NumBlocks = NumBlocks;
+    S.ReachedMaxBlockCount = Summaries.hasReachedMaxBlockCount(D);
+    S.CheapToInline =
+        !S.ReachedMaxBlockCount && TimesInlined >= MinTimesInlined;
+    if (!S.ReachedMaxBlockCount && !S.CheapToInline)
+      continue;
+
+    USR.clear();
+    if (index::generateUSRForDecl(D, USR) || !getTextHash(D, S.TextHash))
+      continue;
+    Updated[USR] = S;
+  }
+}
+
+bool FunctionSummaryCache::save() {
+  if (Updated.empty())
+    return true;
+
+  // Other analyses may be updating the cache at the same time. Hold the lock
+  // from reading the cache until the merged one replaces it, so that their
+  // updates are not lost.
+  while (true) {
+    llvm::LockFileManager Locked(Path);
+    switch (Locked) {
+    case llvm::LockFileManager::LFS_Error:
+      return false;
+
+    case llvm::LockFileManager::LFS_Owned:
+      return write();
+
+    case llvm::LockFileManager::LFS_Shared:
+      switch (Locked.waitForUnlock()) {
+      case llvm::LockFileManager::Res_Success:
+      case llvm::LockFileManager::Res_OwnerDied:
+        continue; // try again to get the lock.
+      case llvm::LockFileManager::Res_Timeout:
+        // Clear the lock file so that future analyses can make progress.
+        Locked.unsafeRemoveLockFile();
+        return false;
+      }
+    }
+  }
+}
+
+bool FunctionSummaryCache::write() {
+  // Keep the summaries of other analyses, except for the functions analyzed
+  // here.
+  SummaryMap Merged;
+  read(Path, Merged);
+  for (const auto &I : Updated)
+    Merged[I.getKey()] = I.getValue();
+
+  std::vector<StringRef> USRs;
+  for (const auto &I : Merged)
+    USRs.push_back(I.getKey());
+  std::sort(USRs.begin(), USRs.end());
+
+  // Write to a temporary file and rename it, so that analyses loading the
+  // cache never see a partially written one.
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TempPath))
+    return false;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << CacheSignature << '\n';
+    for (StringRef USR : USRs) {
+      const Summary &S = Merged[USR];
+      OS << S.NumBlocks << ' ' << S.TextHash << ' '
+         << (S.ReachedMaxBlockCount ? 'R' : 'C') << ' ' << USR << '\n';
+    }
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return false;
+    }
+  }
+
+  if (llvm::sys::fs::rename(TempPath, Path)) {
+    llvm::sys::fs::remove(TempPath);
+    return false;
+  }
+  return true;
+}
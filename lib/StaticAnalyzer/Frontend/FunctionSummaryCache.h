@@ -0,0 +1,92 @@
+//===-- FunctionSummaryCache.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file defines the clang::ento::FunctionSummaryCache class, which
+/// keeps what the analyzer learned about inlining functions across
+/// translation units and runs.
+///
+/// The summaries are keyed by the USR of the function, so that a function
+/// defined in a header is recognized in every translation unit including it.
+/// Each summary records the number of CFG blocks of the function, a hash of
+/// its source text, and whether inlining it reached the maximum block count or
+/// was cheap. A summary is only used while the function still has the same
+/// number of blocks and the same text.
+///
+/// Analyses that share a cache file update it under a lock file, so that the
+/// summaries one analysis writes are never lost by another.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SA_FRONTEND_FUNCTIONSUMMARYCACHE_H
+#define LLVM_CLANG_SA_FRONTEND_FUNCTIONSUMMARYCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringMap.h"
+#include <string>
+
+namespace clang {
+
+class Decl;
+
+namespace ento {
+class FunctionSummariesTy;
+
+class FunctionSummaryCache {
+public:
+  /// \param MinTimesInlined The number of times a function must have been
+  /// inlined, without ever reaching the maximum block count, before it is
+  /// recorded as cheap to inline.
+  FunctionSummaryCache(StringRef Path, unsigned MinTimesInlined)
+      : Path(Path), MinTimesInlined(MinTimesInlined) {}
+
+  /// \brief Read the summaries recorded by previous analyses. A missing or
+  /// malformed cache file is treated as an empty one.
+  void load();
+
+  /// \brief Hand the recorded summaries of \p Functions to \p Summaries.
+  void seed(ArrayRef<Decl *> Functions, FunctionSummariesTy &Summaries);
+
+  /// \brief Record what \p Summaries learned about inlining \p Functions.
+  void update(ArrayRef<Decl *> Functions, FunctionSummariesTy &Summaries);
+
+  /// \brief Write the updated summaries back to the cache file, merged with
+  /// the summaries other analyses wrote since it was loaded.
+  /// \returns True on success.
+  bool save();
+
+private:
+  struct Summary {
+    unsigned NumBlocks;
+    std::string TextHash;
+    bool ReachedMaxBlockCount;
+    bool CheapToInline;
+  };
+  typedef llvm::StringMap<Summary> SummaryMap;
+
+  static void read(StringRef Path, SummaryMap &Summaries);
+
+  /// \brief Merge the updated summaries into the cache file, while holding
+  /// its lock.
+  bool write();
+
+  std::string Path;
+
+  unsigned MinTimesInlined;
+
+  /// The summaries recorded by previous analyses.
+  SummaryMap Loaded;
+
+  /// The summaries learned by this analysis.
+  SummaryMap Updated;
+};
+}
+}
+
+#endif
@@ -114,12 +114,17 @@ CommonOptionsParser::CommonOptionsParser(int &argc, const char **argv,
       cl::desc("Additional argument to prepend to the compiler command line"),
       cl::cat(Category));
 
+  static cl::opt<unsigned> Jobs(
+      "j", cl::desc("Number of translation units to process concurrently"),
+      cl::init(1), cl::cat(Category));
+
   cl::HideUnrelatedOptions(Category);
 
   Compilations.reset(FixedCompilationDatabase::loadFromCommandLine(argc,
                                                                    argv));
   cl::ParseCommandLineOptions(argc, argv, Overview);
   SourcePathList = SourcePaths;
+  NumThreads = Jobs;
   if (!Compilations) {
     std::string ErrorMessage;
     if (!BuildPath.empty()) {
@@ -30,6 +30,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/raw_ostream.h"
+#include <mutex>
+#include <thread>
 
 // For chdir, see the comment in ClangTool::run for more information.
 #ifdef LLVM_ON_WIN32
@@ -282,7 +284,8 @@ ClangTool::ClangTool(const CompilationDatabase &Compilations,
                      std::shared_ptr<PCHContainerOperations> PCHContainerOps)
     : Compilations(Compilations), SourcePaths(SourcePaths),
       PCHContainerOps(PCHContainerOps),
-      Files(new FileManager(FileSystemOptions())), DiagConsumer(nullptr) {
+      Files(new FileManager(FileSystemOptions())), DiagConsumer(nullptr),
+      NumThreads(1) {
   appendArgumentsAdjuster(getClangStripOutputAdjuster());
   appendArgumentsAdjuster(getClangSyntaxOnlyAdjuster());
 }
@@ -316,6 +319,10 @@ int ClangTool::run(ToolAction *Action) {
   std::string MainExecutable =
       llvm::sys::fs::getMainExecutable("clang_tool", &StaticSymbol);
 
+  if (NumThreads > 1)
+    return runConcurrently(collectFileCommands(MainExecutable),
+                           [Action](unsigned) { return Action; });
+
   llvm::SmallString<128> InitialDirectory;
   if (std::error_code EC = llvm::sys::fs::current_path(InitialDirectory))
     llvm::report_fatal_error("Cannot detect current path: " +
@@ -381,6 +388,141 @@ int ClangTool::run(ToolAction *Action) {
   return ProcessingFailed ? 1 : 0;
 }
 
+std::vector<ClangTool::FileCommand>
+ClangTool::collectFileCommands(StringRef MainExecutable) {
+  std::vector<FileCommand> Commands;
+  for (const auto &SourcePath : SourcePaths) {
+    std::string File(getAbsolutePath(SourcePath));
+    std::vector<CompileCommand> CompileCommandsForFile =
+        Compilations.getCompileCommands(File);
+    if (CompileCommandsForFile.empty()) {
+      llvm::errs() << "Skipping " << File << ". Compile command not found.\n";
+      continue;
+    }
+    for (CompileCommand &CompileCommand : CompileCommandsForFile) {
+      if (ArgsAdjuster)
+        CompileCommand.CommandLine = ArgsAdjuster(CompileCommand.CommandLine);
+      assert(!CompileCommand.CommandLine.empty());
+      CompileCommand.CommandLine[0] = MainExecutable;
+      // Workers share the process working directory, so resolve relative
+      // paths against the command's directory instead of chdir'ing into it.
+      CompileCommand.CommandLine.insert(
+          CompileCommand.CommandLine.begin() + 1,
+          "-working-directory=" + CompileCommand.Directory);
+      Commands.push_back(std::make_pair(File, std::move(CompileCommand)));
+    }
+  }
+  return Commands;
+}
+
+namespace {
+
+/// \brief Forwards diagnostics of one worker to a consumer shared by all
+/// workers, one call at a time.
+class LockingDiagnosticConsumer : public DiagnosticConsumer {
+public:
+  LockingDiagnosticConsumer(DiagnosticConsumer &Target, std::mutex &Mutex)
+      : Target(Target), Mutex(Mutex) {}
+
+  void BeginSourceFile(const LangOptions &LangOpts,
+                       const Preprocessor *PP) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Target.BeginSourceFile(LangOpts, PP);
+  }
+
+  void EndSourceFile() override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Target.EndSourceFile();
+  }
+
+  void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
+                        const Diagnostic &Info) override {
+    DiagnosticConsumer::HandleDiagnostic(DiagLevel, Info);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Target.HandleDiagnostic(DiagLevel, Info);
+  }
+
+private:
+  DiagnosticConsumer &Target;
+  std::mutex &Mutex;
+};
+
+} // end anonymous namespace
+
+int ClangTool::runConcurrently(
+    ArrayRef<FileCommand> Commands,
+    llvm::function_ref<ToolAction *(unsigned)> ActionForCommand) {
+  // Output of each command is buffered and flushed as soon as all commands
+  // before it have finished, so that it appears in input order.
+  std::vector<std::string> Outputs(Commands.size());
+  std::vector<bool> Finished(Commands.size(), false);
+  unsigned NextCommand = 0, NextToFlush = 0;
+  bool ProcessingFailed = false;
+  std::mutex StateMutex, ConsumerMutex;
+
+  auto Worker = [&] {
+    while (true) {
+      unsigned I;
+      {
+        std::lock_guard<std::mutex> Lock(StateMutex);
+        if (NextCommand == Commands.size())
+          return;
+        I = NextCommand++;
+      }
+      const std::string &File = Commands[I].first;
+      const CompileCommand &Command = Commands[I].second;
+
+      std::string Output;
+      llvm::raw_string_ostream OS(Output);
+      IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
+      TextDiagnosticPrinter DiagnosticPrinter(OS, &*DiagOpts);
+      LockingDiagnosticConsumer SharedConsumer(
+          DiagConsumer ? *DiagConsumer : DiagnosticPrinter, ConsumerMutex);
+
+      FileSystemOptions FileSystemOpts;
+      FileSystemOpts.WorkingDir = Command.Directory;
+      IntrusiveRefCntPtr<FileManager> CommandFiles(
+          new FileManager(FileSystemOpts));
+
+      DEBUG({ llvm::dbgs() << "Processing: " << File << ".\n"; });
+      ToolInvocation Invocation(Command.CommandLine, ActionForCommand(I),
+                                CommandFiles.get(), PCHContainerOps);
+      if (DiagConsumer)
+        Invocation.setDiagnosticConsumer(&SharedConsumer);
+      else
+        Invocation.setDiagnosticConsumer(&DiagnosticPrinter);
+      for (const auto &MappedFile : MappedFileContents)
+        Invocation.mapVirtualFile(MappedFile.first, MappedFile.second);
+      const bool Success = Invocation.run();
+      if (!Success)
+        OS << "Error while processing " << File << ".\n";
+      OS.flush();
+
+      std::lock_guard<std::mutex> Lock(StateMutex);
+      Outputs[I] = std::move(Output);
+      Finished[I] = true;
+      if (!Success)
+        ProcessingFailed = true;
+      for (; NextToFlush != Commands.size() && Finished[NextToFlush];
+           ++NextToFlush) {
+        llvm::errs() << Outputs[NextToFlush];
+        Outputs[NextToFlush].clear();
+      }
+    }
+  };
+
+  std::vector<std::thread> Threads;
+#if LLVM_ENABLE_THREADS
+  for (unsigned T = 1, E = std::min<size_t>(NumThreads, Commands.size());
+       T < E; ++T)
+    Threads.emplace_back(Worker);
+#endif
+  Worker();
+  for (std::thread &Thread : Threads)
+    Thread.join();
+  return ProcessingFailed ? 1 : 0;
+}
+
 namespace {
 
 class ASTBuilderAction : public ToolAction {
@@ -409,8 +551,27 @@ public:
 }
 
 int ClangTool::buildASTs(std::vector<std::unique_ptr<ASTUnit>> &ASTs) {
-  ASTBuilderAction Action(ASTs);
-  return run(&Action);
+  if (NumThreads <= 1) {
+    ASTBuilderAction Action(ASTs);
+    return run(&Action);
+  }
+
+  // Give every command its own action and result list, then append the
+  // results in input order.
+  static int StaticSymbol;
+  std::vector<FileCommand> Commands = collectFileCommands(
+      llvm::sys::fs::getMainExecutable("clang_tool", &StaticSymbol));
+  std::vector<std::vector<std::unique_ptr<ASTUnit>>> CommandASTs(
+      Commands.size());
+  std::vector<std::unique_ptr<ASTBuilderAction>> Actions;
+  for (auto &CommandResult : CommandASTs)
+    Actions.push_back(llvm::make_unique<ASTBuilderAction>(CommandResult));
+  int Result = runConcurrently(
+      Commands, [&Actions](unsigned I) { return Actions[I].get(); });
+  for (auto &CommandResult : CommandASTs)
+    for (auto &AST : CommandResult)
+      ASTs.push_back(std::move(AST));
+  return Result;
 }
 
 std::unique_ptr<ASTUnit>
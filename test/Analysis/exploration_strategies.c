@@ -0,0 +1,67 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config exploration_strategy=dfs -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config exploration_strategy=bfs -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config exploration_strategy=bfs_block_dfs_contents -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config exploration_strategy=unexplored_first -verify %s
+
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config max-nodes=2000 -analyzer-config exploration_strategy=dfs -analyze-function=missedByDFS -analyzer-display-progress %s 2>&1 | FileCheck -check-prefix=DFS %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config max-nodes=2000 -analyzer-config exploration_strategy=unexplored_first -analyze-function=missedByDFS -analyzer-display-progress %s 2>&1 | FileCheck -check-prefix=UNEXPLORED %s
+
+// Every strategy finds the bugs of a function which can be explored
+// completely within the node budget.
+
+int getUnknown(void);
+
+int divideInLoop(int n) {
+  int sum = 0;
+  for (int i = 0; i < n; ++i) {
+    if (getUnknown())
+      sum += 1;
+  }
+  int zero = 0;
+  if (getUnknown())
+    return sum / zero; // expected-warning{{Division by zero}}
+  return sum;
+}
+
+void derefInCallee(int *p) {
+  *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+}
+
+void callsDeref(int flag) {
+  int x;
+  if (flag)
+    derefInCallee(&x);
+  else
+    derefInCallee(0);
+}
+
+// DFS explores the false branch of the first condition first, and the paths
+// following it do not fit in a small node budget, so the bug in the true
+// branch is only found when every path can be explored. With
+// unexplored_first, the nodes entering the blocks joining those paths wait
+// behind the true branch, which is reached early.
+int missedByDFS(void) {
+  int *p = 0;
+  if (getUnknown()) {
+    *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+    return 0;
+  }
+  // Every path leaves a different value in 'x', so none of them are merged.
+  int x = 0;
+  if (getUnknown()) x += 1;
+  if (getUnknown()) x += 2;
+  if (getUnknown()) x += 4;
+  if (getUnknown()) x += 8;
+  if (getUnknown()) x += 16;
+  if (getUnknown()) x += 32;
+  if (getUnknown()) x += 64;
+  if (getUnknown()) x += 128;
+  if (getUnknown()) x += 256;
+  if (getUnknown()) x += 512;
+  return x;
+}
+
+// DFS: ANALYZE {{.*}} missedByDFS
+// DFS-NOT: warning: Dereference of null pointer
+
+// UNEXPLORED: warning: Dereference of null pointer
@@ -0,0 +1,50 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config graph-generational-reclaim=true -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config graph-generational-reclaim=true -analyzer-stats %s 2>&1 | FileCheck %s
+// REQUIRES: asserts
+
+// Freeing the finished subgraphs must not lose the reports found before, or
+// those found afterwards.
+
+int getUnknown(void);
+
+int manyPaths(void) {
+  int x = 0;
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  int *p = 0;
+  if (x == 4)
+    *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  if (getUnknown()) x++;
+  if (x == 7)
+    return 1 / (x - 7); // expected-warning{{Division by zero}}
+  return x;
+}
+
+// Every path leaves a different value in 'x', so none of them are merged and
+// the graph grows well past the size at which the first generation is
+// reclaimed.
+int distinctPaths(void) {
+  int x = 0;
+  if (getUnknown()) x += 1;
+  if (getUnknown()) x += 2;
+  if (getUnknown()) x += 4;
+  if (getUnknown()) x += 8;
+  if (getUnknown()) x += 16;
+  if (getUnknown()) x += 32;
+  if (getUnknown()) x += 64;
+  if (getUnknown()) x += 128;
+  int *p = 0;
+  if (x == 255)
+    *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+  return x;
+}
+
+// CHECK-DAG: Exploded graph of 'manyPaths': peak memory {{[0-9]+}} KB, peak nodes {{[0-9]+}}, nodes {{[0-9]+}}
+// CHECK-DAG: Exploded graph of 'distinctPaths': peak memory {{[0-9]+}} KB, peak nodes {{[0-9]+}}, nodes {{[0-9]+}}
+// CHECK: {{[0-9]+}} AnalysisConsumer{{ +}}- The maximum number of nodes the exploded graph of a function had at any time.
+// CHECK: {{[1-9][0-9]*}} ExplodedGraph{{ +}}- The # of exploded nodes freed by generational reclamation.
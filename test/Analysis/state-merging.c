@@ -0,0 +1,77 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config state-merging=true -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config state-merging=true -analyzer-stats %s 2>&1 | FileCheck %s
+// REQUIRES: asserts
+
+// Paths entering a loop head for the last time the maximum block count
+// allows are merged with the paths which entered the loop, when their states
+// only differ in the values of local scalar variables. Those are widened to a
+// fresh symbol. Paths reaching other join points keep their values.
+
+int g;
+int u(void);
+
+void widenLoopCounter(void) {
+  int *p = 0;
+  // Without merging, the path is dropped once the maximum block count is
+  // reached and the code after the loop is never analyzed.
+  for (int i = 0; i < 1000; ++i)
+    ;
+  *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+}
+
+int countIterations(void) {
+  int x = 0;
+  // Once 'x' has been widened on the first path entering the loop head for
+  // the last time, the other such paths have the same state, and end there.
+  while (u()) {
+    if (u())
+      x++;
+    else
+      x += 2;
+  }
+  return x;
+}
+
+int keepValueInLoop(void) {
+  int x = 1;
+  // 'x' is not widened before the last iteration, so the path leaving the
+  // loop after setting it to 0 is explored.
+  while (u())
+    x = 0;
+  return 1 / x; // expected-warning{{Division by zero}}
+}
+
+void keepLocal(int c) {
+  int x;
+  if (c)
+    x = 1;
+  else
+    x = 2;
+  // 'x' is not widened after an if statement.
+  int *p = 0;
+  if (x == 3)
+    *p = 1; // no-warning
+}
+
+int keepDivisor(void) {
+  int d;
+  if (u())
+    d = 0;
+  else
+    d = 1;
+  // Forgetting the value of 'd' would hide the division by zero.
+  return 10 / d; // expected-warning{{Division by zero}}
+}
+
+void keepGlobal(int c) {
+  // Global variables are never widened, so these paths are not merged.
+  if (c)
+    g = 1;
+  else
+    g = 2;
+  int *p = 0;
+  if (g == 3)
+    *p = 1; // no-warning
+}
+
+// CHECK: {{[1-9][0-9]*}} ExprEngine{{ +}}- The # of nodes explored from the join points at which paths were dropped, which those paths did not explore again
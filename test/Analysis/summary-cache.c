@@ -0,0 +1,76 @@
+// REQUIRES: asserts
+// RUN: rm -f %t.summaries
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config summary-cache=%t.summaries -analyzer-config max-times-inline-large=2 -analyzer-stats %s 2>&1 | FileCheck -check-prefix=FIRST %s
+// RUN: FileCheck --input-file=%t.summaries %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config summary-cache=%t.summaries -analyzer-config max-times-inline-large=2 -analyzer-stats %s 2>&1 | FileCheck -check-prefix=SECOND %s
+// RUN: FileCheck --input-file=%t.summaries %s
+//
+// Editing large() without changing its number of blocks drops its summary.
+// RUN: sed -e 's/return g;/return -g;/' %s > %t.c
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config summary-cache=%t.summaries -analyzer-config max-times-inline-large=2 -analyzer-stats %t.c 2>&1 | FileCheck -check-prefix=EDITED %s
+
+// The summaries of inlined functions are kept across analyses. A function
+// that was not inlined because of its summary keeps the summary.
+
+int getUnknown(void);
+
+int loop(void) {
+  int i = 0;
+  while (getUnknown())
+    i++;
+  return i;
+}
+
+int callsLoop(void) {
+  return loop();
+}
+
+// Inlined once, which is not enough to tell whether it is cheap.
+int small(int x) {
+  return x + 1;
+}
+
+int callsSmall(void) {
+  return small(1);
+}
+
+int g;
+
+// Has more blocks than the limit on inlining large functions applies to, but
+// never reaches the maximum block count.
+int large(int x) {
+  if (x == 1)
+    g = 1;
+  if (x == 2)
+    g = 2;
+  if (x == 3)
+    g = 3;
+  if (x == 4)
+    g = 4;
+  if (x == 5)
+    g = 5;
+  if (x == 6)
+    g = 6;
+  if (x == 7)
+    g = 7;
+  return g;
+}
+
+int callsLarge(int x) {
+  return large(x) + large(x) + large(x) + large(x);
+}
+
+// The first analysis stops inlining large() after two calls, and explores
+// loop() before giving up on inlining it. The second one inlines every call
+// of large() and does not try to inline loop().
+// FIRST-NOT: The # of functions not inlined because a previous analysis
+// FIRST: ExprEngine - The # of times we reached inline count maximum
+// SECOND-NOT: The # of times we reached inline count maximum
+// SECOND: 1 ExprEngine - The # of functions not inlined because a previous analysis reached the maximum block count when inlining them
+// SECOND-NOT: The # of times we reached inline count maximum
+// EDITED: ExprEngine - The # of times we reached inline count maximum
+
+// CHECK: clang-analyzer-function-summaries 2
+// CHECK-NEXT: {{[0-9]+}} {{[0-9a-f]+}} C c:@F@large
+// CHECK-NEXT: {{[0-9]+}} {{[0-9a-f]+}} R c:@F@loop
+// CHECK-NOT: c:@F@
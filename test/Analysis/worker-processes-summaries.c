@@ -0,0 +1,57 @@
+// REQUIRES: asserts, shell
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-stats %s 2>&1 | grep "basic blocks" > %t.serial
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config worker-processes=2 -analyzer-stats %s 2>&1 | grep "basic blocks" > %t.workers
+// RUN: diff %t.serial %t.workers
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config worker-processes=64 -analyzer-stats %s 2>&1 | FileCheck %s
+
+// What the workers learn about the functions they explore is merged back,
+// so the block coverage matches that of a serial analysis.
+
+int g;
+
+static int clamp(int x) {
+  if (x < 0)
+    return 0;
+  if (x > 100)
+    return 100;
+  return x;
+}
+
+int first(int x) {
+  return clamp(x) + 1;
+}
+
+int second(int x) {
+  if (x == 42)
+    return 0;
+  return clamp(x * 2);
+}
+
+void third(int x) {
+  while (x-- > 0)
+    g += x;
+}
+
+int fourth(void) {
+  return first(-1) + second(200);
+}
+
+// With a worker per function, the worker exploring the second caller of
+// 'spin' does not know that inlining 'spin' into the first one reached the
+// maximum block count, so its result is discarded.
+int spin(int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i)
+    s += i;
+  return s;
+}
+
+int spinFirst(int n) {
+  return spin(n);
+}
+
+int spinSecond(int n) {
+  return spin(n) + 1;
+}
+
+// CHECK: {{[1-9][0-9]*}} AnalysisConsumer{{ +}}- The # of top level functions explored again because a worker read different function summaries.
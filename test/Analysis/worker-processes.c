@@ -0,0 +1,57 @@
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config worker-processes=2 -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config worker-processes=4 -verify %s
+// RUN: %clang_cc1 -analyze -analyzer-checker=core -analyzer-config worker-processes=64 -verify %s
+// REQUIRES: shell
+
+// The reports must not depend on how many worker processes explore the
+// top level functions.
+
+int *getNull() {
+  return 0;
+}
+
+void derefInlined() {
+  int *p = getNull();
+  *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+}
+
+int divide(int x, int y) {
+  return x / y; // expected-warning{{Division by zero}}
+}
+
+int divideByZero() {
+  return divide(1, 0);
+}
+
+int noBug(int x) {
+  return x + 1;
+}
+
+int callsNoBug() {
+  return noBug(1);
+}
+
+void derefParam(int *p) {
+  if (p)
+    return;
+  *p = 2; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+}
+
+// 'spin' reaches the maximum block count when it is inlined into the first of
+// these callers, after which it is not inlined any more. A worker exploring
+// the other caller alone would still inline it.
+int spin(int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i)
+    s += i;
+  return s;
+}
+
+int spinFirst(int n) {
+  return spin(n);
+}
+
+int spinSecond(int n) {
+  return spin(n) + 1;
+}
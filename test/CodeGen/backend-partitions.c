@@ -0,0 +1,39 @@
+// REQUIRES: x86-registered-target
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -S -backend-partitions 2 \
+// RUN:   %s -o %t/out.s
+// RUN: cat %t/out.s %t/out.part1.s | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -S -backend-partitions 2 \
+// RUN:   -DVARIANT=3 %s -o %t/variant.s
+// RUN: echo "----" > %t/separator
+// RUN: cat %t/out.s %t/out.part1.s %t/separator %t/variant.s \
+// RUN:   %t/variant.part1.s | FileCheck %s -check-prefix=DISTINCT
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -S \
+// RUN:   -backend-partitions 2 %s -o - 2>&1 | FileCheck %s -check-prefix=STDOUT
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -S \
+// RUN:   -backend-partitions 0 %s -o %t/out.s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=INVALID
+
+// Both partitions are written, and the local function is renamed and hidden
+// so that the partitions can share it.
+// CHECK-DAG: {{^}}first:
+// CHECK-DAG: {{^}}second:
+// CHECK-DAG: .hidden helper.part.{{[0-9a-f]+}}
+// CHECK-DAG: {{^}}helper.part.{{[0-9a-f]+}}:
+
+// The same source compiled with different options gets different names.
+// DISTINCT: helper.part.[[HASH:[0-9a-f]+]]
+// DISTINCT: ----
+// DISTINCT-NOT: helper.part.[[HASH]]
+
+// STDOUT: error: -backend-partitions requires an output file
+// INVALID: error: invalid integral value '0' in '-backend-partitions 0'
+
+#ifndef VARIANT
+#define VARIANT 2
+#endif
+
+static int helper(int x) { return x + 1; }
+int first(int x) { return helper(x); }
+int second(int x) { return helper(x) * VARIANT; }
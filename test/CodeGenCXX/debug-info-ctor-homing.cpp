@@ -0,0 +1,50 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -std=c++11 -emit-llvm -g \
+// RUN:   -fdebug-info-ctor-homing %s -o - \
+// RUN:   | FileCheck %s -check-prefix=CHECK -check-prefix=ELSEWHERE
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -std=c++11 -emit-llvm -g \
+// RUN:   -fdebug-info-ctor-homing -DDEFINE_CTOR %s -o - \
+// RUN:   | FileCheck %s -check-prefix=CHECK -check-prefix=HOME
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -std=c++11 -emit-llvm -g \
+// RUN:   %s -o - | FileCheck %s -check-prefix=CHECK -check-prefix=HOME
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -std=c++11 -emit-llvm \
+// RUN:   -g -fstandalone-debug -fdebug-info-ctor-homing %s -o - \
+// RUN:   | FileCheck %s -check-prefix=CHECK -check-prefix=HOME
+
+// A class whose objects are all created by a call to one of its constructors
+// is described in full where a constructor is emitted. Elsewhere, only a
+// declaration is emitted.
+// ELSEWHERE-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Homed"{{.*}}flags: DIFlagFwdDecl
+// HOME-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Homed"{{.*}}elements:
+
+// Aggregates and classes with constexpr or trivial default constructors can
+// be created without emitting a constructor, so they are always described.
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Aggregate"{{.*}}elements:
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Literal"{{.*}}elements:
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "TrivialDefault"{{.*}}elements:
+
+struct Homed {
+  Homed();
+  int i;
+};
+#ifdef DEFINE_CTOR
+Homed::Homed() : i(0) {}
+#endif
+void useHomed(Homed &H) { H.i = 1; }
+
+struct Aggregate {
+  int i;
+};
+void useAggregate(Aggregate &A) { A.i = 1; }
+
+struct Literal {
+  constexpr Literal() : i(0) {}
+  int i;
+};
+void useLiteral(Literal &L) { L.i = 1; }
+
+struct TrivialDefault {
+  TrivialDefault() = default;
+  TrivialDefault(int i) : i(i) {}
+  int i;
+};
+void useTrivialDefault(TrivialDefault &T) { T.i = 1; }
@@ -0,0 +1,18 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -o - %s | FileCheck %s
+
+// Every specialization initializes an array of its own size from the
+// literal of the pattern.
+template <int N> void fill() { char buf[N] = ("ab"); }
+
+template void fill<3>();
+template void fill<8>();
+
+// CHECK-DAG: private unnamed_addr constant [3 x i8] c"ab\00"
+// CHECK-DAG: private unnamed_addr constant [8 x i8] c"ab\00\00\00\00\00\00"
+
+// CHECK-LABEL: define weak_odr void @_Z4fillILi3EEvv()
+// CHECK: alloca [3 x i8]
+// CHECK: call void @llvm.memcpy{{.*}}, i64 3,
+// CHECK-LABEL: define weak_odr void @_Z4fillILi8EEvv()
+// CHECK: alloca [8 x i8]
+// CHECK: call void @llvm.memcpy{{.*}}, i64 8,
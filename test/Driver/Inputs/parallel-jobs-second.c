@@ -0,0 +1,4 @@
+#ifndef PREPROCESS_ONLY
+#error second parallel job
+#endif
+second_job_token
@@ -0,0 +1,26 @@
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=3 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-LINUX
+// CHECK-LINUX: "-cc1"
+// CHECK-LINUX-SAME: "-backend-partitions" "3" "-o" "[[TMP:[^"]*parallel-codegen-[^"]*]].o"
+// CHECK-LINUX: "{{.*}}ld{{(.exe)?}}" "-r" "-m" "elf_x86_64" "-o" "[[OUT:[^"]*]].o" "[[TMP]].o" "[[TMP]].part1.o" "[[TMP]].part2.o"
+// CHECK-LINUX: "{{.*}}objcopy{{(.exe)?}}" "--wildcard" "--localize-symbol=*.part.*" "[[OUT]].o"
+
+// Code is generated in one piece with N = 1, when the output is not an object
+// file, and on targets other than Linux with a known linker emulation.
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=1 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-SERIAL
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=4 -S %s \
+// RUN:   -o %t.s -### 2>&1 | FileCheck %s -check-prefix=CHECK-SERIAL
+// RUN: %clang -target x86_64-pc-windows-msvc -fparallel-codegen=4 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-SERIAL
+// RUN: %clang -target x86_64-apple-darwin10 -fparallel-codegen=2 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-SERIAL
+// RUN: %clang -target bpf-unknown-linux -fparallel-codegen=2 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-SERIAL
+// CHECK-SERIAL-NOT: argument unused
+// CHECK-SERIAL-NOT: "-backend-partitions"
+// CHECK-SERIAL-NOT: "-r"
+
+// RUN: not %clang -target x86_64-unknown-linux -fparallel-codegen=0 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck %s -check-prefix=CHECK-ZERO
+// CHECK-ZERO: error: invalid integral value '0' in '-fparallel-codegen=0'
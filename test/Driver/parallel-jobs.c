@@ -0,0 +1,43 @@
+// RUN: %clang -fparallel-jobs=4 -c %s -### 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-FLAG
+// CHECK-FLAG-NOT: argument unused
+// CHECK-FLAG-NOT: "-fparallel-jobs=4"
+
+// RUN: not %clang -fparallel-jobs=0 -c %s -### 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-ZERO
+// CHECK-ZERO: error: invalid integral value '0' in '-fparallel-jobs=0'
+
+// RUN: not %clang -fparallel-jobs=foo -c %s -### 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-INVALID
+// CHECK-INVALID: error: invalid integral value 'foo' in '-fparallel-jobs=foo'
+
+// Independent jobs all run, and a failing job does not stop the others.
+// Diagnostics are reported in input order, whichever job finishes first.
+// RUN: not %clang -fparallel-jobs=2 -fsyntax-only %s \
+// RUN:   %S/Inputs/parallel-jobs-second.c 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-RUN
+// CHECK-RUN: error: first parallel job
+// CHECK-RUN-NOT: error:
+// CHECK-RUN: error: second parallel job
+// CHECK-RUN-NOT: error:
+
+// RUN: not %clang -fparallel-jobs=2 -fsyntax-only \
+// RUN:   %S/Inputs/parallel-jobs-second.c %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-REVERSED
+// CHECK-REVERSED: error: second parallel job
+// CHECK-REVERSED-NOT: error:
+// CHECK-REVERSED: error: first parallel job
+
+// Jobs writing to the standard output run one after the other, so their
+// output is not interleaved.
+// RUN: %clang -fparallel-jobs=2 -E -DPREPROCESS_ONLY %s \
+// RUN:   %S/Inputs/parallel-jobs-second.c \
+// RUN:   | FileCheck %s -check-prefix=CHECK-STDOUT
+// CHECK-STDOUT: first_job_token
+// CHECK-STDOUT-NOT: _job_token
+// CHECK-STDOUT: second_job_token
+
+#ifndef PREPROCESS_ONLY
+#error first parallel job
+#endif
+first_job_token
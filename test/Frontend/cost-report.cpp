@@ -0,0 +1,33 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: echo 'template <typename T> struct CostBox { T Value; };' \
+// RUN:   > %t/cost-report-header.h
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -I %t -fcost-report=%t/costs.json %s
+// RUN: FileCheck %s < %t/costs.json
+
+// CHECK: "file": "{{.*}}cost-report.cpp",
+// CHECK-NOT: "truncated"
+// CHECK: "headers": [
+// CHECK-DAG: { "name": "{{.*}}cost-report.cpp", "self": {{[0-9.]+}}, "total": {{[0-9.]+}}, "count": 1 }
+// CHECK-DAG: { "name": "{{.*}}cost-report-header.h", "self": {{[0-9.]+}}, "total": {{[0-9.]+}}, "count": 1 }
+// CHECK: "templates": [
+// CHECK-NEXT: { "name": "CostBox<int>", "self": {{[0-9.]+}}, "total": {{[0-9.]+}}, "count": 1 }
+// CHECK-NEXT: ]
+// CHECK: "constexpr": [
+// CHECK-NEXT: { "name": "cost_fib", "self": {{[0-9.]+}}, "total": {{[0-9.]+}}, "count": {{[1-9][0-9]+}} }
+// CHECK-NEXT: ]
+
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -I %t -fcost-report=%t/limited.json \
+// RUN:   -cost-report-limit 1 %s
+// RUN: FileCheck %s -check-prefix=LIMIT < %t/limited.json
+// LIMIT: "truncated": true,
+// LIMIT-NEXT: "headers": [
+// LIMIT-NEXT: { "name":
+// LIMIT-NEXT: ],
+
+#include "cost-report-header.h"
+
+CostBox<int> Box;
+
+constexpr int cost_fib(int N) { return N < 2 ? N : cost_fib(N - 1) + cost_fib(N - 2); }
+static_assert(cost_fib(10) == 55, "");
@@ -0,0 +1,31 @@
+// REQUIRES: shell
+
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/a %t/b %t/c
+// RUN: echo 'int stat_cache_decl;' > %t/c/stat-cache-header.h
+// RUN: touch -m -a -t 201101010000 %t/a %t/b %t/c
+
+// The first compilation creates the cache.
+// RUN: %clang_cc1 -fsyntax-only -I %t/a -I %t/b -I %t/c \
+// RUN:   -stat-cache %t/stat.cache -record-stat-cache %s
+// RUN: ls %t/stat.cache
+
+// Later compilations skip the failed lookups in %t/a and %t/b.
+// RUN: %clang_cc1 -fsyntax-only -I %t/a -I %t/b -I %t/c \
+// RUN:   -stat-cache %t/stat.cache -print-stats %s 2>&1 | FileCheck %s
+// CHECK: *** Persistent Stat Cache Stats:
+// CHECK: lookups of absolute paths, {{[1-9][0-9]*}} answered from the cache, 0 stale.
+
+// Adding a file to a directory invalidates its entries.
+// RUN: echo 'int stat_cache_decl;' > %t/a/stat-cache-header.h
+// RUN: %clang_cc1 -fsyntax-only -I %t/a -I %t/b -I %t/c \
+// RUN:   -stat-cache %t/stat.cache -print-stats %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=STALE
+// STALE: *** Persistent Stat Cache Stats:
+// STALE: answered from the cache, {{[1-9][0-9]*}} stale.
+
+// A missing cache file is not an error.
+// RUN: %clang_cc1 -fsyntax-only -I %t/c -stat-cache %t/missing.cache %s
+
+#include "stat-cache-header.h"
+int use = stat_cache_decl;
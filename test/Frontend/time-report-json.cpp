@@ -0,0 +1,34 @@
+// RUN: rm -f %t.json
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -o /dev/null \
+// RUN:   -ftime-report=json=%t.json %s
+// RUN: FileCheck %s < %t.json
+
+// CHECK: "file": "{{.*}}time-report-json.cpp",
+// CHECK: "total": { "wall": {{[0-9.]+}}, "user": {{[0-9.]+}}, "system": {{[0-9.]+}} },
+// CHECK: "phases": {
+// CHECK: "frontend": { "wall": {{[0-9.]+}}, "user": {{[0-9.]+}}, "system": {{[0-9.]+}}, "count": 1 },
+// CHECK: "preprocess": {{.*}} "count": {{[1-9][0-9]*}} },
+// CHECK: "parse": {{.*}} "count": 1 },
+// CHECK: "template-instantiation": {{.*}} "count": 2 },
+// CHECK: "module-loading": {{.*}} "count": 0 },
+// CHECK: "ir-generation": {{.*}} "count": {{[1-9][0-9]*}} },
+// CHECK: "llvm-passes": {{.*}} "count": 1 }
+// CHECK: "counters": {
+// CHECK: "tokens": {{[1-9][0-9]*}},
+// CHECK: "directives": {{[1-9][0-9]*}},
+// CHECK: "decls": {{[1-9][0-9]*}},
+// CHECK: "source-bytes-read": {{[1-9][0-9]*}}
+
+// RUN: not %clang_cc1 -fsyntax-only -ftime-report=text %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=INVALID
+// INVALID: invalid value 'text' in '-ftime-report=text'
+
+#define TIME_REPORT_JSON 1
+#if TIME_REPORT_JSON
+template <typename T> struct Box {
+  T Value;
+  T get() const { return Value; }
+};
+
+int use(Box<int> B) { return B.get(); }
+#endif
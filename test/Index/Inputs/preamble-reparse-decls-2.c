@@ -0,0 +1,7 @@
+int first(int x) { return x + 1; }
+
+struct S { int a; };
+
+int second(struct S s) { return first(s.a); }
+
+int third(void) { return second((struct S){ 2 }); }
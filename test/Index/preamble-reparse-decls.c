@@ -0,0 +1,26 @@
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_REUSE_UNCHANGED_DECLS=1 CINDEXTEST_REMAP_AFTER_TRIAL=1 LIBCLANG_TIMING=1 \
+// RUN:   c-index-test -test-load-source-reparse 3 local \
+// RUN:   "-remap-file=%S/Inputs/preamble-reparse-decls-1.c,%S/Inputs/preamble-reparse-decls-2.c" \
+// RUN:   %S/Inputs/preamble-reparse-decls-1.c 2>&1 | FileCheck %s
+
+// The main file has no preprocessor directives, so a preamble is only
+// precompiled when the unchanged declarations are reused.
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_REMAP_AFTER_TRIAL=1 LIBCLANG_TIMING=1 \
+// RUN:   c-index-test -test-load-source-reparse 3 local \
+// RUN:   "-remap-file=%S/Inputs/preamble-reparse-decls-1.c,%S/Inputs/preamble-reparse-decls-2.c" \
+// RUN:   %S/Inputs/preamble-reparse-decls-1.c 2>&1 | FileCheck %s -check-prefix=CHECK-FULL
+// CHECK-FULL-NOT: Precompiling preamble
+// CHECK-FULL: Reparsing {{.*}}preamble-reparse-decls-1.c
+// CHECK-FULL-NOT: Precompiling preamble
+
+// The declarations before the edit in third() are loaded from the preamble,
+// and are still reported at their locations in the main file.
+// CHECK-NOT: error:
+// CHECK: Precompiling preamble
+// CHECK: Reparsing {{.*}}preamble-reparse-decls-1.c
+// CHECK: preamble-reparse-decls-1.c:1:5: FunctionDecl=first:1:5 (Definition) Extent=[1:1 - 1:35]
+// CHECK: preamble-reparse-decls-1.c:3:8: StructDecl=S:3:8 (Definition) Extent=[3:1 - 3:20]
+// CHECK: preamble-reparse-decls-1.c:5:5: FunctionDecl=second:5:5 (Definition) Extent=[5:1 - 5:46]
+// CHECK: preamble-reparse-decls-1.c:5:33: CallExpr=first:1:5
+// CHECK: preamble-reparse-decls-1.c:7:5: FunctionDecl=third:7:5 (Definition)
+// CHECK: preamble-reparse-decls-1.c:7:26: CallExpr=second:5:5
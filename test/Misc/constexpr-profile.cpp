@@ -0,0 +1,26 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -fconstexpr-profile %s 2>&1 \
+// RUN:   | FileCheck %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -fconstexpr-profile \
+// RUN:   -fno-constexpr-call-cache %s 2>&1 | FileCheck %s -check-prefix=NO-CACHE
+// RUN: %clang -### -std=c++11 -fsyntax-only -fconstexpr-profile %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=DRIVER
+
+// CHECK: *** Constexpr Evaluation Profile:
+// CHECK-NEXT: {{[1-9][0-9]*}} steps in 2 functions.
+// CHECK-NEXT: Steps Calls Reused Function
+// CHECK-NEXT: {{[1-9][0-9]* +[1-9][0-9]* +[1-9][0-9]*}} ns::fib
+// CHECK-NEXT: {{[1-9][0-9]* +[1-9][0-9]* +[0-9]+}} square
+
+// NO-CACHE: *** Constexpr Evaluation Profile:
+// NO-CACHE: {{[1-9][0-9]* +[1-9][0-9]* +0}} ns::fib
+
+// DRIVER: "-fconstexpr-profile"
+
+namespace ns {
+constexpr int fib(int N) { return N < 2 ? N : fib(N - 1) + fib(N - 2); }
+}
+constexpr int square(int N) { return N * N; }
+
+static_assert(ns::fib(10) == 55, "");
+static_assert(square(3) == 9, "");
+static_assert(square(4) == 16, "");
@@ -0,0 +1,25 @@
+// RUN: rm -rf %t
+// Create the global module index with Module.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs -DFIRST %s -Rmodule-build 2>&1 | FileCheck %s -check-prefix=FIRST
+// RUN: ls %t|grep modules.idx
+// FIRST: updated the global module index: 1 module file read, 0 reused
+// Building DependsOnModule updates the index. Only the new module file is
+// read; the entries of Module are reused.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -Rmodule-build 2>&1 | FileCheck %s -check-prefix=UPDATE
+// UPDATE: updated the global module index: 1 module file read, 1 reused
+// The updated index knows about both modules.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -print-stats 2>&1 | FileCheck %s
+
+// expected-no-diagnostics
+#ifdef FIRST
+@import Module;
+#else
+@import DependsOnModule;
+@import Module;
+
+// CHECK: *** Global Module Index Statistics:
+
+int *get_sub() {
+  return Module_Sub;
+}
+#endif
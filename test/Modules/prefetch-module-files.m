@@ -0,0 +1,26 @@
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t \
+// RUN:   -I %S/Inputs -fsyntax-only %s -verify
+
+// Loading diamond_bottom reads diamond_left and diamond_right ahead of time.
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t \
+// RUN:   -I %S/Inputs -fsyntax-only -fmodules-prefetch-threads=4 %s -verify \
+// RUN:   -print-stats 2>&1 | FileCheck %s
+// CHECK: *** AST File Statistics:
+// CHECK-NEXT: {{[1-9][0-9]*}} bytes of module files read ahead of time
+
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t \
+// RUN:   -I %S/Inputs -fsyntax-only -fmodules-prefetch-threads=4 %s -verify \
+// RUN:   -ftime-report 2>&1 | FileCheck %s -check-prefix=TIMER
+// TIMER: Prefetching module files
+
+// expected-no-diagnostics
+
+@import diamond_bottom;
+
+void test_diamond(int i, float f, double d, char c) {
+  top(&i);
+  left(&f);
+  right(&d);
+  bottom(&c);
+}
@@ -0,0 +1,59 @@
+// REQUIRES: shell
+
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: echo '#ifndef GUARDED_H' > %t/guarded.h
+// RUN: echo '#define GUARDED_H' >> %t/guarded.h
+// RUN: echo 'int guarded_decl;' >> %t/guarded.h
+// RUN: echo '#endif' >> %t/guarded.h
+// RUN: echo '#pragma once' > %t/once.h
+// RUN: echo 'int once_decl;' >> %t/once.h
+// RUN: touch -m -a -t 201101010000 %t/guarded.h %t/once.h
+
+// The first compilation enters the headers and records their guards.
+// RUN: %clang_cc1 -E -I %t -include-guard-database %t/guards.db \
+// RUN:   -record-include-guard-database %s | FileCheck %s -check-prefix=RECORD
+// RUN: ls %t/guards.db
+// RECORD: guarded.h" 1
+// RECORD: int guarded_decl;
+// RECORD: once.h" 1
+// RECORD: int once_decl;
+
+// A later compilation that defines the guard macro doesn't enter the header.
+// RUN: %clang_cc1 -E -I %t -include-guard-database %t/guards.db -DSKIP %s \
+// RUN:   | FileCheck %s -check-prefix=SKIP
+// SKIP-NOT: guarded.h" 1
+// SKIP: once.h" 1
+// SKIP: int once_decl;
+// RUN: %clang_cc1 -fsyntax-only -I %t -include-guard-database %t/guards.db \
+// RUN:   -DSKIP -print-stats %s 2>&1 | FileCheck %s -check-prefix=STATS
+// STATS: 1 of them using the include guard database.
+// STATS: *** Include Guard Database Stats:
+// STATS: 2 lookups, 1 answered from the database, 0 stale.
+
+// Headers skipped through the database are still dependencies.
+// RUN: %clang -c -MD -MF %t/skip.d -o %t/skip.o -I %t -DSKIP \
+// RUN:   -Xclang -include-guard-database -Xclang %t/guards.db %s
+// RUN: FileCheck %s -check-prefix=DEPS < %t/skip.d
+// DEPS: skip.o:
+// DEPS: include-guard-database.c
+// DEPS: guarded.h
+// DEPS: once.h
+
+// Changing the header invalidates its entry.
+// RUN: echo '#define GUARDED_H' > %t/guarded.h
+// RUN: echo 'int changed_decl;' >> %t/guarded.h
+// RUN: touch -m -a -t 201101010000 %t/guarded.h
+// RUN: %clang_cc1 -E -I %t -include-guard-database %t/guards.db -DSKIP %s \
+// RUN:   | FileCheck %s -check-prefix=CHANGED
+// CHANGED: guarded.h" 1
+// CHANGED: int changed_decl;
+
+// A missing database is not an error.
+// RUN: %clang_cc1 -fsyntax-only -I %t -include-guard-database %t/missing.db %s
+
+#ifdef SKIP
+#define GUARDED_H
+#endif
+#include "guarded.h"
+#include "once.h"
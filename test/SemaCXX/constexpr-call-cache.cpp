@@ -0,0 +1,70 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -fcxx-exceptions -fconstexpr-steps=150 -fconstexpr-depth=4 -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -fcxx-exceptions -fconstexpr-steps=150 -fconstexpr-depth=4 -verify %s -fno-constexpr-call-cache
+// RUN: not %clang_cc1 -std=c++11 -fsyntax-only -fcxx-exceptions -fconstexpr-steps=150 -fconstexpr-depth=4 %s -print-stats 2>&1 | FileCheck %s
+
+// CHECK: *** AST Context Stats:
+// CHECK: {{[1-9][0-9]*}} constexpr call results memoized, {{[1-9][0-9]*}} reused, {{[0-9]+}} evaluated.
+
+// A reused call is charged the steps its evaluation took, so the step limit
+// is reached at the same point with and without the cache.
+constexpr int sumTo(int N) {
+  int S = 0;
+  for (int I = 0; I != N; ++I)
+    S += I; // expected-note {{constexpr evaluation hit maximum step limit; possible infinite loop?}}
+  return S;
+}
+static_assert(sumTo(100) == 4950, "");
+constexpr int sumTwice() {
+  return sumTo(100) + sumTo(100); // expected-note {{in call to 'sumTo(100)'}}
+}
+static_assert(sumTwice() == 9900, ""); // expected-error {{not an integral constant expression}} expected-note {{in call to 'sumTwice()'}}
+
+// Likewise for the call depth it took.
+constexpr int down(int N) {
+  return N ? down(N - 1) : 0; // expected-note {{constexpr evaluation exceeded maximum depth of 4 calls}} expected-note {{in call to 'down(1)'}}
+}
+static_assert(down(2) == 0, "");
+constexpr int middle() {
+  return down(2); // expected-note {{in call to 'down(2)'}}
+}
+constexpr int outer() {
+  return middle(); // expected-note {{in call to 'middle()'}}
+}
+static_assert(outer() == 0, ""); // expected-error {{not an integral constant expression}} expected-note {{in call to 'outer()'}}
+
+// Failed calls are not memoized, so they are diagnosed every time.
+constexpr int positive(int N) {
+  return N > 0 ? N : throw 0; // expected-note 2{{subexpression not valid}}
+}
+static_assert(positive(1) == 1, "");
+static_assert(positive(-1) == -1, ""); // expected-error {{not an integral constant expression}} expected-note {{in call to 'positive(-1)'}}
+static_assert(positive(-1) == -1, ""); // expected-error {{not an integral constant expression}} expected-note {{in call to 'positive(-1)'}}
+static_assert(positive(1) == 1, "");
+
+// Arguments are compared by value, including aggregates.
+struct Pair { int First, Second; };
+constexpr int sum(Pair P) { return P.First + P.Second; }
+static_assert(sum(Pair{1, 2}) == 3, "");
+static_assert(sum(Pair{2, 1}) == 3, "");
+static_assert(sum(Pair{2, 2}) == 4, "");
+static_assert(sum(Pair{1, 2}) == 3, "");
+
+constexpr double half(double D) { return D / 2; }
+static_assert(half(1.0) == 0.5, "");
+static_assert(half(-1.0) == -0.5, "");
+static_assert(half(1.0) == 0.5, "");
+
+// Calls taking pointers depend on the object pointed to, and are evaluated
+// every time.
+constexpr int deref(const int *P) { return *P; }
+constexpr int One = 1, Two = 2;
+static_assert(deref(&One) == 1, "");
+static_assert(deref(&Two) == 2, "");
+
+// Member functions depend on the object they are called on.
+struct Box {
+  int Value;
+  constexpr int get() const { return Value; }
+};
+static_assert(Box{1}.get() == 1, "");
+static_assert(Box{2}.get() == 2, "");
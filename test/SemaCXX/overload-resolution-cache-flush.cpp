@@ -0,0 +1,22 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only %s -print-stats 2>&1 | FileCheck %s
+// expected-no-diagnostics
+
+// Instantiating a class template does not empty the overload resolution
+// cache; defining a class does.
+// CHECK: 3 overloaded operators resolved from the cache, 2 resolved, 1 cache flushes.
+
+struct V {};
+int operator+(V, V);
+template <typename T> struct Box { T Value; };
+
+V v;
+int a = v + v;
+Box<int> b1;
+int b = v + v;
+Box<char> b2;
+int c = v + v;
+
+struct W {};
+int d = v + v;
+int e = v + v;
@@ -0,0 +1,85 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s -fno-overload-resolution-cache
+// RUN: not %clang_cc1 -std=c++11 -fsyntax-only %s -print-stats 2>&1 | FileCheck %s
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} overloaded operators resolved from the cache, {{[1-9][0-9]*}} resolved, {{[0-9]+}} cache flushes.
+
+template <typename T, typename U> struct same { static const bool value = false; };
+template <typename T> struct same<T, T> { static const bool value = true; };
+
+// Repeated uses of the same operator reuse the result.
+namespace repeated {
+  struct A {};
+  template <typename T> int operator+(T, A);
+  long operator+(A, int);
+
+  A a;
+  static_assert(same<decltype(a + a), int>::value, "");
+  static_assert(same<decltype(a + a), int>::value, "");
+  static_assert(same<decltype(a + 1), long>::value, "");
+  static_assert(same<decltype(a + 1), long>::value, "");
+}
+
+// A better operator declared later is found by later uses.
+namespace redeclared {
+  struct A {};
+  template <typename T> int operator*(T, A);
+
+  A a;
+  static_assert(same<decltype(a * a), int>::value, "");
+
+  long operator*(A, A);
+  static_assert(same<decltype(a * a), long>::value, "");
+}
+
+// Substituting into a template can find functions by argument-dependent
+// lookup that are not candidates themselves.
+namespace adl_sfinae {
+  namespace N { struct A {}; }
+  struct Any { Any(N::A); };
+  template <typename T> auto operator/(T t, N::A) -> decltype(f(t), 0);
+  long operator/(Any, N::A);
+
+  N::A a;
+  static_assert(same<decltype(a / a), long>::value, "");
+
+  namespace N { void f(A); }
+  static_assert(same<decltype(a / a), int>::value, "");
+}
+
+// enable_if conditions depend on the values of the operands.
+namespace value_dependent {
+  struct Q {};
+  int operator-(Q, int X) __attribute__((enable_if(X > 0, "positive")));
+  long operator-(Q, long);
+
+  Q q;
+  static_assert(same<decltype(q - 1), int>::value, "");
+  static_assert(same<decltype(q - 0), long>::value, "");
+  static_assert(same<decltype(q - 1), int>::value, "");
+}
+
+// Access is checked on every use.
+namespace access {
+  class Priv {
+    int operator%(int) const; // expected-note {{declared private here}}
+    friend int inside();
+  };
+
+  Priv p;
+  int inside() { return p % 1; }
+  int outside() { return p % 1; } // expected-error {{'operator%' is a private member of 'access::Priv'}}
+}
+
+// Only a literal zero converts to a pointer.
+namespace null_pointer {
+  struct P {};
+  int operator*(P, void *); // expected-note 2{{candidate function not viable}}
+
+  P p;
+  static_assert(same<decltype(p * 0), int>::value, "");
+  decltype(p * 1) x; // expected-error {{invalid operands to binary expression}}
+  static_assert(same<decltype(p * 0), int>::value, "");
+  decltype(p * 1) y; // expected-error {{invalid operands to binary expression}}
+}
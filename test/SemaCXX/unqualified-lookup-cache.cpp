@@ -0,0 +1,73 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s -fno-unqualified-lookup-cache
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only %s -print-stats 2>&1 | FileCheck %s
+
+// expected-no-diagnostics
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} unqualified lookups answered from the cache, {{[1-9][0-9]*}} performed, {{[1-9][0-9]*}} cache flushes.
+
+// Repeated lookups from the same namespace reuse the result.
+namespace repeated {
+  int value;
+  int sum() { return value + value + value + value; }
+}
+
+// A declaration in an inner namespace hides the one found before.
+namespace outer {
+  char f(long);
+  namespace inner {
+    void a() { static_assert(sizeof(f(0)) == sizeof(char), ""); }
+    short f(int);
+    void b() { static_assert(sizeof(f(0)) == sizeof(short), ""); }
+  }
+}
+
+// A using-directive makes more declarations visible.
+namespace used { short g(int); }
+namespace user {
+  char g(long);
+  void a() { static_assert(sizeof(g(0)) == sizeof(char), ""); }
+  using namespace used;
+  void b() { static_assert(sizeof(g(0)) == sizeof(short), ""); }
+}
+
+// So does a using-directive in block scope, which declares nothing in the
+// namespace.
+namespace block {
+  char h(long);
+  void a() {
+    static_assert(sizeof(h(0)) == sizeof(char), "");
+    using namespace used;
+    static_assert(sizeof(used::g(0)) == sizeof(short), "");
+    static_assert(sizeof(g(0)) == sizeof(short), "");
+  }
+  void b() { static_assert(sizeof(h(0)) == sizeof(char), ""); }
+}
+
+// Local and class scopes are searched before the cached namespace scopes.
+namespace shadowing {
+  char v;
+  struct X {
+    static short v;
+    void f() { static_assert(sizeof(v) == sizeof(short), ""); }
+  };
+  void f() {
+    static_assert(sizeof(v) == sizeof(char), "");
+    short v = 0;
+    static_assert(sizeof(v) == sizeof(short), "");
+  }
+  void g() { static_assert(sizeof(v) == sizeof(char), ""); }
+}
+
+// Operator names are cached like identifiers.
+namespace operators {
+  struct A {};
+  char operator+(A, A);
+  void f(A a) {
+    static_assert(sizeof(a + a) == sizeof(char), "");
+    static_assert(sizeof(a + a) == sizeof(char), "");
+  }
+  short operator+(A, int);
+  void g(A a) { static_assert(sizeof(a + 1) == sizeof(short), ""); }
+}
@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -print-stats %s 2>&1 \
+// RUN:   | FileCheck %s
+// expected-no-diagnostics
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} template pattern expressions reused by instantiation, {{[0-9]+}} transformed.
+
+enum Color { Red = 1, Green = 2, Blue = 4 };
+
+template <typename T> constexpr T scaled(T Value) {
+  return Value * (sizeof(long) + (Red | Blue) * 2.5);
+}
+
+template <typename T> struct Holder {
+  enum { Local = sizeof(T) };
+  static constexpr int mask() { return (Green << 3) + Local; }
+};
+
+static_assert(scaled(2) == (int)(2 * (sizeof(long) + 12.5)), "");
+static_assert(scaled(2.0) == 2.0 * (sizeof(long) + 12.5), "");
+static_assert(Holder<char>::mask() == 17, "");
+static_assert(Holder<int>::mask() == 20, "");
@@ -80,6 +80,16 @@ static unsigned getDefaultParsingOptions() {
   return options;
 }
 
+/** \brief Return the options to use when reparsing \p TU. */
+static unsigned getReparseOptions(CXTranslationUnit TU) {
+  unsigned options = clang_defaultReparseOptions(TU);
+
+  if (getenv("CINDEXTEST_REUSE_UNCHANGED_DECLS"))
+    options |= CXReparse_ReuseUnchangedDecls;
+
+  return options;
+}
+
 /** \brief Returns 0 in case of success, non-zero in case of a failure. */
 static int checkForErrors(CXTranslationUnit TU);
 
@@ -1634,7 +1644,7 @@ int perform_test_reparse_source(int argc, const char **argv, int trials,
         TU,
         trial >= remap_after_trial ? num_unsaved_files : 0,
         trial >= remap_after_trial ? unsaved_files : 0,
-        clang_defaultReparseOptions(TU));
+        getReparseOptions(TU));
     if (Err != CXError_Success) {
       fprintf(stderr, "Unable to reparse translation unit!\n");
       describeLibclangFailure(Err);
@@ -2098,7 +2108,7 @@ int perform_code_completion(int argc, const char **argv, int timing_only) {
   }
 
   Err = clang_reparseTranslationUnit(TU, 0, 0,
-                                     clang_defaultReparseOptions(TU));
+                                     getReparseOptions(TU));
 
   if (Err != CXError_Success) {
     fprintf(stderr, "Unable to reparse translation unit!\n");
@@ -2245,7 +2255,7 @@ static int inspect_cursor_at(int argc, const char **argv) {
   for (I = 0; I != Repeats; ++I) {
     if (Repeats > 1) {
       Err = clang_reparseTranslationUnit(TU, num_unsaved_files, unsaved_files,
-                                         clang_defaultReparseOptions(TU));
+                                         getReparseOptions(TU));
       if (Err != CXError_Success) {
         describeLibclangFailure(Err);
         clang_disposeTranslationUnit(TU);
@@ -2417,7 +2427,7 @@ static int find_file_refs_at(int argc, const char **argv) {
   for (I = 0; I != Repeats; ++I) {
     if (Repeats > 1) {
       Err = clang_reparseTranslationUnit(TU, num_unsaved_files, unsaved_files,
-                                         clang_defaultReparseOptions(TU));
+                                         getReparseOptions(TU));
       if (Err != CXError_Success) {
         describeLibclangFailure(Err);
         clang_disposeTranslationUnit(TU);
@@ -2523,7 +2533,7 @@ static int find_file_includes_in(int argc, const char **argv) {
   for (I = 0; I != Repeats; ++I) {
     if (Repeats > 1) {
       Err = clang_reparseTranslationUnit(TU, num_unsaved_files, unsaved_files,
-                                         clang_defaultReparseOptions(TU));
+                                         getReparseOptions(TU));
       if (Err != CXError_Success) {
         describeLibclangFailure(Err);
         clang_disposeTranslationUnit(TU);
@@ -3413,7 +3423,7 @@ int perform_token_annotation(int argc, const char **argv) {
   if (getenv("CINDEXTEST_EDITING")) {
     for (i = 0; i < 5; ++i) {
       Err = clang_reparseTranslationUnit(TU, num_unsaved_files, unsaved_files,
-                                         clang_defaultReparseOptions(TU));
+                                         getReparseOptions(TU));
       if (Err != CXError_Success) {
         fprintf(stderr, "Unable to reparse translation unit!\n");
         describeLibclangFailure(Err);
@@ -3314,7 +3314,6 @@ static void clang_reparseTranslationUnit_Impl(void *UserData) {
       static_cast<ReparseTranslationUnitInfo *>(UserData);
   CXTranslationUnit TU = RTUI->TU;
   unsigned options = RTUI->options;
-  (void) options;
 
   // Check arguments.
   if (isNotUsableTU(TU)) {
@@ -3348,7 +3347,8 @@ static void clang_reparseTranslationUnit_Impl(void *UserData) {
   }
 
   if (!CXXUnit->Reparse(CXXIdx->getPCHContainerOperations(),
-                        *RemappedFiles.get()))
+                        *RemappedFiles.get(),
+                        options & CXReparse_ReuseUnchangedDecls))
     RTUI->result = CXError_Success;
   else if (isASTReadError(CXXUnit))
     RTUI->result = CXError_ASTReadError;
@@ -4886,7 +4886,9 @@ static SourceRange getRawCursorExtent(CXCursor C) {
       if (!cxcursor::isFirstInDeclGroup(C))
         R.setBegin(VD->getLocation());
     }
-    return R;
+    // Declarations of the main file that were loaded from the precompiled
+    // preamble are reported in the main file.
+    return getCursorASTUnit(C)->mapRangeFromPreamble(R);
   }
   return SourceRange();
 }
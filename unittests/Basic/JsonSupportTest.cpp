@@ -0,0 +1,49 @@
+//===- unittests/Basic/JsonSupportTest.cpp -- JSON string escaping --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/JsonSupport.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+std::string toJSON(StringRef Str) {
+  std::string Result;
+  raw_string_ostream OS(Result);
+  printJSONString(OS, Str);
+  return OS.str();
+}
+
+TEST(JsonSupportTest, PlainText) {
+  EXPECT_EQ("\"\"", toJSON(""));
+  EXPECT_EQ("\"dir/file.cpp\"", toJSON("dir/file.cpp"));
+}
+
+TEST(JsonSupportTest, EscapedCharacters) {
+  EXPECT_EQ("\"a\\\"b\\\\c\"", toJSON("a\"b\\c"));
+  EXPECT_EQ("\"\\b\\f\\n\\r\\t\"", toJSON("\b\f\n\r\t"));
+  EXPECT_EQ("\"\\u0001\\u001f\"", toJSON("\x01\x1f"));
+  EXPECT_EQ("\"\\u0000\"", toJSON(StringRef("\0", 1)));
+  // Unlike YAML, JSON has no escape for DEL or the C1 control characters.
+  EXPECT_EQ("\"\x7f\"", toJSON("\x7f"));
+}
+
+TEST(JsonSupportTest, UTF8) {
+  // Well-formed sequences are copied as they are.
+  EXPECT_EQ("\"caf\xc3\xa9 \xe2\x82\xac\"", toJSON("caf\xc3\xa9 \xe2\x82\xac"));
+  // Anything else is replaced byte by byte.
+  EXPECT_EQ("\"a\\ufffdb\"", toJSON("a\xff" "b"));
+  EXPECT_EQ("\"\\ufffd\\ufffd\"", toJSON("\xc0\x80"));
+  EXPECT_EQ("\"x\\ufffd\\ufffd\"", toJSON("x\xe2\x82"));
+}
+
+} // anonymous namespace
@@ -0,0 +1,201 @@
+//===- unittests/Frontend/SerializedDiagnosticsTest.cpp - .dia tests ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/SerializedDiagnosticPrinter.h"
+#include "clang/Frontend/SerializedDiagnosticReader.h"
+#include "clang/Lex/LexDiagnostic.h"
+#include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+class MessageCollector : public serialized_diags::SerializedDiagnosticReader {
+public:
+  std::vector<std::string> Messages;
+
+protected:
+  std::error_code visitDiagnosticRecord(unsigned Severity,
+                                        const serialized_diags::Location &Loc,
+                                        unsigned Category, unsigned Flag,
+                                        StringRef Message) override {
+    Messages.push_back(Message);
+    return std::error_code();
+  }
+};
+
+class SerializedDiagnosticsTest : public ::testing::Test {
+protected:
+  SerializedDiagnosticsTest()
+      : FileMgr(FileMgrOpts), DiagID(new DiagnosticIDs()),
+        DiagOpts(new DiagnosticOptions()),
+        Diags(DiagID, &*DiagOpts, new IgnoringDiagConsumer()),
+        SourceMgr(Diags, FileMgr) {}
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createTemporaryFile("serialized-diags", "dia",
+                                              DiagFile));
+  }
+
+  void TearDown() override { sys::fs::remove(DiagFile); }
+
+  SourceLocation createFile(StringRef Name) {
+    FileID FID = SourceMgr.createFileID(MemoryBuffer::getMemBuffer("", Name));
+    return SourceMgr.getLocForStartOfFile(FID);
+  }
+
+  /// Writes a lexer warning in a.c, a semantic warning in b.c with a note in
+  /// a.c, and a semantic warning in a.c.
+  void writeDiagnostics(bool Indexed = true) {
+    SourceLocation A = createFile("a.c");
+    SourceLocation B = createFile("b.c");
+
+    DiagOpts->SerializeDiagnosticsIndex = Indexed;
+    std::unique_ptr<DiagnosticConsumer> Writer =
+        serialized_diags::create(DiagFile, &*DiagOpts);
+    DiagnosticsEngine WriterDiags(DiagID, &*DiagOpts, Writer.get(),
+                                  /*ShouldOwnClient=*/false);
+    WriterDiags.setSourceManager(&SourceMgr);
+    Writer->BeginSourceFile(LangOpts, nullptr);
+    WriterDiags.Report(A, diag::ext_pp_extra_tokens_at_eol) << "endif";
+    WriterDiags.Report(B, diag::warn_unused_result);
+    WriterDiags.Report(A, diag::note_previous_definition);
+    WriterDiags.Report(A, diag::warn_unused_result);
+    Writer->EndSourceFile();
+    Writer->finish();
+  }
+
+  static StringRef getCategoryName(unsigned DiagID) {
+    return DiagnosticIDs::getCategoryNameFromID(
+        DiagnosticIDs::getCategoryNumberForDiag(DiagID));
+  }
+
+  FileSystemOptions FileMgrOpts;
+  FileManager FileMgr;
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID;
+  IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts;
+  DiagnosticsEngine Diags;
+  SourceManager SourceMgr;
+  LangOptions LangOpts;
+  SmallString<128> DiagFile;
+};
+
+const char ExtraTokens[] = "extra tokens at end of #endif directive";
+const char UnusedResult[] = "ignoring return value of function declared with "
+                            "warn_unused_result attribute";
+const char PreviousDefinition[] = "previous definition is here";
+
+TEST_F(SerializedDiagnosticsTest, ReadAll) {
+  writeDiagnostics();
+  MessageCollector Reader;
+  ASSERT_FALSE(Reader.readDiagnostics(DiagFile));
+  ASSERT_EQ(4u, Reader.Messages.size());
+  EXPECT_EQ(ExtraTokens, Reader.Messages[0]);
+  EXPECT_EQ(UnusedResult, Reader.Messages[1]);
+  EXPECT_EQ(PreviousDefinition, Reader.Messages[2]);
+  EXPECT_EQ(UnusedResult, Reader.Messages[3]);
+}
+
+TEST_F(SerializedDiagnosticsTest, ReadInFile) {
+  writeDiagnostics();
+
+  MessageCollector InA;
+  ASSERT_FALSE(InA.readDiagnosticsInFile(DiagFile, "a.c"));
+  ASSERT_EQ(2u, InA.Messages.size());
+  EXPECT_EQ(ExtraTokens, InA.Messages[0]);
+  EXPECT_EQ(UnusedResult, InA.Messages[1]);
+
+  // Notes are read with the diagnostic they belong to.
+  MessageCollector InB;
+  ASSERT_FALSE(InB.readDiagnosticsInFile(DiagFile, "b.c"));
+  ASSERT_EQ(2u, InB.Messages.size());
+  EXPECT_EQ(UnusedResult, InB.Messages[0]);
+  EXPECT_EQ(PreviousDefinition, InB.Messages[1]);
+
+  MessageCollector InC;
+  ASSERT_FALSE(InC.readDiagnosticsInFile(DiagFile, "c.c"));
+  EXPECT_TRUE(InC.Messages.empty());
+}
+
+TEST_F(SerializedDiagnosticsTest, ReadInCategory) {
+  writeDiagnostics();
+
+  MessageCollector Lex;
+  ASSERT_FALSE(Lex.readDiagnosticsInCategory(
+      DiagFile, getCategoryName(diag::ext_pp_extra_tokens_at_eol)));
+  ASSERT_EQ(1u, Lex.Messages.size());
+  EXPECT_EQ(ExtraTokens, Lex.Messages[0]);
+
+  MessageCollector Sema;
+  ASSERT_FALSE(Sema.readDiagnosticsInCategory(
+      DiagFile, getCategoryName(diag::warn_unused_result)));
+  ASSERT_EQ(3u, Sema.Messages.size());
+  EXPECT_EQ(UnusedResult, Sema.Messages[0]);
+  EXPECT_EQ(PreviousDefinition, Sema.Messages[1]);
+  EXPECT_EQ(UnusedResult, Sema.Messages[2]);
+}
+
+TEST_F(SerializedDiagnosticsTest, NoIndexByDefault) {
+  writeDiagnostics(/*Indexed=*/false);
+
+  MessageCollector Reader;
+  ASSERT_FALSE(Reader.readDiagnostics(DiagFile));
+  EXPECT_EQ(4u, Reader.Messages.size());
+
+  MessageCollector InA;
+  EXPECT_EQ(serialized_diags::SDError::MissingIndex,
+            InA.readDiagnosticsInFile(DiagFile, "a.c"));
+  EXPECT_TRUE(InA.Messages.empty());
+}
+
+TEST_F(SerializedDiagnosticsTest, ReadInFileAcrossIndexBlocks) {
+  // Enough diagnostics for the index to be written in several blocks.
+  const unsigned NumDiags = 10000;
+  SourceLocation A = createFile("a.c");
+  SourceLocation B = createFile("b.c");
+
+  DiagOpts->SerializeDiagnosticsIndex = true;
+  std::unique_ptr<DiagnosticConsumer> Writer =
+      serialized_diags::create(DiagFile, &*DiagOpts);
+  DiagnosticsEngine WriterDiags(DiagID, &*DiagOpts, Writer.get(),
+                                /*ShouldOwnClient=*/false);
+  WriterDiags.setSourceManager(&SourceMgr);
+  Writer->BeginSourceFile(LangOpts, nullptr);
+  for (unsigned I = 0; I != NumDiags; ++I) {
+    if (I % 2)
+      WriterDiags.Report(B, diag::warn_unused_result);
+    else
+      WriterDiags.Report(A, diag::ext_pp_extra_tokens_at_eol) << "endif";
+  }
+  Writer->EndSourceFile();
+  Writer->finish();
+
+  MessageCollector InA;
+  ASSERT_FALSE(InA.readDiagnosticsInFile(DiagFile, "a.c"));
+  ASSERT_EQ(NumDiags / 2, InA.Messages.size());
+  for (const std::string &Message : InA.Messages)
+    EXPECT_EQ(ExtraTokens, Message);
+
+  MessageCollector InB;
+  ASSERT_FALSE(InB.readDiagnosticsInFile(DiagFile, "b.c"));
+  ASSERT_EQ(NumDiags / 2, InB.Messages.size());
+  for (const std::string &Message : InB.Messages)
+    EXPECT_EQ(UnusedResult, Message);
+}
+
+} // anonymous namespace
@@ -20,6 +20,8 @@
 #include "clang/Lex/ModuleLoader.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -358,4 +360,61 @@ TEST_F(LexerTest, LexAPI) {
   EXPECT_EQ("N", Lexer::getImmediateMacroName(idLoc4, SourceMgr, LangOpts));
 }
 
+TEST_F(LexerTest, LongRunsCrossChunkBoundaries) {
+  // The lexer skips identifiers, whitespace, comments and literals 16 bytes
+  // at a time; make sure runs ending at every offset within a chunk still
+  // produce the right tokens.
+  for (unsigned Len = 1; Len != 40; ++Len) {
+    std::string Id(Len, 'x');
+    std::string Spaces(Len, ' ');
+    std::string Body(Len, 'a');
+    std::string Source = Id + Spaces + "\"" + Body + "?\\\"\" '" + Body +
+                         "' // " + Body + "\\\n" + Body + "\n" + Id + "_1\n";
+
+    std::vector<tok::TokenKind> ExpectedTokens;
+    ExpectedTokens.push_back(tok::identifier);
+    ExpectedTokens.push_back(tok::string_literal);
+    ExpectedTokens.push_back(tok::char_constant);
+    ExpectedTokens.push_back(tok::identifier);
+
+    std::vector<Token> toks = CheckLex(Source, ExpectedTokens);
+    ASSERT_EQ(4U, toks.size());
+    EXPECT_EQ(Len, toks[0].getLength());
+    EXPECT_EQ(Len + 5, toks[1].getLength());
+    EXPECT_EQ(Len + 2, toks[2].getLength());
+    EXPECT_EQ(Len + 2, toks[3].getLength());
+  }
+}
+
+// Measures raw lexing throughput over a large synthetic input. Run it with
+// --gtest_also_run_disabled_tests to check for lexer performance regressions.
+TEST_F(LexerTest, DISABLED_RawLexThroughput) {
+  std::string Source;
+  while (Source.size() < 64 * 1024 * 1024)
+    Source += "static inline unsigned long long some_identifier_name(\n"
+              "    const char *StringArgument, int Value) {\n"
+              "  // A line comment that is long enough to span a few chunks.\n"
+              "  return printf(\"%s: a string literal %d\\n\", "
+              "StringArgument, Value) + 'c';\n"
+              "}\n\n";
+
+  std::unique_ptr<MemoryBuffer> Buf = MemoryBuffer::getMemBuffer(Source);
+  FileID FID = SourceMgr.createFileID(std::move(Buf));
+  LangOpts.CPlusPlus = true;
+
+  llvm::TimeRecord Start = llvm::TimeRecord::getCurrentTime(/*Start=*/true);
+  Lexer RawLex(FID, SourceMgr.getBuffer(FID), SourceMgr, LangOpts);
+  unsigned NumTokens = 0;
+  Token Tok;
+  while (!RawLex.LexFromRawLexer(Tok))
+    ++NumTokens;
+  llvm::TimeRecord Elapsed = llvm::TimeRecord::getCurrentTime(/*Start=*/false);
+  Elapsed -= Start;
+
+  double Seconds = Elapsed.getWallTime();
+  llvm::outs() << "Lexed " << NumTokens << " tokens in " << Seconds << "s ("
+               << Source.size() / (1024 * 1024) / Seconds << " MB/s)\n";
+  EXPECT_GT(NumTokens, 0U);
+}
+
 } // anonymous namespace
@@ -308,6 +308,28 @@ TEST(ClangToolTest, BuildASTs) {
   EXPECT_EQ(2u, ASTs.size());
 }
 
+TEST(ClangToolTest, BuildASTsConcurrently) {
+  FixedCompilationDatabase Compilations("/", std::vector<std::string>());
+
+  std::vector<std::string> Sources;
+  Sources.push_back("/a.cc");
+  Sources.push_back("/b.cc");
+  Sources.push_back("/c.cc");
+  ClangTool Tool(Compilations, Sources);
+  Tool.setNumThreads(2);
+
+  Tool.mapVirtualFile("/a.cc", "void a() {}");
+  Tool.mapVirtualFile("/b.cc", "void b() {}");
+  Tool.mapVirtualFile("/c.cc", "void c() {}");
+
+  std::vector<std::unique_ptr<ASTUnit>> ASTs;
+  EXPECT_EQ(0, Tool.buildASTs(ASTs));
+  ASSERT_EQ(3u, ASTs.size());
+  EXPECT_EQ("/a.cc", ASTs[0]->getMainFileName());
+  EXPECT_EQ("/b.cc", ASTs[1]->getMainFileName());
+  EXPECT_EQ("/c.cc", ASTs[2]->getMainFileName());
+}
+
 struct TestDiagnosticConsumer : public DiagnosticConsumer {
   TestDiagnosticConsumer() : NumDiagnosticsSeen(0) {}
   void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
@@ -329,6 +351,23 @@ TEST(ClangToolTest, InjectDiagnosticConsumer) {
   EXPECT_EQ(1u, Consumer.NumDiagnosticsSeen);
 }
 
+TEST(ClangToolTest, InjectDiagnosticConsumerConcurrently) {
+  FixedCompilationDatabase Compilations("/", std::vector<std::string>());
+  std::vector<std::string> Sources;
+  Sources.push_back("/a.cc");
+  Sources.push_back("/b.cc");
+  ClangTool Tool(Compilations, Sources);
+  Tool.setNumThreads(2);
+  Tool.mapVirtualFile("/a.cc", "int x = undeclared;");
+  Tool.mapVirtualFile("/b.cc", "int y = undeclared;");
+  TestDiagnosticConsumer Consumer;
+  Tool.setDiagnosticConsumer(&Consumer);
+  std::unique_ptr<FrontendActionFactory> Action(
+      newFrontendActionFactory<SyntaxOnlyAction>());
+  EXPECT_EQ(1, Tool.run(Action.get()));
+  EXPECT_EQ(2u, Consumer.NumDiagnosticsSeen);
+}
+
 TEST(ClangToolTest, InjectDiagnosticConsumerInBuildASTs) {
   FixedCompilationDatabase Compilations("/", std::vector<std::string>());
   ClangTool Tool(Compilations, std::vector<std::string>(1, "/a.cc"));
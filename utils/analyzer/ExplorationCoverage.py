@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+
+"""
+Benchmark comparing the basic block coverage of the analyzer exploration
+strategies for a range of node budgets.
+
+Every input file is analyzed with each strategy and each budget (the
+'max-nodes' option). The debug.Stats checker reports the total and the
+unreachable CFG blocks of every top level function; their sum over all the
+inputs gives the percentage of blocks covered.
+
+Usage:
+  ExplorationCoverage.py [options] file...
+
+Extra arguments for the analyzer, such as include paths, can be given with
+--cc1-arg, which may be repeated.
+"""
+
+import optparse
+import re
+import subprocess
+import sys
+
+Strategies = ['dfs', 'bfs', 'bfs_block_dfs_contents', 'unexplored_first']
+
+StatsRE = re.compile(r'Total CFGBlocks: (\d+) \| Unreachable CFGBlocks: (\d+)')
+
+def measureCoverage(Clang, CC1Args, Files, Strategy, MaxNodes):
+    """Returns the total and the visited number of CFG blocks."""
+    Total = 0
+    Unreachable = 0
+    for File in Files:
+        Cmd = [Clang, '-cc1', '-analyze',
+               '-analyzer-checker=core,debug.Stats',
+               '-analyzer-config',
+               'exploration_strategy=%s,max-nodes=%d' % (Strategy, MaxNodes)]
+        Cmd += CC1Args + [File]
+        P = subprocess.Popen(Cmd, stdout=subprocess.PIPE,
+                             stderr=subprocess.PIPE)
+        _, Err = P.communicate()
+        for Match in StatsRE.finditer(Err.decode('utf-8', 'replace')):
+            Total += int(Match.group(1))
+            Unreachable += int(Match.group(2))
+    return Total, Total - Unreachable
+
+def main():
+    Parser = optparse.OptionParser(usage='%prog [options] file...')
+    Parser.add_option('--clang', default='clang',
+                      help='The clang binary to run [default: %default]')
+    Parser.add_option('--budgets', default='1000,5000,20000,150000',
+                      help='Comma separated node budgets [default: %default]')
+    Parser.add_option('--cc1-arg', dest='CC1Args', action='append',
+                      default=[], help='An extra argument for clang -cc1')
+    Opts, Files = Parser.parse_args()
+    if not Files:
+        Parser.error('no input files')
+
+    Budgets = [int(B) for B in Opts.budgets.split(',')]
+
+    sys.stdout.write('%-24s' % 'max-nodes')
+    for MaxNodes in Budgets:
+        sys.stdout.write('%12d' % MaxNodes)
+    sys.stdout.write('\n')
+
+    for Strategy in Strategies:
+        sys.stdout.write('%-24s' % Strategy)
+        for MaxNodes in Budgets:
+            Total, Visited = measureCoverage(Opts.clang, Opts.CC1Args, Files,
+                                             Strategy, MaxNodes)
+            Coverage = 100.0 * Visited / Total if Total else 0.0
+            sys.stdout.write('%11.1f%%' % Coverage)
+            sys.stdout.flush()
+        sys.stdout.write('\n')
+
+if __name__ == '__main__':
+    main()
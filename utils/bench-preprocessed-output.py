@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+
+"""
+Benchmark the throughput of preprocessed output ('clang -E').
+
+  bench-preprocessed-output.py clang <clang> [<clang> ...]
+      Generate a large translation unit and time 'clang -E' on it with each
+      of the given compilers, e.g. one built before and one after a change.
+
+  bench-preprocessed-output.py sink
+      Time only the output layer: write the token stream of a -E run
+      through a user-space buffer and write(), as raw_fd_ostream does, or
+      copy it straight into a memory-mapped output file. The mapped file is
+      given its final size up front, which -E cannot know in practice, so
+      this is the best case for an mmap output mode.
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+SINK_SOURCE = r'''
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Token lengths of typical preprocessed C++, cycled through. Tokens are
+   separated by a single space. */
+static const unsigned TokenLengths[] = {
+  3, 1, 8, 1, 5, 2, 1, 12, 1, 4, 1, 6, 2, 1, 9, 1, 3, 1, 1, 7, 14, 1, 2, 5};
+static const unsigned NumTokenLengths =
+  sizeof(TokenLengths) / sizeof(*TokenLengths);
+
+int main(int argc, char **argv) {
+  const char *Mode = argv[1];
+  size_t Total = strtoull(argv[2], 0, 10);
+  size_t BufferSize = strtoull(argv[3], 0, 10);
+  const char *Path = argv[4];
+  static char Source[4096];
+  for (unsigned I = 0; I != sizeof(Source); ++I)
+    Source[I] = 'a' + I % 26;
+
+  int FD = open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (!strcmp(Mode, "mmap")) {
+    close(FD);
+    FD = open(Path, O_RDWR);
+    if (ftruncate(FD, Total))
+      return 1;
+    char *Out = mmap(0, Total, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+    if (Out == MAP_FAILED)
+      return 1;
+    size_t Pos = 0, Src = 0;
+    for (unsigned T = 0; Pos < Total; ++T) {
+      size_t Len = TokenLengths[T % NumTokenLengths];
+      if (Len > Total - Pos)
+        Len = Total - Pos;
+      memcpy(Out + Pos, Source + Src, Len);
+      Pos += Len;
+      if (Pos < Total)
+        Out[Pos++] = ' ';
+      Src = (Src + Len) % (sizeof(Source) - 16);
+    }
+    munmap(Out, Total);
+  } else {
+    char *Buffer = malloc(BufferSize);
+    size_t Used = 0, Pos = 0, Src = 0;
+    for (unsigned T = 0; Pos < Total; ++T) {
+      size_t Len = TokenLengths[T % NumTokenLengths];
+      if (Len > Total - Pos)
+        Len = Total - Pos;
+      if (Used + Len + 1 > BufferSize) {
+        if (write(FD, Buffer, Used) != (ssize_t)Used)
+          return 1;
+        Used = 0;
+      }
+      memcpy(Buffer + Used, Source + Src, Len);
+      Used += Len;
+      Pos += Len;
+      if (Pos < Total) {
+        Buffer[Used++] = ' ';
+        ++Pos;
+      }
+      Src = (Src + Len) % (sizeof(Source) - 16);
+    }
+    if (Used && write(FD, Buffer, Used) != (ssize_t)Used)
+      return 1;
+  }
+  return close(FD) != 0;
+}
+'''
+
+def best_of(runs, command):
+    times = []
+    for _ in range(runs):
+        start = time.time()
+        subprocess.check_call(command)
+        times.append(time.time() - start)
+    return min(times)
+
+def generate_tu(path, functions):
+    with open(path, 'w') as f:
+        f.write('#define ADD(a, b) ((a) + (b))\n')
+        f.write('#define STR(x) #x\n')
+        for i in range(functions):
+            f.write('/* function %d */\n' % i)
+            f.write('static int function_%d(int first_argument, int second) {\n'
+                    % i)
+            f.write('  const char *name = STR(function_%d);\n' % i)
+            f.write('  return ADD(first_argument, second) * %d + name[0];\n'
+                    % i)
+            f.write('}\n')
+
+def bench_clang(args, workdir):
+    source = os.path.join(workdir, 'large.c')
+    output = os.path.join(workdir, 'large.i')
+    generate_tu(source, args.functions)
+    print('input: %.1f MB' % (os.path.getsize(source) / 1e6))
+    for clang in args.clang:
+        t = best_of(args.runs, [clang, '-E', source, '-o', output])
+        size = os.path.getsize(output) / 1e6
+        print('%s: %.3f s, %.1f MB/s of output' % (clang, t, size / t))
+
+def bench_sink(args, workdir):
+    cc = os.environ.get('CC', 'cc')
+    source = os.path.join(workdir, 'sink.c')
+    binary = os.path.join(workdir, 'sink')
+    output = os.path.join(workdir, 'sink.out')
+    with open(source, 'w') as f:
+        f.write(SINK_SOURCE)
+    subprocess.check_call([cc, '-O2', source, '-o', binary])
+    total = args.megabytes << 20
+    configs = [('write', 4 << 10), ('write', 64 << 10), ('write', 1 << 20),
+               ('mmap', 0)]
+    for mode, buffer_size in configs:
+        t = best_of(args.runs, [binary, mode, str(total), str(buffer_size),
+                                output])
+        label = mode if mode == 'mmap' else '%s, %d KB buffer' % (
+            mode, buffer_size >> 10)
+        print('%-24s %.3f s, %.0f MB/s' % (label + ':', t,
+                                          args.megabytes / t))
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--runs', type=int, default=5,
+                        help='report the best of this many runs')
+    subparsers = parser.add_subparsers(dest='command')
+    clang = subparsers.add_parser('clang')
+    clang.add_argument('clang', nargs='+')
+    clang.add_argument('--functions', type=int, default=200000,
+                       help='size of the generated translation unit')
+    sink = subparsers.add_parser('sink')
+    sink.add_argument('--megabytes', type=int, default=256,
+                      help='amount of output to write')
+    args = parser.parse_args()
+
+    workdir = tempfile.mkdtemp()
+    try:
+        if args.command == 'clang':
+            bench_clang(args, workdir)
+        else:
+            bench_sink(args, workdir)
+    finally:
+        shutil.rmtree(workdir)
+
+if __name__ == '__main__':
+    sys.exit(main())
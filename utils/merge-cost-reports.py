@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+
+"""
+Merge the cost reports written by 'clang -fcost-report=<file>' for the
+translation units of a build, and print the costliest headers, template
+instantiations and constexpr functions of the whole build.
+
+Entries of the same name are added up: their self and total times, their
+counts, and the number of translation units they appear in.
+"""
+
+import argparse
+import json
+import sys
+
+KINDS = ['headers', 'templates', 'constexpr']
+
+def merge(paths):
+    merged = dict((kind, {}) for kind in KINDS)
+    for path in paths:
+        with open(path) as f:
+            report = json.load(f)
+        if report.get('truncated'):
+            sys.stderr.write('warning: %s was written with -cost-report-limit; '
+                             'the merged times are incomplete\n' % path)
+        for kind in KINDS:
+            for entry in report.get(kind, []):
+                total = merged[kind].setdefault(entry['name'], {
+                    'name': entry['name'], 'self': 0.0, 'total': 0.0,
+                    'count': 0, 'units': 0})
+                total['self'] += entry['self']
+                total['total'] += entry['total']
+                total['count'] += entry['count']
+                total['units'] += entry.get('units', 1)
+    return merged
+
+def rank(merged, limit):
+    ranked = {}
+    for kind in KINDS:
+        entries = sorted(merged[kind].values(),
+                         key=lambda e: (-e['total'], e['name']))
+        ranked[kind] = entries[:limit] if limit else entries
+    return ranked
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('reports', nargs='+', metavar='report',
+                        help='cost report written by -fcost-report')
+    parser.add_argument('--limit', type=int, default=50,
+                        help='number of entries of each kind to print '
+                             '(0 = all, default 50)')
+    parser.add_argument('--json', action='store_true',
+                        help='print the merged report as JSON, in the '
+                             'format written by -fcost-report')
+    args = parser.parse_args()
+
+    ranked = rank(merge(args.reports), args.limit)
+    if args.json:
+        json.dump(ranked, sys.stdout, indent=2, sort_keys=True)
+        sys.stdout.write('\n')
+        return
+
+    for kind in KINDS:
+        print('*** %s' % kind)
+        print('%12s %12s %10s %6s  %s' %
+              ('total (s)', 'self (s)', 'count', 'TUs', 'name'))
+        for e in ranked[kind]:
+            print('%12.6f %12.6f %10d %6d  %s' %
+                  (e['total'], e['self'], e['count'], e['units'], e['name']))
+        print('')
+
+if __name__ == '__main__':
+    main()